@@ -0,0 +1,107 @@
+/**
+ * command_parser.cpp
+ *
+ * Host microbenchmark of the serial command parser.
+ * Feeds a stream of key=value commands byte by byte into CommandParser and
+ * compares it with the previous String-based parsing (line split, trim,
+ * substrings and a chain of key comparisons), emulated with std::string.
+ * Build and run with command_parser.sh.
+ */
+
+#include "Interface/CommandParser.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+// Commands as sent by the GUI
+static const char *commands[] = {
+    "basket.door.state=OPEN\r\n",
+    "basket.sorting.state=SMALL\r\n",
+    "gripper.gripper_state=CLOSED_LARGE\r\n",
+    "controller.program=PROGRAM_1\r\n",
+    "controller.state=MANUAL\r\n",
+    "interface.protocol=BINARY\r\n",
+    "gripper.plate_distance=12\r\n",
+};
+static const int command_count = sizeof(commands) / sizeof(commands[0]);
+static const long repetitions = 200000;
+
+/**
+ * Previous parsing: split the line, trim it and compare the key against every command.
+ * @return Index of the command, or -1 if unknown
+ */
+static int parse_with_strings(const std::string &received)
+{
+    std::string line = received.substr(0, received.find('\n'));
+    size_t first = line.find_first_not_of(" \t\r");
+    size_t last = line.find_last_not_of(" \t\r");
+    line = first == std::string::npos ? std::string() : line.substr(first, last - first + 1);
+    size_t delimiter = line.find('=');
+    if (delimiter == std::string::npos || delimiter == 0)
+    {
+        return -1;
+    }
+    std::string key = line.substr(0, delimiter);
+    std::string value = line.substr(delimiter + 1);
+    if (key == "basket.door.state") return 0;
+    else if (key == "basket.sorting.state") return 1;
+    else if (key == "gripper.gripper_state") return 2;
+    else if (key == "controller.program") return 3;
+    else if (key == "controller.state") return 4;
+    else if (key == "interface.protocol") return 5;
+    return value.empty() ? -2 : -1;
+}
+
+/**
+ * Runs a benchmark and prints the command rate.
+ * @param name Name of the benchmark
+ * @param run Function parsing all commands once, returns a checksum
+ */
+template <typename F>
+static void benchmark(const char *name, F run)
+{
+    long checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < repetitions; i++)
+    {
+        checksum += run();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double rate = repetitions * command_count / seconds;
+    printf("%-24s %12.0f commands/s  %8.1f ns/command  (checksum %ld)\n", name, rate, 1e9 / rate, checksum);
+}
+
+int main()
+{
+    CommandParser parser;
+    benchmark("CommandParser", [&parser]() {
+        long checksum = 0;
+        for (int c = 0; c < command_count; c++)
+        {
+            for (const char *byte = commands[c]; *byte != '\0'; byte++)
+            {
+                if (parser.feed(*byte))
+                {
+                    checksum += static_cast<int>(parser.get_command());
+                }
+            }
+        }
+        return checksum;
+    });
+
+    std::string received[command_count];
+    for (int c = 0; c < command_count; c++)
+    {
+        received[c] = commands[c];
+    }
+    benchmark("String parsing", [&received]() {
+        long checksum = 0;
+        for (int c = 0; c < command_count; c++)
+        {
+            checksum += parse_with_strings(received[c]) + 1;
+        }
+        return checksum;
+    });
+    return 0;
+}
@@ -0,0 +1,2 @@
+dir=$(dirname "$0")
+g++ -O2 -std=c++11 -I"$dir/../lib/RaspberryPicker/src" "$dir/command_parser.cpp" "$dir/../lib/RaspberryPicker/src/Interface/CommandParser.cpp" -o "$dir/command_parser" && "$dir/command_parser"
@@ -0,0 +1,252 @@
+/**
+ * ripeness.cpp
+ *
+ * Benchmark of the fixed-point ripeness models (RipenessModels.h) against the floating point one.
+ *
+ * On the host (ripeness.sh), runs the self-check vectors generated by export.py,
+ * evaluates the models on every row of a labeled dataset and prints the
+ * logistic regression output `z p` per row, which quantize.py compares bit by bit
+ * with its reference. Accuracy and time per inference of each model go to stderr;
+ * the accuracy is on all rows, export.py prints it on the rows the models were not trained on.
+ *
+ * On the device (pio run -e uno_ripeness -t upload), prints the CPU cycles
+ * per inference of each model on the serial port.
+ */
+
+#include <Arduino.h>
+
+#include "Gripper/ColorSensor.h"
+#include "Gripper/RipenessModels.h"
+#include "Gripper/RipenessModelData.h"
+
+using namespace ripeness_model_data;
+
+#ifdef ARDUINO_ARCH_AVR
+
+static const int repetitions = 250;
+
+volatile float sink_p;      // Keeps the float results from being optimized away
+volatile uint16_t sink_p_q; // Keeps the fixed-point results from being optimized away
+
+/**
+ * Measures the mean CPU cycles of one inference of a fixed-point model over the self-check inputs.
+ * @return Cycles per inference
+ */
+template <class Model>
+static unsigned long measure_cycles()
+{
+    unsigned long start_us = micros();
+    for (int repetition = 0; repetition < repetitions; repetition++)
+    {
+        for (uint8_t i = 0; i < check_count; i++)
+        {
+            sink_p_q = Model::get_p_ripe_q(check_inputs[i], check_inputs[i][4]);
+        }
+    }
+    unsigned long elapsed_us = micros() - start_us;
+    return elapsed_us * (F_CPU / 1000000UL) / ((unsigned long)repetitions * check_count);
+}
+
+/**
+ * Measures the mean CPU cycles of one inference of the float model over the self-check inputs.
+ * Includes converting the sums into averages, as result() does on the device.
+ * @param sensor Color sensor running the float model
+ * @return Cycles per inference
+ */
+static unsigned long measure_float_cycles(ColorSensor *sensor)
+{
+    unsigned long start_us = micros();
+    for (int repetition = 0; repetition < repetitions; repetition++)
+    {
+        for (uint8_t i = 0; i < check_count; i++)
+        {
+            const int16_t *row = check_inputs[i];
+            RAW_RGB rgb{row[0] / 10.0f, row[1] / 10.0f, row[2] / 10.0f, row[3] / 10.0f};
+            sink_p = sensor->get_ripenesses_p(rgb, row[4]);
+        }
+    }
+    unsigned long elapsed_us = micros() - start_us;
+    return elapsed_us * (F_CPU / 1000000UL) / ((unsigned long)repetitions * check_count);
+}
+
+/**
+ * Prints the cycles per inference of a model.
+ * @param name Name of the model, padded
+ * @param cycles Cycles per inference
+ */
+static void print_cycles(const __FlashStringHelper *name, unsigned long cycles)
+{
+    Serial.print(name);
+    Serial.print(cycles);
+    Serial.println(F(" cycles/inference"));
+}
+
+void setup()
+{
+    ColorSensor sensor(ColorSensor::Pinout{7, 6, 5, A5});
+    Serial.begin(115200);
+    while (!Serial)
+    {
+    }
+    print_cycles(F("float logistic regression:       "), measure_float_cycles(&sensor));
+    print_cycles(F("fixed-point logistic regression: "), measure_cycles<RipenessModels::LogisticRegression>());
+    print_cycles(F("principal component:             "), measure_cycles<RipenessModels::PrincipalComponent>());
+    print_cycles(F("decision tree:                   "), measure_cycles<RipenessModels::DecisionTree>());
+    print_cycles(F("random forest:                   "), measure_cycles<RipenessModels::DecisionForest>());
+}
+
+void loop()
+{
+}
+
+#else
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+/**
+ * Row structure - one measurement of the dataset.
+ * sums: Channel sums of 10 samples (r, g, b, ambient)
+ * rgb: Channel averages, the input of the float model
+ * width: Width of the raspberry [mm]
+ * ripe: Label
+ */
+struct Row
+{
+    int16_t sums[4];
+    RAW_RGB rgb;
+    int width;
+    bool ripe;
+};
+
+static const long repetitions = 2000;
+
+/**
+ * Runs the self-check vectors and prints accuracy and time per inference of a fixed-point model.
+ * @param name Name of the model
+ * @param expected Expected probabilities of the self-check inputs
+ * @param rows Dataset
+ * @return Number of self-check vectors that failed
+ */
+template <class Model>
+static int report(const char *name, const uint16_t expected[], const std::vector<Row> &rows)
+{
+    int failures = 0;
+    for (uint8_t i = 0; i < check_count; i++)
+    {
+        uint16_t p_q = Model::get_p_ripe_q(check_inputs[i], check_inputs[i][4]);
+        if (p_q != expected[i])
+        {
+            fprintf(stderr, "%s: self-check %d gives %u, expected %u\n", name, i, (unsigned)p_q, (unsigned)expected[i]);
+            failures++;
+        }
+    }
+
+    int correct = 0;
+    for (const Row &row : rows)
+    {
+        correct += (Model::get_p_ripe_q(row.sums, row.width) > (1U << (p_shift - 1))) == row.ripe;
+    }
+
+    volatile uint16_t sink_p_q = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long repetition = 0; repetition < repetitions; repetition++)
+    {
+        for (const Row &row : rows)
+        {
+            sink_p_q = Model::get_p_ripe_q(row.sums, row.width);
+        }
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    (void)sink_p_q;
+
+    fprintf(stderr, "%-32s self-check %-6s accuracy %6.2f%%, host %5.1f ns/inference\n", name,
+            failures ? "FAILED" : "ok,", 100.0 * correct / rows.size(), ns / (repetitions * rows.size()));
+    return failures;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s dataset.csv\n", argv[0]);
+        return 2;
+    }
+    FILE *file = fopen(argv[1], "r");
+    if (file == NULL)
+    {
+        perror(argv[1]);
+        return 2;
+    }
+
+    // Read the averages and recover the ADC sums of 10 samples
+    std::vector<Row> rows;
+    char line[128];
+    fgets(line, sizeof(line), file); // header
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        float values[4];
+        char label[16];
+        Row row;
+        if (sscanf(line, "%f,%f,%f,%f,%d,%15s", &values[0], &values[1], &values[2], &values[3], &row.width, label) != 6)
+        {
+            continue;
+        }
+        for (int i = 0; i < 4; i++)
+        {
+            row.sums[i] = (int16_t)lroundf(values[i] * sample_count);
+        }
+        row.rgb = RAW_RGB{values[0], values[1], values[2], values[3]};
+        row.ripe = strncmp(label, "ripe", 4) == 0;
+        rows.push_back(row);
+    }
+    fclose(file);
+
+    ColorSensor sensor(ColorSensor::Pinout{7, 6, 5, A5});
+
+    // Logistic regression output for quantize.py, agreement with the float model for the summary
+    int disagreements = 0;
+    int correct = 0;
+    float max_difference = 0;
+    for (const Row &row : rows)
+    {
+        int32_t z_q = RipenessModels::LogisticRegression::get_z_q(row.sums, row.width);
+        uint16_t p_q = RipenessModels::LogisticRegression::get_p_ripe_q(z_q);
+        float p = sensor.get_ripenesses_p(row.rgb, row.width);
+        printf("%ld %u\n", (long)z_q, (unsigned)p_q);
+
+        float difference = fabsf(p_q / (float)(1U << p_shift) - p);
+        max_difference = difference > max_difference ? difference : max_difference;
+        disagreements += (p_q > (1U << (p_shift - 1))) != (p > 0.5f);
+        correct += (p > 0.5f) == row.ripe;
+    }
+    fprintf(stderr, "%zu rows: fixed-point logistic regression classifies %d differently than float, max |p difference| %.5f\n",
+            rows.size(), disagreements, max_difference);
+
+    // Host timing, for the device see pio run -e uno_ripeness
+    volatile float sink_p = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long repetition = 0; repetition < repetitions; repetition++)
+    {
+        for (const Row &row : rows)
+        {
+            sink_p = sensor.get_ripenesses_p(row.rgb, row.width);
+        }
+    }
+    double float_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    (void)sink_p;
+    fprintf(stderr, "%-32s                   accuracy %6.2f%%, host %5.1f ns/inference\n", "float logistic regression",
+            100.0 * correct / rows.size(), float_ns / (repetitions * rows.size()));
+
+    int failures = 0;
+    failures += report<RipenessModels::LogisticRegression>("fixed-point logistic regression", logistic_regression_check_p, rows);
+    failures += report<RipenessModels::PrincipalComponent>("principal component", pca_check_p, rows);
+    failures += report<RipenessModels::DecisionTree>("decision tree", decision_tree_check_p, rows);
+    failures += report<RipenessModels::DecisionForest>("random forest", decision_forest_check_p, rows);
+    return failures ? 1 : 0;
+}
+
+#endif
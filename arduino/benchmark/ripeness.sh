@@ -0,0 +1,5 @@
+dir=$(dirname "$0")
+dataset=${1:-$dir/../../data/classifier/data_labeled_ambient_width.csv}
+g++ -O2 -std=gnu++11 -DARDUINO_NATIVE_NO_MAIN -include Arduino.h -I"$dir/../lib/ArduinoNative/src" -I"$dir/../lib/RaspberryPicker/src" \
+    "$dir/ripeness.cpp" $(find "$dir/../lib/ArduinoNative/src" "$dir/../lib/RaspberryPicker/src" -name '*.cpp') -o "$dir/ripeness" && \
+    "$dir/ripeness" "$dataset" | python3 "$dir/../../data/classifier/logistic_regression/quantize.py" "$dataset" --check -
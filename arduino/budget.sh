@@ -0,0 +1,24 @@
+#!/bin/sh
+# Prints the flash and SRAM used by each module of the firmware, largest first,
+# followed by the totals of the firmware against the limits of the board.
+# flash = .text + .data (initial values), static SRAM = .data + .bss
+# usage: ./budget.sh [uno|leo]
+ENV=${1:-uno}
+AVR_SIZE=${AVR_SIZE:-$HOME/.platformio/packages/toolchain-atmelavr/bin/avr-size}
+BUILD=.pio/build/$ENV
+
+case "$ENV" in
+    uno) MCU=atmega328p ;;
+    leo) MCU=atmega32u4 ;;
+    *) echo "unknown environment $ENV"; exit 1 ;;
+esac
+
+pio run -e "$ENV" >/dev/null || exit 1
+
+printf "%-40s %8s %8s\n" module flash sram
+find "$BUILD/src" "$BUILD"/lib*/RaspberryPicker -name '*.o' | xargs "$AVR_SIZE" \
+    | awk 'NR > 1 { name = $6; sub(".*/", "", name); sub("\\.o$", "", name); print name, $1 + $2, $2 + $3 }' \
+    | sort -k2 -n -r \
+    | awk '{ printf "%-40s %8d %8d\n", $1, $2, $3 }'
+echo
+"$AVR_SIZE" -C --mcu="$MCU" "$BUILD/firmware.elf"
@@ -0,0 +1,242 @@
+/**
+ * AccelStepper.cpp
+ *
+ * Mock of the AccelStepper library for the native build.
+ * Speeds follow v^2 = v0^2 + 2as per step: the motor accelerates until it reaches the
+ * maximum speed or the distance needed to stop, then decelerates onto the target.
+ */
+
+#include "Arduino.h"
+#include "AccelStepper.h"
+#include "NativeHardware.h"
+
+AccelStepper::AccelStepper(uint8_t interface, uint8_t pin1, uint8_t pin2, uint8_t pin3, uint8_t pin4, bool enable)
+    : interface(interface), current_position(0), target_position(0), current_speed(0), max_speed(1),
+      acceleration(1), last_step_us(0), step_count(0), outputs_enabled(enable)
+{
+    uint8_t pins[] = {pin1, pin2, pin3, pin4};
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        NativeHardware::set_pin_mode(pins[i], OUTPUT);
+    }
+    NativeHardware::register_stepper(this);
+}
+
+AccelStepper::~AccelStepper()
+{
+    NativeHardware::unregister_stepper(this);
+}
+
+void AccelStepper::moveTo(long absolute)
+{
+    if (this->target_position != absolute)
+    {
+        this->target_position = absolute;
+        this->compute_new_speed();
+    }
+}
+
+void AccelStepper::move(long relative)
+{
+    this->moveTo(this->current_position + relative);
+}
+
+/**
+ * Steps if due, accelerating towards the target and decelerating to stop on it.
+ * @return true while the motor is still moving towards the target
+ */
+bool AccelStepper::run()
+{
+    if (this->runSpeed())
+    {
+        this->compute_new_speed();
+        if (this->current_speed != 0)
+        {
+            NativeHardware::request_wakeup(NativeHardware::get_time_us() + (uint32_t)(1000000.0f / fabsf(this->current_speed)));
+        }
+    }
+    return this->current_speed != 0 || this->distanceToGo() != 0;
+}
+
+/**
+ * Steps at the constant speed set by setSpeed() if a step is due.
+ * @return true if a step was made
+ */
+bool AccelStepper::runSpeed()
+{
+    if (this->current_speed == 0)
+    {
+        return false;
+    }
+    uint32_t now_us = micros();
+    uint32_t interval_us = 1000000.0f / fabsf(this->current_speed);
+    if (now_us - this->last_step_us < interval_us)
+    {
+        NativeHardware::request_wakeup(NativeHardware::get_time_us() + interval_us - (now_us - this->last_step_us));
+        return false;
+    }
+    this->current_position += this->current_speed > 0 ? 1 : -1;
+    this->last_step_us = now_us;
+    this->step_count++;
+    NativeHardware::mark_activity();
+    return true;
+}
+
+/**
+ * Blocks until the target is reached.
+ */
+void AccelStepper::runToPosition()
+{
+    while (this->run())
+    {
+    }
+}
+
+void AccelStepper::setMaxSpeed(float speed)
+{
+    this->max_speed = fabsf(speed);
+    this->current_speed = constrain(this->current_speed, -this->max_speed, this->max_speed);
+}
+
+float AccelStepper::maxSpeed()
+{
+    return this->max_speed;
+}
+
+void AccelStepper::setAcceleration(float acceleration)
+{
+    if (acceleration != 0)
+    {
+        this->acceleration = fabsf(acceleration);
+    }
+}
+
+void AccelStepper::setSpeed(float speed)
+{
+    this->current_speed = constrain(speed, -this->max_speed, this->max_speed);
+}
+
+float AccelStepper::speed()
+{
+    return this->current_speed;
+}
+
+long AccelStepper::distanceToGo()
+{
+    return this->target_position - this->current_position;
+}
+
+long AccelStepper::targetPosition()
+{
+    return this->target_position;
+}
+
+long AccelStepper::currentPosition()
+{
+    return this->current_position;
+}
+
+void AccelStepper::setCurrentPosition(long position)
+{
+    this->current_position = position;
+    this->target_position = position;
+    this->current_speed = 0;
+}
+
+/**
+ * Sets the target to the closest position at which the motor can stop.
+ */
+void AccelStepper::stop()
+{
+    if (this->current_speed != 0)
+    {
+        long steps = this->current_speed * this->current_speed / (2 * this->acceleration) + 1;
+        this->move(this->current_speed > 0 ? steps : -steps);
+    }
+}
+
+bool AccelStepper::isRunning()
+{
+    return !(this->current_speed == 0 && this->target_position == this->current_position);
+}
+
+void AccelStepper::disableOutputs()
+{
+    this->outputs_enabled = false;
+}
+
+void AccelStepper::enableOutputs()
+{
+    this->outputs_enabled = true;
+}
+
+/**
+ * Gets the wiring passed to the constructor.
+ * @return Motor interface type
+ */
+uint8_t AccelStepper::get_interface()
+{
+    return this->interface;
+}
+
+/**
+ * Gets the number of steps made since creation.
+ * @return Step count
+ */
+unsigned long AccelStepper::get_step_count()
+{
+    return this->step_count;
+}
+
+/**
+ * Checks whether the coils are powered.
+ * @return true after enableOutputs() or creation with enable set
+ */
+bool AccelStepper::get_outputs_enabled()
+{
+    return this->outputs_enabled;
+}
+
+/**
+ * Computes the speed for the next step from the distance to the target.
+ */
+void AccelStepper::compute_new_speed()
+{
+    long distance = this->distanceToGo();
+    float speed_squared = this->current_speed * this->current_speed;
+    float step_squared = 2 * this->acceleration; // Change of v^2 over one step
+    long stopping_distance = speed_squared / step_squared; // Whole steps, as in AccelStepper, so rounding does not leave a creeping speed
+
+    if (distance == 0 && stopping_distance <= 1)
+    {
+        this->current_speed = 0;
+        return;
+    }
+
+    int direction = distance > 0 ? 1 : (distance < 0 ? -1 : 0);
+    bool reversing = direction != 0 && this->current_speed * direction < 0;
+    if (this->current_speed == 0)
+    {
+        // Start from standstill with the speed reached after one step
+        this->current_speed = direction * fminf(sqrtf(step_squared), this->max_speed);
+    }
+    else if (reversing || stopping_distance >= labs(distance))
+    {
+        // Decelerate, then start again towards the target if not on it
+        float sign = this->current_speed > 0 ? 1 : -1;
+        speed_squared -= step_squared;
+        if (speed_squared > 0)
+        {
+            this->current_speed = sign * sqrtf(speed_squared);
+        }
+        else
+        {
+            this->current_speed = direction * fminf(sqrtf(step_squared), this->max_speed);
+        }
+    }
+    else
+    {
+        float speed = sqrtf(speed_squared + step_squared);
+        this->current_speed = direction * fminf(speed, this->max_speed);
+    }
+}
@@ -0,0 +1,115 @@
+/**
+ * AccelStepper.h
+ *
+ * Mock of the AccelStepper library for the native build.
+ * Keeps the API used by the firmware and moves a simulated position with the same
+ * trapezoidal speed profile on the virtual clock, without driving coil pins.
+ * Instances register themselves in NativeHardware, so a simulation can follow them.
+ */
+
+#ifndef ARDUINO_NATIVE_ACCEL_STEPPER_H
+#define ARDUINO_NATIVE_ACCEL_STEPPER_H
+
+#include <stdint.h>
+
+/**
+ * AccelStepper class - stepper motor with acceleration.
+ */
+class AccelStepper
+{
+public:
+    /**
+     * MotorInterfaceType enum - wiring of the driver, only recorded by the mock.
+     * - FUNCTION: user step functions
+     * - DRIVER: step and direction driver
+     * - FULL2WIRE, FULL3WIRE, FULL4WIRE: full steps on 2, 3 or 4 wires
+     * - HALF3WIRE, HALF4WIRE: half steps on 3 or 4 wires
+     */
+    enum MotorInterfaceType
+    {
+        FUNCTION = 0,
+        DRIVER = 1,
+        FULL2WIRE = 2,
+        FULL3WIRE = 3,
+        FULL4WIRE = 4,
+        HALF3WIRE = 6,
+        HALF4WIRE = 8
+    };
+
+    AccelStepper(uint8_t interface = FULL4WIRE, uint8_t pin1 = 2, uint8_t pin2 = 3, uint8_t pin3 = 4,
+                 uint8_t pin4 = 5, bool enable = true);
+    ~AccelStepper();
+
+    void moveTo(long absolute);
+    void move(long relative);
+
+    /**
+     * Steps if due, accelerating towards the target and decelerating to stop on it.
+     * @return true while the motor is still moving towards the target
+     */
+    bool run();
+
+    /**
+     * Steps at the constant speed set by setSpeed() if a step is due.
+     * @return true if a step was made
+     */
+    bool runSpeed();
+
+    /**
+     * Blocks until the target is reached.
+     */
+    void runToPosition();
+
+    void setMaxSpeed(float speed);
+    float maxSpeed();
+    void setAcceleration(float acceleration);
+    void setSpeed(float speed);
+    float speed();
+
+    long distanceToGo();
+    long targetPosition();
+    long currentPosition();
+    void setCurrentPosition(long position);
+
+    /**
+     * Sets the target to the closest position at which the motor can stop.
+     */
+    void stop();
+    bool isRunning();
+
+    void disableOutputs();
+    void enableOutputs();
+
+    /**
+     * Gets the wiring passed to the constructor.
+     * @return Motor interface type
+     */
+    uint8_t get_interface();
+
+    /**
+     * Gets the number of steps made since creation.
+     * @return Step count
+     */
+    unsigned long get_step_count();
+
+    /**
+     * Checks whether the coils are powered.
+     * @return true after enableOutputs() or creation with enable set
+     */
+    bool get_outputs_enabled();
+
+private:
+    void compute_new_speed();
+
+    uint8_t interface;           // Wiring of the driver
+    long current_position;       // Position [steps]
+    long target_position;        // Target of run() [steps]
+    float current_speed;         // Signed speed [steps/s]
+    float max_speed;             // Limit of run() [steps/s]
+    float acceleration;          // Acceleration of run() [steps/s^2]
+    uint32_t last_step_us;       // Time of the last step [us]
+    unsigned long step_count;    // Steps made since creation
+    bool outputs_enabled;        // Whether the coils are powered
+};
+
+#endif
@@ -0,0 +1,140 @@
+/**
+ * Arduino.cpp
+ *
+ * Arduino core functions for the native build, forwarded to NativeHardware.
+ */
+
+#include "Arduino.h"
+#include "NativeHardware.h"
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    NativeHardware::set_pin_mode(pin, mode);
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+    NativeHardware::set_output(pin, value);
+}
+
+int digitalRead(uint8_t pin)
+{
+    return NativeHardware::read_pin(pin);
+}
+
+int analogRead(uint8_t pin)
+{
+    return NativeHardware::read_analog(pin);
+}
+
+void analogWrite(uint8_t pin, int value)
+{
+    NativeHardware::set_pin_mode(pin, OUTPUT);
+    NativeHardware::set_output(pin, value >= 128 ? HIGH : LOW);
+}
+
+unsigned long millis()
+{
+    NativeHardware::charge_call();
+    return (unsigned long)(NativeHardware::get_time_us() / 1000);
+}
+
+unsigned long micros()
+{
+    NativeHardware::charge_call();
+    // Wraps like the 32-bit counter on the microcontroller
+    return (unsigned long)(uint32_t)NativeHardware::get_time_us();
+}
+
+void delay(unsigned long ms)
+{
+    NativeHardware::advance_us((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    NativeHardware::advance_us(us);
+}
+
+void yield()
+{
+}
+
+void attachInterrupt(uint8_t interrupt, void (*handler)(), int mode)
+{
+    NativeHardware::attach_interrupt(interrupt, handler, mode);
+}
+
+void detachInterrupt(uint8_t interrupt)
+{
+    NativeHardware::detach_interrupt(interrupt);
+}
+
+void noInterrupts()
+{
+    NativeHardware::disable_interrupts();
+}
+
+void interrupts()
+{
+    NativeHardware::enable_interrupts();
+}
+
+/**
+ * Converts an unsigned number to text in any base (2-36).
+ * @param value Number to convert
+ * @param buffer Destination, large enough for the digits and terminator
+ * @param radix Base of the number system
+ * @return buffer
+ */
+char *ultoa(unsigned long value, char *buffer, int radix)
+{
+    char digits[sizeof(unsigned long) * 8 + 1];
+    int count = 0;
+    do
+    {
+        int digit = value % radix;
+        digits[count++] = digit < 10 ? '0' + digit : 'a' + digit - 10;
+        value /= radix;
+    } while (value != 0);
+
+    for (int i = 0; i < count; i++)
+    {
+        buffer[i] = digits[count - 1 - i];
+    }
+    buffer[count] = '\0';
+    return buffer;
+}
+
+/**
+ * Converts a signed number to text in any base (2-36).
+ * Like avr-libc, a minus sign is only written in base 10.
+ * @param value Number to convert
+ * @param buffer Destination, large enough for the sign, digits and terminator
+ * @param radix Base of the number system
+ * @return buffer
+ */
+char *ltoa(long value, char *buffer, int radix)
+{
+    if (value < 0 && radix == 10)
+    {
+        buffer[0] = '-';
+        ultoa(0UL - (unsigned long)value, buffer + 1, radix);
+        return buffer;
+    }
+    return ultoa((unsigned long)value, buffer, radix);
+}
+
+/**
+ * Converts a floating point number to fixed-point text, right-aligned in a field.
+ * @param value Number to convert
+ * @param width Minimum field width (negative to left-align)
+ * @param precision Number of decimals
+ * @param buffer Destination
+ * @return buffer
+ */
+char *dtostrf(double value, signed char width, unsigned char precision, char *buffer)
+{
+    sprintf(buffer, "%*.*f", width, precision, value);
+    return buffer;
+}
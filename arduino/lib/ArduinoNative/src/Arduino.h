@@ -0,0 +1,98 @@
+/**
+ * Arduino.h
+ *
+ * Arduino core API for the native (Linux) build.
+ * Pins, the ADC, interrupts and time are simulated by NativeHardware,
+ * so the firmware runs unmodified on a workstation.
+ * The pin numbering follows the Arduino Uno.
+ */
+
+#ifndef ARDUINO_NATIVE_ARDUINO_H
+#define ARDUINO_NATIVE_ARDUINO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+#define PI 3.1415926535897932384626433832795
+#define HALF_PI 1.5707963267948966192313216916398
+#define TWO_PI 6.283185307179586476925286766559
+
+#define LED_BUILTIN 13
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+
+// min() and max() are left to <algorithm>, as macros would break the standard headers
+#define constrain(value, low, high) ((value) < (low) ? (low) : ((value) > (high) ? (high) : (value)))
+
+#define NOT_AN_INTERRUPT -1
+#define digitalPinToInterrupt(p) ((p) == 2 ? 0 : ((p) == 3 ? 1 : NOT_AN_INTERRUPT))
+
+// Flash and RAM share one address space on the workstation
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+#define pgm_read_byte(address) (*(const uint8_t *)(address))
+#define pgm_read_word(address) (*(const uint16_t *)(address))
+#define pgm_read_dword(address) (*(const uint32_t *)(address))
+#define pgm_read_float(address) (*(const float *)(address))
+#define pgm_read_ptr(address) (*(void *const *)(address))
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define strlen_P strlen
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define memcpy_P memcpy
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(PSTR(string_literal)))
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+void attachInterrupt(uint8_t interrupt, void (*handler)(), int mode);
+void detachInterrupt(uint8_t interrupt);
+void noInterrupts();
+void interrupts();
+
+// avr-libc conversions used by the firmware
+char *ltoa(long value, char *buffer, int radix);
+char *ultoa(unsigned long value, char *buffer, int radix);
+char *dtostrf(double value, signed char width, unsigned char precision, char *buffer);
+
+void setup();
+void loop();
+
+#include "WString.h"
+#include "HardwareSerial.h"
+
+#endif
@@ -0,0 +1,52 @@
+/**
+ * EEPROM.cpp
+ *
+ * EEPROM library replacement for the native build.
+ */
+
+#include "EEPROM.h"
+
+static uint8_t cells[EEPROMClass::size];             // Emulated EEPROM contents
+static unsigned long write_counts[EEPROMClass::size]; // Writes per cell since startup
+
+EEPROMClass EEPROM;
+
+/**
+ * Constructor - erases the emulated EEPROM.
+ */
+EEPROMClass::EEPROMClass()
+{
+    memset(cells, 0xFF, sizeof(cells));
+}
+
+uint8_t EEPROMClass::read(int idx)
+{
+    return idx >= 0 && idx < EEPROMClass::size ? cells[idx] : 0xFF;
+}
+
+void EEPROMClass::write(int idx, uint8_t value)
+{
+    if (idx >= 0 && idx < EEPROMClass::size)
+    {
+        cells[idx] = value;
+        write_counts[idx]++;
+    }
+}
+
+void EEPROMClass::update(int idx, uint8_t value)
+{
+    if (this->read(idx) != value)
+    {
+        this->write(idx, value);
+    }
+}
+
+uint16_t EEPROMClass::length()
+{
+    return EEPROMClass::size;
+}
+
+unsigned long EEPROMClass::get_write_count(int idx)
+{
+    return idx >= 0 && idx < EEPROMClass::size ? write_counts[idx] : 0;
+}
@@ -0,0 +1,65 @@
+/**
+ * EEPROM.h
+ *
+ * EEPROM library replacement for the native build.
+ * Emulates the 1 KiB EEPROM of the ATmega328P/32U4 in memory, erased (0xFF) at startup
+ * like a new device, so the firmware boots with its default configuration.
+ */
+
+#ifndef ARDUINO_NATIVE_EEPROM_H
+#define ARDUINO_NATIVE_EEPROM_H
+
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * EEPROMClass class - byte-addressed non-volatile memory.
+ */
+class EEPROMClass
+{
+public:
+    static const int size = 1024; // Size of the emulated EEPROM [bytes]
+
+    EEPROMClass();
+
+    uint8_t read(int idx);
+    void write(int idx, uint8_t value);
+
+    /**
+     * Writes a byte only if it differs from the stored one, as the AVR library does.
+     */
+    void update(int idx, uint8_t value);
+
+    uint16_t length();
+
+    /**
+     * Gets the number of writes to a cell, to check the wear of the firmware's write pattern.
+     * @param idx Address of the cell
+     * @return Number of writes since startup
+     */
+    unsigned long get_write_count(int idx);
+
+    template <typename T>
+    T &get(int idx, T &t)
+    {
+        for (size_t i = 0; i < sizeof(T); i++)
+        {
+            ((uint8_t *)&t)[i] = this->read(idx + i);
+        }
+        return t;
+    }
+
+    template <typename T>
+    const T &put(int idx, const T &t)
+    {
+        for (size_t i = 0; i < sizeof(T); i++)
+        {
+            this->update(idx + i, ((const uint8_t *)&t)[i]);
+        }
+        return t;
+    }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
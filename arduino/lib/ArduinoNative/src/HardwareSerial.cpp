@@ -0,0 +1,224 @@
+/**
+ * HardwareSerial.cpp
+ *
+ * Simulated UART for the native build.
+ */
+
+#include <poll.h>
+#include <unistd.h>
+
+#include "Arduino.h"
+#include "HardwareSerial.h"
+#include "NativeHardware.h"
+
+HardwareSerial Serial;
+
+/**
+ * Writes sent bytes to stdout.
+ */
+static void write_stdout(const uint8_t *buffer, size_t size, void * /*context*/)
+{
+    fwrite(buffer, 1, size, stdout);
+    fflush(stdout);
+}
+
+HardwareSerial::HardwareSerial()
+    : input_fd(-1), tx_handler(write_stdout), tx_context(nullptr), baud(9600), tx_count(0), tx_pending(0),
+      tx_drained_us(0)
+{
+}
+
+void HardwareSerial::begin(unsigned long baud)
+{
+    this->baud = baud;
+    this->tx_pending = 0;
+    this->tx_drained_us = NativeHardware::get_time_us();
+}
+
+void HardwareSerial::end()
+{
+    this->flush();
+}
+
+int HardwareSerial::available()
+{
+    this->poll_input();
+    return this->rx.size();
+}
+
+int HardwareSerial::read()
+{
+    this->poll_input();
+    if (this->rx.empty())
+    {
+        return -1;
+    }
+    uint8_t byte = this->rx.front();
+    this->rx.pop_front();
+    NativeHardware::mark_activity();
+    return byte;
+}
+
+int HardwareSerial::peek()
+{
+    this->poll_input();
+    return this->rx.empty() ? -1 : this->rx.front();
+}
+
+/**
+ * Sends one byte, waiting for space in the transmit buffer.
+ * @param byte Byte to send
+ * @return 1
+ */
+size_t HardwareSerial::write(uint8_t byte)
+{
+    return this->write(&byte, 1);
+}
+
+/**
+ * Sends bytes, waiting for space in the transmit buffer like the interrupt-driven UART.
+ * @param buffer Bytes to send
+ * @param size Number of bytes
+ * @return Number of bytes sent
+ */
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    uint64_t byte_us = 10000000ULL / this->baud; // 8N1: 10 bits per byte
+    for (size_t i = 0; i < size; i++)
+    {
+        this->drain();
+        if (this->tx_pending >= HardwareSerial::tx_buffer_size)
+        {
+            NativeHardware::advance_us(this->tx_drained_us + byte_us - NativeHardware::get_time_us());
+            this->drain();
+        }
+        this->tx_pending++;
+    }
+    if (this->tx_handler != nullptr)
+    {
+        this->tx_handler(buffer, size, this->tx_context);
+    }
+    this->tx_count += size;
+    NativeHardware::mark_activity();
+    return size;
+}
+
+/**
+ * Gets the free space in the transmit buffer.
+ * @return Bytes that can be written without blocking
+ */
+int HardwareSerial::availableForWrite()
+{
+    this->drain();
+    if (this->tx_pending > 0)
+    {
+        // Callers poll for space, so wake them when the next byte has left
+        NativeHardware::request_wakeup(this->tx_drained_us + 10000000ULL / this->baud);
+    }
+    return HardwareSerial::tx_buffer_size - this->tx_pending;
+}
+
+/**
+ * Waits until the transmit buffer is empty.
+ */
+void HardwareSerial::flush()
+{
+    this->drain();
+    if (this->tx_pending > 0)
+    {
+        uint64_t byte_us = 10000000ULL / this->baud;
+        NativeHardware::advance_us(this->tx_drained_us + this->tx_pending * byte_us - NativeHardware::get_time_us());
+        this->drain();
+    }
+}
+
+/**
+ * Queues bytes as if they were received from the host.
+ * @param buffer Bytes to receive
+ * @param size Number of bytes
+ */
+void HardwareSerial::feed(const uint8_t *buffer, size_t size)
+{
+    this->rx.insert(this->rx.end(), buffer, buffer + size);
+}
+
+void HardwareSerial::feed(const char *text)
+{
+    this->feed((const uint8_t *)text, strlen(text));
+}
+
+/**
+ * Sets a file descriptor polled for received bytes.
+ * @param fd File descriptor, or -1 to stop polling
+ */
+void HardwareSerial::set_input_fd(int fd)
+{
+    this->input_fd = fd;
+}
+
+/**
+ * Sets the function receiving sent bytes instead of stdout.
+ * @param handler Function to call, or nullptr to discard the bytes
+ * @param context Pointer passed to the function
+ */
+void HardwareSerial::set_tx_handler(TxHandler handler, void *context)
+{
+    this->tx_handler = handler;
+    this->tx_context = context;
+}
+
+/**
+ * Gets the number of bytes sent since start.
+ * @return Sent bytes
+ */
+unsigned long HardwareSerial::get_tx_count() const
+{
+    return this->tx_count;
+}
+
+/**
+ * Moves bytes waiting on the input file descriptor into the receive queue.
+ * Stops polling at the end of the input.
+ */
+void HardwareSerial::poll_input()
+{
+    if (this->input_fd < 0)
+    {
+        return;
+    }
+    struct pollfd request = {this->input_fd, POLLIN, 0};
+    while (poll(&request, 1, 0) > 0)
+    {
+        uint8_t buffer[64];
+        ssize_t count = ::read(this->input_fd, buffer, sizeof(buffer));
+        if (count <= 0)
+        {
+            this->input_fd = -1;
+            return;
+        }
+        this->feed(buffer, count);
+    }
+}
+
+/**
+ * Removes the bytes sent by the UART since the last call from the transmit buffer.
+ */
+void HardwareSerial::drain()
+{
+    uint64_t now_us = NativeHardware::get_time_us();
+    uint64_t byte_us = 10000000ULL / this->baud;
+    if (this->tx_pending == 0 || now_us < this->tx_drained_us)
+    {
+        this->tx_drained_us = now_us;
+        return;
+    }
+    uint64_t sent = (now_us - this->tx_drained_us) / byte_us;
+    if (sent >= (uint64_t)this->tx_pending)
+    {
+        this->tx_pending = 0;
+        this->tx_drained_us = now_us;
+        return;
+    }
+    this->tx_pending -= sent;
+    this->tx_drained_us += sent * byte_us;
+}
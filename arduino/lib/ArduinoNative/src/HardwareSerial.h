@@ -0,0 +1,98 @@
+/**
+ * HardwareSerial.h
+ *
+ * Simulated UART for the native build.
+ * Received bytes come from a queue filled by the simulation or from a file descriptor
+ * (stdin when run interactively). Sent bytes go to a handler (stdout by default)
+ * and occupy a 64-byte transmit buffer that drains at the configured baud rate on
+ * the virtual clock, so blocking writes and availableForWrite() behave as on the board.
+ */
+
+#ifndef ARDUINO_NATIVE_HARDWARE_SERIAL_H
+#define ARDUINO_NATIVE_HARDWARE_SERIAL_H
+
+#include <deque>
+#include <stdint.h>
+
+#include "Print.h"
+
+/**
+ * HardwareSerial class - serial port with simulated timing.
+ */
+class HardwareSerial : public Stream
+{
+public:
+    typedef void (*TxHandler)(const uint8_t *buffer, size_t size, void *context);
+
+    static const int tx_buffer_size = 64; // Size of the transmit buffer [bytes]
+
+    HardwareSerial();
+
+    void begin(unsigned long baud);
+    void end();
+
+    int available() override;
+    int read() override;
+    int peek() override;
+
+    size_t write(uint8_t byte) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+
+    /**
+     * Gets the free space in the transmit buffer.
+     * @return Bytes that can be written without blocking
+     */
+    int availableForWrite() override;
+
+    /**
+     * Waits until the transmit buffer is empty.
+     */
+    void flush() override;
+
+    operator bool() const { return true; }
+
+    /**
+     * Queues bytes as if they were received from the host.
+     * @param buffer Bytes to receive
+     * @param size Number of bytes
+     */
+    void feed(const uint8_t *buffer, size_t size);
+    void feed(const char *text);
+
+    /**
+     * Sets a file descriptor polled for received bytes.
+     * @param fd File descriptor, or -1 to stop polling
+     */
+    void set_input_fd(int fd);
+
+    /**
+     * Sets the function receiving sent bytes instead of stdout.
+     * @param handler Function to call, or nullptr to discard the bytes
+     * @param context Pointer passed to the function
+     */
+    void set_tx_handler(TxHandler handler, void *context);
+
+    /**
+     * Gets the number of bytes sent since start.
+     * @return Sent bytes
+     */
+    unsigned long get_tx_count() const;
+
+private:
+    void poll_input();
+    void drain();
+
+    std::deque<uint8_t> rx;      // Received bytes not read yet
+    int input_fd;                // Polled for received bytes (-1 if none)
+    TxHandler tx_handler;        // Receives sent bytes
+    void *tx_context;            // Passed to the transmit handler
+    unsigned long baud;          // Baud rate [bit/s]
+    unsigned long tx_count;      // Bytes sent since start
+    int tx_pending;              // Bytes in the transmit buffer
+    uint64_t tx_drained_us;      // Time up to which the buffer was drained [us]
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,464 @@
+/**
+ * NativeHardware.cpp
+ *
+ * Simulated microcontroller behind the native Arduino core.
+ */
+
+#include <time.h>
+
+#include "Arduino.h"
+#include "NativeHardware.h"
+
+const unsigned int NativeHardware::analog_read_us = 112;
+const unsigned int NativeHardware::default_call_cost_us = 4;
+
+uint64_t NativeHardware::now_us = 0;
+uint64_t NativeHardware::real_start_us = 0;
+bool NativeHardware::real_time = false;
+unsigned int NativeHardware::call_cost_us = NativeHardware::default_call_cost_us;
+NativeHardware::TickHandler NativeHardware::tick_handler = nullptr;
+void *NativeHardware::tick_context = nullptr;
+bool NativeHardware::in_tick = false;
+bool NativeHardware::fast_forward = false;
+bool NativeHardware::idle = false;
+uint64_t NativeHardware::wakeup_us = UINT64_MAX;
+
+uint8_t NativeHardware::pin_modes[NativeHardware::pin_count];
+uint8_t NativeHardware::outputs[NativeHardware::pin_count];
+uint8_t NativeHardware::inputs[NativeHardware::pin_count];
+bool NativeHardware::input_set[NativeHardware::pin_count];
+unsigned long NativeHardware::output_changes = 0;
+int NativeHardware::analog_values[NativeHardware::pin_count];
+NativeHardware::AnalogSource NativeHardware::analog_source = nullptr;
+void *NativeHardware::analog_context = nullptr;
+int NativeHardware::servo_angles[NativeHardware::pin_count] = {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                                               -1, -1, -1, -1, -1, -1, -1, -1, -1, -1};
+
+void (*NativeHardware::interrupt_handlers[NativeHardware::interrupt_count])() = {nullptr, nullptr};
+int NativeHardware::interrupt_modes[NativeHardware::interrupt_count];
+bool NativeHardware::interrupt_pending[NativeHardware::interrupt_count];
+bool NativeHardware::interrupts_enabled = true;
+
+AccelStepper *NativeHardware::steppers[NativeHardware::max_steppers];
+uint8_t NativeHardware::stepper_count = 0;
+
+/**
+ * Reads the system clock.
+ * @return Monotonic time [us]
+ */
+static uint64_t system_time_us()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000ULL + now.tv_nsec / 1000;
+}
+
+/**
+ * Resets pins, interrupts, servos and the clock to power-on state.
+ * Registered steppers and handlers are kept.
+ */
+void NativeHardware::reset()
+{
+    NativeHardware::now_us = 0;
+    NativeHardware::idle = false;
+    NativeHardware::wakeup_us = UINT64_MAX;
+    NativeHardware::real_start_us = system_time_us();
+    for (uint8_t pin = 0; pin < NativeHardware::pin_count; pin++)
+    {
+        NativeHardware::pin_modes[pin] = INPUT;
+        NativeHardware::outputs[pin] = LOW;
+        NativeHardware::inputs[pin] = LOW;
+        NativeHardware::input_set[pin] = false;
+        NativeHardware::analog_values[pin] = 0;
+        NativeHardware::servo_angles[pin] = -1;
+    }
+    for (uint8_t i = 0; i < NativeHardware::interrupt_count; i++)
+    {
+        NativeHardware::interrupt_handlers[i] = nullptr;
+        NativeHardware::interrupt_pending[i] = false;
+    }
+    NativeHardware::interrupts_enabled = true;
+}
+
+/**
+ * Selects whether the clock follows the system clock.
+ * @param enabled true to run in real time, false for the virtual clock
+ */
+void NativeHardware::set_real_time(bool enabled)
+{
+    if (enabled && !NativeHardware::real_time)
+    {
+        NativeHardware::real_start_us = system_time_us() - NativeHardware::now_us;
+    }
+    NativeHardware::real_time = enabled;
+}
+
+/**
+ * Gets the current time.
+ * @return Time since start [us]
+ */
+uint64_t NativeHardware::get_time_us()
+{
+    if (NativeHardware::real_time)
+    {
+        NativeHardware::now_us = system_time_us() - NativeHardware::real_start_us;
+    }
+    return NativeHardware::now_us;
+}
+
+/**
+ * Lets time pass, calling the tick handler. Sleeps in real-time mode.
+ * @param duration_us Time to advance [us]
+ */
+void NativeHardware::advance_us(uint64_t duration_us)
+{
+    if (NativeHardware::real_time)
+    {
+        uint64_t end_us = NativeHardware::get_time_us() + duration_us;
+        uint64_t now = NativeHardware::get_time_us();
+        if (end_us > now)
+        {
+            struct timespec wait;
+            wait.tv_sec = (end_us - now) / 1000000ULL;
+            wait.tv_nsec = ((end_us - now) % 1000000ULL) * 1000;
+            nanosleep(&wait, nullptr);
+        }
+        NativeHardware::get_time_us();
+    }
+    else
+    {
+        NativeHardware::now_us += duration_us;
+    }
+    if (NativeHardware::now_us >= NativeHardware::wakeup_us)
+    {
+        NativeHardware::wakeup_us = UINT64_MAX;
+    }
+
+    if (NativeHardware::tick_handler != nullptr && !NativeHardware::in_tick)
+    {
+        NativeHardware::in_tick = true;
+        NativeHardware::tick_handler(NativeHardware::now_us, NativeHardware::tick_context);
+        NativeHardware::in_tick = false;
+    }
+}
+
+/**
+ * Sets the time charged for each call to millis() or micros(),
+ * so polling loops make progress on the virtual clock.
+ * @param cost_us Time per call [us]
+ */
+void NativeHardware::set_call_cost_us(unsigned int cost_us)
+{
+    NativeHardware::call_cost_us = cost_us;
+}
+
+/**
+ * Charges the time of one clock read, skipping idle time in fast-forward mode.
+ */
+void NativeHardware::charge_call()
+{
+    if (NativeHardware::real_time)
+    {
+        return;
+    }
+    bool woken = false;
+    if (NativeHardware::fast_forward && NativeHardware::idle)
+    {
+        // Nothing happened since the last read: jump to the next point something can change
+        uint64_t target_us = (NativeHardware::now_us / 1000 + 1) * 1000;
+        if (NativeHardware::wakeup_us != UINT64_MAX)
+        {
+            target_us = NativeHardware::wakeup_us;
+            woken = true;
+        }
+        NativeHardware::advance_us(target_us - NativeHardware::now_us);
+    }
+    else if (NativeHardware::call_cost_us > 0)
+    {
+        NativeHardware::advance_us(NativeHardware::call_cost_us);
+    }
+    // After a wakeup, the component that requested it may not have read the clock yet
+    NativeHardware::idle = !woken;
+}
+
+/**
+ * Selects whether idle clock reads skip ahead, see NativeHardware.h.
+ * Waits on micros() are only exact if a wakeup was requested for them.
+ * @param enabled true to skip idle time
+ */
+void NativeHardware::set_fast_forward(bool enabled)
+{
+    NativeHardware::fast_forward = enabled;
+    NativeHardware::idle = false;
+}
+
+/**
+ * Notes that the firmware did something observable, so the next clock read is not idle.
+ */
+void NativeHardware::mark_activity()
+{
+    NativeHardware::idle = false;
+}
+
+/**
+ * Requests that fast-forward does not skip past a point in time.
+ * Requests are cleared once the time has been reached.
+ * @param at_us Time at which something is due [us]
+ */
+void NativeHardware::request_wakeup(uint64_t at_us)
+{
+    if (at_us > NativeHardware::now_us && at_us < NativeHardware::wakeup_us)
+    {
+        NativeHardware::wakeup_us = at_us;
+    }
+}
+
+/**
+ * Sets a function called whenever time advances, e.g. to move simulated parts.
+ * @param handler Function to call, or nullptr to remove it
+ * @param context Pointer passed to the function
+ */
+void NativeHardware::set_tick_handler(TickHandler handler, void *context)
+{
+    NativeHardware::tick_handler = handler;
+    NativeHardware::tick_context = context;
+}
+
+void NativeHardware::set_pin_mode(uint8_t pin, uint8_t mode)
+{
+    if (pin < NativeHardware::pin_count)
+    {
+        NativeHardware::pin_modes[pin] = mode;
+    }
+}
+
+uint8_t NativeHardware::get_pin_mode(uint8_t pin)
+{
+    return pin < NativeHardware::pin_count ? NativeHardware::pin_modes[pin] : INPUT;
+}
+
+void NativeHardware::set_output(uint8_t pin, uint8_t level)
+{
+    if (pin < NativeHardware::pin_count)
+    {
+        NativeHardware::outputs[pin] = level ? HIGH : LOW;
+    }
+    NativeHardware::output_changes++;
+    NativeHardware::mark_activity();
+}
+
+uint8_t NativeHardware::get_output(uint8_t pin)
+{
+    return pin < NativeHardware::pin_count ? NativeHardware::outputs[pin] : LOW;
+}
+
+/**
+ * Gets the number of writes to outputs and servos, so models can skip unchanged outputs.
+ * @return Number of writes since start
+ */
+unsigned long NativeHardware::get_output_changes()
+{
+    return NativeHardware::output_changes;
+}
+
+/**
+ * Sets the level applied to an input pin, triggering attached interrupts on edges.
+ * @param pin Pin number
+ * @param level HIGH or LOW
+ */
+void NativeHardware::set_input(uint8_t pin, uint8_t level)
+{
+    if (pin >= NativeHardware::pin_count)
+    {
+        return;
+    }
+    uint8_t previous = NativeHardware::read_pin(pin);
+    NativeHardware::inputs[pin] = level ? HIGH : LOW;
+    NativeHardware::input_set[pin] = true;
+    if (previous != NativeHardware::inputs[pin])
+    {
+        NativeHardware::mark_activity();
+    }
+
+    int interrupt = digitalPinToInterrupt(pin);
+    if (interrupt == NOT_AN_INTERRUPT || previous == NativeHardware::inputs[pin] ||
+        NativeHardware::interrupt_handlers[interrupt] == nullptr)
+    {
+        return;
+    }
+    int mode = NativeHardware::interrupt_modes[interrupt];
+    bool rising = NativeHardware::inputs[pin] == HIGH;
+    if (mode == CHANGE || (mode == RISING && rising) || (mode == FALLING && !rising))
+    {
+        NativeHardware::fire_interrupt(interrupt);
+    }
+}
+
+/**
+ * Reads a pin: applied inputs take precedence, outputs read back their level,
+ * and unconnected pull-up inputs read HIGH.
+ * @param pin Pin number
+ * @return HIGH or LOW
+ */
+uint8_t NativeHardware::read_pin(uint8_t pin)
+{
+    if (pin >= NativeHardware::pin_count)
+    {
+        return LOW;
+    }
+    if (NativeHardware::input_set[pin])
+    {
+        return NativeHardware::inputs[pin];
+    }
+    if (NativeHardware::pin_modes[pin] == OUTPUT)
+    {
+        return NativeHardware::outputs[pin];
+    }
+    return NativeHardware::pin_modes[pin] == INPUT_PULLUP ? HIGH : LOW;
+}
+
+void NativeHardware::set_analog(uint8_t pin, int value)
+{
+    if (pin < NativeHardware::pin_count)
+    {
+        NativeHardware::analog_values[pin] = value;
+    }
+}
+
+/**
+ * Sets a function providing ADC readings, overriding the fixed values.
+ * @param source Function to call, or nullptr to use the fixed values
+ * @param context Pointer passed to the function
+ */
+void NativeHardware::set_analog_source(AnalogSource source, void *context)
+{
+    NativeHardware::analog_source = source;
+    NativeHardware::analog_context = context;
+}
+
+/**
+ * Performs an ADC conversion, taking as long as on the ATmega.
+ * @param pin Pin number (A0-A5) or analog channel (0-5)
+ * @return Reading (0-1023)
+ */
+int NativeHardware::read_analog(uint8_t pin)
+{
+    if (pin < A0)
+    {
+        pin += A0;
+    }
+    NativeHardware::mark_activity();
+    NativeHardware::advance_us(NativeHardware::analog_read_us);
+    int value = pin < NativeHardware::pin_count ? NativeHardware::analog_values[pin] : 0;
+    if (NativeHardware::analog_source != nullptr)
+    {
+        value = NativeHardware::analog_source(pin, NativeHardware::now_us, NativeHardware::analog_context);
+    }
+    return constrain(value, 0, 1023);
+}
+
+void NativeHardware::attach_interrupt(uint8_t interrupt, void (*handler)(), int mode)
+{
+    if (interrupt < NativeHardware::interrupt_count)
+    {
+        NativeHardware::interrupt_handlers[interrupt] = handler;
+        NativeHardware::interrupt_modes[interrupt] = mode;
+        NativeHardware::interrupt_pending[interrupt] = false;
+    }
+}
+
+void NativeHardware::detach_interrupt(uint8_t interrupt)
+{
+    if (interrupt < NativeHardware::interrupt_count)
+    {
+        NativeHardware::interrupt_handlers[interrupt] = nullptr;
+        NativeHardware::interrupt_pending[interrupt] = false;
+    }
+}
+
+void NativeHardware::disable_interrupts()
+{
+    NativeHardware::interrupts_enabled = false;
+}
+
+/**
+ * Enables interrupts and runs the handlers of edges that occurred while disabled.
+ */
+void NativeHardware::enable_interrupts()
+{
+    NativeHardware::interrupts_enabled = true;
+    for (uint8_t i = 0; i < NativeHardware::interrupt_count; i++)
+    {
+        if (NativeHardware::interrupt_pending[i])
+        {
+            NativeHardware::interrupt_pending[i] = false;
+            NativeHardware::fire_interrupt(i);
+        }
+    }
+}
+
+/**
+ * Runs an interrupt handler, or marks it pending while interrupts are disabled.
+ * Like the hardware flag, several edges while disabled result in one call.
+ * @param interrupt External interrupt number
+ */
+void NativeHardware::fire_interrupt(uint8_t interrupt)
+{
+    if (!NativeHardware::interrupts_enabled)
+    {
+        NativeHardware::interrupt_pending[interrupt] = true;
+        return;
+    }
+    NativeHardware::interrupts_enabled = false;
+    NativeHardware::interrupt_handlers[interrupt]();
+    NativeHardware::interrupts_enabled = true;
+}
+
+void NativeHardware::set_servo_angle(uint8_t pin, int angle)
+{
+    if (pin < NativeHardware::pin_count)
+    {
+        NativeHardware::servo_angles[pin] = angle;
+    }
+    NativeHardware::output_changes++;
+    NativeHardware::mark_activity();
+}
+
+int NativeHardware::get_servo_angle(uint8_t pin)
+{
+    return pin < NativeHardware::pin_count ? NativeHardware::servo_angles[pin] : -1;
+}
+
+void NativeHardware::register_stepper(AccelStepper *stepper)
+{
+    if (NativeHardware::stepper_count < NativeHardware::max_steppers)
+    {
+        NativeHardware::steppers[NativeHardware::stepper_count++] = stepper;
+    }
+}
+
+void NativeHardware::unregister_stepper(AccelStepper *stepper)
+{
+    for (uint8_t i = 0; i < NativeHardware::stepper_count; i++)
+    {
+        if (NativeHardware::steppers[i] == stepper)
+        {
+            for (uint8_t j = i + 1; j < NativeHardware::stepper_count; j++)
+            {
+                NativeHardware::steppers[j - 1] = NativeHardware::steppers[j];
+            }
+            NativeHardware::stepper_count--;
+            return;
+        }
+    }
+}
+
+/**
+ * Gets a registered stepper in the order they were created.
+ * @param index Position in the registry
+ * @return Stepper, or nullptr if there is none at this position
+ */
+AccelStepper *NativeHardware::get_stepper(uint8_t index)
+{
+    return index < NativeHardware::stepper_count ? NativeHardware::steppers[index] : nullptr;
+}
@@ -0,0 +1,190 @@
+/**
+ * NativeHardware.h
+ *
+ * Simulated microcontroller behind the native Arduino core.
+ * Holds the pin levels, the ADC inputs, the servo angles, the registered steppers
+ * and a virtual microsecond clock. Time only advances when the firmware waits or
+ * reads the clock, so runs are deterministic and faster than real time.
+ * With real time enabled, the clock follows the system clock instead (interactive use).
+ * With fast-forward enabled, a clock read that follows another one without any
+ * observable activity in between (pin write, ADC conversion, serial transfer, step)
+ * jumps to the next requested wakeup (e.g. the next stepper step), or to the next
+ * millisecond boundary if none is pending, so busy-wait loops cost a few iterations
+ * instead of one per microsecond. While a wakeup is pending, millis() deadlines are
+ * therefore only noticed at the next wakeup.
+ */
+
+#ifndef ARDUINO_NATIVE_NATIVE_HARDWARE_H
+#define ARDUINO_NATIVE_NATIVE_HARDWARE_H
+
+#include <stdint.h>
+
+class AccelStepper;
+
+/**
+ * NativeHardware class - state of the simulated board.
+ */
+class NativeHardware
+{
+public:
+    typedef void (*TickHandler)(uint64_t now_us, void *context);
+    typedef int (*AnalogSource)(uint8_t pin, uint64_t now_us, void *context);
+
+    static const uint8_t pin_count = 20;         // Digital pins 0-13 and analog pins A0-A5
+    static const uint8_t interrupt_count = 2;    // External interrupts (pins 2 and 3)
+    static const uint8_t max_steppers = 4;       // Steppers that can be registered
+    static const unsigned int analog_read_us;    // Duration of one ADC conversion [us]
+    static const unsigned int default_call_cost_us; // Default time taken by reading the clock [us]
+
+    /**
+     * Resets pins, interrupts, servos and the clock to power-on state.
+     * Registered steppers and handlers are kept.
+     */
+    static void reset();
+
+    /**
+     * Selects whether the clock follows the system clock.
+     * @param enabled true to run in real time, false for the virtual clock
+     */
+    static void set_real_time(bool enabled);
+
+    /**
+     * Gets the current time.
+     * @return Time since start [us]
+     */
+    static uint64_t get_time_us();
+
+    /**
+     * Lets time pass, calling the tick handler. Sleeps in real-time mode.
+     * @param duration_us Time to advance [us]
+     */
+    static void advance_us(uint64_t duration_us);
+
+    /**
+     * Sets the time charged for each call to millis() or micros(),
+     * so polling loops make progress on the virtual clock.
+     * @param cost_us Time per call [us]
+     */
+    static void set_call_cost_us(unsigned int cost_us);
+
+    /**
+     * Charges the time of one clock read, skipping idle time in fast-forward mode.
+     */
+    static void charge_call();
+
+    /**
+     * Selects whether idle clock reads skip ahead, see the file comment.
+     * Waits on micros() are only exact if a wakeup was requested for them.
+     * @param enabled true to skip idle time
+     */
+    static void set_fast_forward(bool enabled);
+
+    /**
+     * Notes that the firmware did something observable, so the next clock read is not idle.
+     */
+    static void mark_activity();
+
+    /**
+     * Requests that fast-forward does not skip past a point in time.
+     * Requests are cleared once the time has been reached.
+     * @param at_us Time at which something is due [us]
+     */
+    static void request_wakeup(uint64_t at_us);
+
+    /**
+     * Sets a function called whenever time advances, e.g. to move simulated parts.
+     * @param handler Function to call, or nullptr to remove it
+     * @param context Pointer passed to the function
+     */
+    static void set_tick_handler(TickHandler handler, void *context);
+
+    // Pins
+    static void set_pin_mode(uint8_t pin, uint8_t mode);
+    static uint8_t get_pin_mode(uint8_t pin);
+    static void set_output(uint8_t pin, uint8_t level);
+    static uint8_t get_output(uint8_t pin);
+
+    /**
+     * Gets the number of writes to outputs and servos, so models can skip unchanged outputs.
+     * @return Number of writes since start
+     */
+    static unsigned long get_output_changes();
+
+    /**
+     * Sets the level applied to an input pin, triggering attached interrupts on edges.
+     * @param pin Pin number
+     * @param level HIGH or LOW
+     */
+    static void set_input(uint8_t pin, uint8_t level);
+    static uint8_t read_pin(uint8_t pin);
+
+    // ADC
+    static void set_analog(uint8_t pin, int value);
+
+    /**
+     * Sets a function providing ADC readings, overriding the fixed values.
+     * @param source Function to call, or nullptr to use the fixed values
+     * @param context Pointer passed to the function
+     */
+    static void set_analog_source(AnalogSource source, void *context);
+    static int read_analog(uint8_t pin);
+
+    // Interrupts
+    static void attach_interrupt(uint8_t interrupt, void (*handler)(), int mode);
+    static void detach_interrupt(uint8_t interrupt);
+    static void disable_interrupts();
+
+    /**
+     * Enables interrupts and runs the handlers of edges that occurred while disabled.
+     */
+    static void enable_interrupts();
+
+    // Servos
+    static void set_servo_angle(uint8_t pin, int angle);
+    static int get_servo_angle(uint8_t pin);
+
+    // Steppers
+    static void register_stepper(AccelStepper *stepper);
+    static void unregister_stepper(AccelStepper *stepper);
+
+    /**
+     * Gets a registered stepper in the order they were created.
+     * @param index Position in the registry
+     * @return Stepper, or nullptr if there is none at this position
+     */
+    static AccelStepper *get_stepper(uint8_t index);
+
+private:
+    static void fire_interrupt(uint8_t interrupt);
+
+    static uint64_t now_us;                 // Virtual time [us]
+    static uint64_t real_start_us;          // System time at start in real-time mode [us]
+    static bool real_time;                  // Whether the clock follows the system clock
+    static unsigned int call_cost_us;       // Time charged per clock read [us]
+    static TickHandler tick_handler;        // Called when time advances
+    static void *tick_context;              // Passed to the tick handler
+    static bool in_tick;                    // Prevents nested tick handler calls
+    static bool fast_forward;               // Whether idle clock reads skip ahead
+    static bool idle;                       // No activity since the last clock read
+    static uint64_t wakeup_us;              // Earliest requested wakeup [us]
+
+    static uint8_t pin_modes[pin_count];    // INPUT, OUTPUT or INPUT_PULLUP
+    static uint8_t outputs[pin_count];      // Levels written by the firmware
+    static uint8_t inputs[pin_count];       // Levels applied from outside
+    static bool input_set[pin_count];       // Whether an input level was applied
+    static unsigned long output_changes;    // Writes to outputs and servos
+    static int analog_values[pin_count];    // Fixed ADC readings
+    static AnalogSource analog_source;      // Optional function providing ADC readings
+    static void *analog_context;            // Passed to the ADC function
+    static int servo_angles[pin_count];     // Servo angle per pin (-1 if no servo)
+
+    static void (*interrupt_handlers[interrupt_count])();
+    static int interrupt_modes[interrupt_count];
+    static bool interrupt_pending[interrupt_count];
+    static bool interrupts_enabled;
+
+    static AccelStepper *steppers[max_steppers];
+    static uint8_t stepper_count;
+};
+
+#endif
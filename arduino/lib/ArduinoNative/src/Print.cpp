@@ -0,0 +1,145 @@
+/**
+ * Print.cpp
+ *
+ * Arduino Print base class for the native build.
+ */
+
+#include "Arduino.h"
+#include "Print.h"
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+    size_t written = 0;
+    while (size-- > 0)
+    {
+        written += this->write(*buffer++);
+    }
+    return written;
+}
+
+size_t Print::write(const char *text)
+{
+    return text == nullptr ? 0 : this->write((const uint8_t *)text, strlen(text));
+}
+
+/**
+ * Gets the number of bytes that can be written without blocking.
+ * @return Free space in the output buffer
+ */
+int Print::availableForWrite()
+{
+    return 0;
+}
+
+void Print::flush()
+{
+}
+
+size_t Print::print(const __FlashStringHelper *text)
+{
+    return this->write((const char *)text);
+}
+
+size_t Print::print(const String &text)
+{
+    return this->write((const uint8_t *)text.c_str(), text.length());
+}
+
+size_t Print::print(const char *text)
+{
+    return this->write(text);
+}
+
+size_t Print::print(char character)
+{
+    return this->write((uint8_t)character);
+}
+
+size_t Print::print(unsigned char value, int base)
+{
+    return this->print((unsigned long)value, base);
+}
+
+size_t Print::print(int value, int base)
+{
+    return this->print((long)value, base);
+}
+
+size_t Print::print(unsigned int value, int base)
+{
+    return this->print((unsigned long)value, base);
+}
+
+size_t Print::print(long value, int base)
+{
+    char buffer[sizeof(long) * 8 + 2];
+    return this->write(ltoa(value, buffer, base));
+}
+
+size_t Print::print(unsigned long value, int base)
+{
+    char buffer[sizeof(unsigned long) * 8 + 1];
+    return this->write(ultoa(value, buffer, base));
+}
+
+size_t Print::print(double value, int digits)
+{
+    char buffer[48];
+    snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+    return this->write(buffer);
+}
+
+size_t Print::println()
+{
+    return this->write("\r\n");
+}
+
+size_t Print::println(const __FlashStringHelper *text)
+{
+    return this->print(text) + this->println();
+}
+
+size_t Print::println(const String &text)
+{
+    return this->print(text) + this->println();
+}
+
+size_t Print::println(const char *text)
+{
+    return this->print(text) + this->println();
+}
+
+size_t Print::println(char character)
+{
+    return this->print(character) + this->println();
+}
+
+size_t Print::println(unsigned char value, int base)
+{
+    return this->print(value, base) + this->println();
+}
+
+size_t Print::println(int value, int base)
+{
+    return this->print(value, base) + this->println();
+}
+
+size_t Print::println(unsigned int value, int base)
+{
+    return this->print(value, base) + this->println();
+}
+
+size_t Print::println(long value, int base)
+{
+    return this->print(value, base) + this->println();
+}
+
+size_t Print::println(unsigned long value, int base)
+{
+    return this->print(value, base) + this->println();
+}
+
+size_t Print::println(double value, int digits)
+{
+    return this->print(value, digits) + this->println();
+}
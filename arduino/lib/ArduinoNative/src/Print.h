@@ -0,0 +1,75 @@
+/**
+ * Print.h
+ *
+ * Arduino Print and Stream base classes for the native build.
+ * Subclasses only implement writing single bytes; text formatting matches the Arduino core.
+ */
+
+#ifndef ARDUINO_NATIVE_PRINT_H
+#define ARDUINO_NATIVE_PRINT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "WString.h"
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+/**
+ * Print class - formats text and numbers onto a byte output.
+ */
+class Print
+{
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t byte) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    size_t write(const char *text);
+
+    /**
+     * Gets the number of bytes that can be written without blocking.
+     * @return Free space in the output buffer
+     */
+    virtual int availableForWrite();
+    virtual void flush();
+
+    size_t print(const __FlashStringHelper *text);
+    size_t print(const String &text);
+    size_t print(const char *text);
+    size_t print(char character);
+    size_t print(unsigned char value, int base = DEC);
+    size_t print(int value, int base = DEC);
+    size_t print(unsigned int value, int base = DEC);
+    size_t print(long value, int base = DEC);
+    size_t print(unsigned long value, int base = DEC);
+    size_t print(double value, int digits = 2);
+
+    size_t println();
+    size_t println(const __FlashStringHelper *text);
+    size_t println(const String &text);
+    size_t println(const char *text);
+    size_t println(char character);
+    size_t println(unsigned char value, int base = DEC);
+    size_t println(int value, int base = DEC);
+    size_t println(unsigned int value, int base = DEC);
+    size_t println(long value, int base = DEC);
+    size_t println(unsigned long value, int base = DEC);
+    size_t println(double value, int digits = 2);
+};
+
+/**
+ * Stream class - byte input in addition to output.
+ */
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+#endif
@@ -0,0 +1,74 @@
+/**
+ * Servo.cpp
+ *
+ * Servo library replacement for the native build.
+ */
+
+#include "Arduino.h"
+#include "NativeHardware.h"
+#include "Servo.h"
+
+Servo::Servo() : pin(-1), min_us(MIN_PULSE_WIDTH), max_us(MAX_PULSE_WIDTH), pulse_us(1500) {}
+
+uint8_t Servo::attach(int pin)
+{
+    return this->attach(pin, MIN_PULSE_WIDTH, MAX_PULSE_WIDTH);
+}
+
+uint8_t Servo::attach(int pin, int min, int max)
+{
+    this->pin = pin;
+    this->min_us = min;
+    this->max_us = max;
+    NativeHardware::set_pin_mode(pin, OUTPUT);
+    NativeHardware::set_servo_angle(pin, this->read());
+    return 0;
+}
+
+void Servo::detach()
+{
+    if (this->pin >= 0)
+    {
+        NativeHardware::set_servo_angle(this->pin, -1);
+    }
+    this->pin = -1;
+}
+
+bool Servo::attached()
+{
+    return this->pin >= 0;
+}
+
+/**
+ * Commands an angle, or a pulse width if the value is at least the minimum pulse width.
+ * @param value Angle [degrees] or pulse width [us]
+ */
+void Servo::write(int value)
+{
+    if (value < MIN_PULSE_WIDTH)
+    {
+        value = constrain(value, 0, 180);
+        value = this->min_us + (long)value * (this->max_us - this->min_us) / 180;
+    }
+    this->writeMicroseconds(value);
+}
+
+void Servo::writeMicroseconds(int value)
+{
+    this->pulse_us = constrain(value, this->min_us, this->max_us);
+    if (this->pin >= 0)
+    {
+        NativeHardware::set_servo_angle(this->pin, this->read());
+    }
+}
+
+int Servo::read()
+{
+    return ((long)(this->pulse_us - this->min_us) * 180 + (this->max_us - this->min_us) / 2) /
+           (this->max_us - this->min_us);
+}
+
+int Servo::readMicroseconds()
+{
+    return this->pulse_us;
+}
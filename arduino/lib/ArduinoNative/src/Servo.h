@@ -0,0 +1,45 @@
+/**
+ * Servo.h
+ *
+ * Servo library replacement for the native build.
+ * Commanded angles are recorded per pin in NativeHardware; the servo reaches them instantly.
+ */
+
+#ifndef ARDUINO_NATIVE_SERVO_H
+#define ARDUINO_NATIVE_SERVO_H
+
+#include <stdint.h>
+
+#define MIN_PULSE_WIDTH 544
+#define MAX_PULSE_WIDTH 2400
+
+/**
+ * Servo class - hobby servo on a digital pin.
+ */
+class Servo
+{
+public:
+    Servo();
+
+    uint8_t attach(int pin);
+    uint8_t attach(int pin, int min, int max);
+    void detach();
+    bool attached();
+
+    /**
+     * Commands an angle, or a pulse width if the value is at least the minimum pulse width.
+     * @param value Angle [degrees] or pulse width [us]
+     */
+    void write(int value);
+    void writeMicroseconds(int value);
+    int read();
+    int readMicroseconds();
+
+private:
+    int pin;       // Attached pin (-1 if detached)
+    int min_us;    // Pulse width at 0 degrees [us]
+    int max_us;    // Pulse width at 180 degrees [us]
+    int pulse_us;  // Commanded pulse width [us]
+};
+
+#endif
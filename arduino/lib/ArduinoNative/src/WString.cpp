@@ -0,0 +1,126 @@
+/**
+ * WString.cpp
+ *
+ * Arduino String for the native build, backed by std::string.
+ */
+
+#include "Arduino.h"
+
+String::String() {}
+
+String::String(const char *text) : text(text != nullptr ? text : "") {}
+
+String::String(const __FlashStringHelper *text) : text(text != nullptr ? (const char *)text : "") {}
+
+String::String(const std::string &text) : text(text) {}
+
+String::String(char character) : text(1, character) {}
+
+String::String(int value) : text(std::to_string(value)) {}
+
+String::String(unsigned int value) : text(std::to_string(value)) {}
+
+String::String(long value) : text(std::to_string(value)) {}
+
+String::String(unsigned long value) : text(std::to_string(value)) {}
+
+String::String(float value, unsigned char decimals) : String((double)value, decimals) {}
+
+String::String(double value, unsigned char decimals)
+{
+    char buffer[48];
+    snprintf(buffer, sizeof(buffer), "%.*f", decimals, value);
+    this->text = buffer;
+}
+
+/**
+ * Appends text to the string.
+ * @param other Text to append
+ * @return true (allocation does not fail on the workstation)
+ */
+bool String::concat(const String &other)
+{
+    this->text += other.text;
+    return true;
+}
+
+String &String::operator+=(const String &other)
+{
+    this->concat(other);
+    return *this;
+}
+
+String operator+(const String &left, const String &right)
+{
+    return String(left.text + right.text);
+}
+
+bool String::operator==(const String &other) const
+{
+    return this->text == other.text;
+}
+
+bool String::operator!=(const String &other) const
+{
+    return this->text != other.text;
+}
+
+unsigned int String::length() const
+{
+    return this->text.size();
+}
+
+const char *String::c_str() const
+{
+    return this->text.c_str();
+}
+
+char String::charAt(unsigned int index) const
+{
+    return index < this->text.size() ? this->text[index] : '\0';
+}
+
+int String::indexOf(char character) const
+{
+    size_t position = this->text.find(character);
+    return position == std::string::npos ? -1 : (int)position;
+}
+
+String String::substring(unsigned int begin) const
+{
+    return begin < this->text.size() ? String(this->text.substr(begin)) : String();
+}
+
+String String::substring(unsigned int begin, unsigned int end) const
+{
+    if (begin >= this->text.size() || end <= begin)
+    {
+        return String();
+    }
+    return String(this->text.substr(begin, end - begin));
+}
+
+/**
+ * Removes leading and trailing whitespace.
+ */
+void String::trim()
+{
+    size_t first = this->text.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos)
+    {
+        this->text.clear();
+        return;
+    }
+    size_t last = this->text.find_last_not_of(" \t\r\n");
+    this->text = this->text.substr(first, last - first + 1);
+}
+
+long String::toInt() const
+{
+    return atol(this->text.c_str());
+}
+
+float String::toFloat() const
+{
+    return atof(this->text.c_str());
+}
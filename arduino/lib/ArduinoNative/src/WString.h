@@ -0,0 +1,59 @@
+/**
+ * WString.h
+ *
+ * Arduino String for the native build, backed by std::string.
+ * Numbers are formatted like the Arduino core (floats with 2 decimals).
+ */
+
+#ifndef ARDUINO_NATIVE_WSTRING_H
+#define ARDUINO_NATIVE_WSTRING_H
+
+#include <string>
+
+class __FlashStringHelper;
+
+/**
+ * String class - dynamically allocated text.
+ */
+class String
+{
+public:
+    String();
+    String(const char *text);
+    String(const __FlashStringHelper *text);
+    String(const std::string &text);
+    String(char character);
+    String(int value);
+    String(unsigned int value);
+    String(long value);
+    String(unsigned long value);
+    String(float value, unsigned char decimals = 2);
+    String(double value, unsigned char decimals = 2);
+
+    /**
+     * Appends text to the string.
+     * @param other Text to append
+     * @return true (allocation does not fail on the workstation)
+     */
+    bool concat(const String &other);
+    String &operator+=(const String &other);
+    friend String operator+(const String &left, const String &right);
+
+    bool operator==(const String &other) const;
+    bool operator!=(const String &other) const;
+
+    unsigned int length() const;
+    const char *c_str() const;
+    char charAt(unsigned int index) const;
+    int indexOf(char character) const;
+    String substring(unsigned int begin) const;
+    String substring(unsigned int begin, unsigned int end) const;
+    void trim();
+    long toInt() const;
+    float toFloat() const;
+
+private:
+    std::string text; // Characters of the string
+};
+
+#endif
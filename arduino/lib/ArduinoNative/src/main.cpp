@@ -0,0 +1,30 @@
+/**
+ * main.cpp
+ *
+ * Entry point of the native build: runs the sketch in real time,
+ * with the serial port on stdin and stdout.
+ * Simulations providing their own main() build with ARDUINO_NATIVE_NO_MAIN.
+ */
+
+#ifndef ARDUINO_NATIVE_NO_MAIN
+
+#include <unistd.h>
+
+#include "Arduino.h"
+#include "NativeHardware.h"
+
+int main()
+{
+    NativeHardware::reset();
+    NativeHardware::set_real_time(true);
+    Serial.set_input_fd(STDIN_FILENO);
+
+    setup();
+    while (true)
+    {
+        loop();
+    }
+    return 0;
+}
+
+#endif
@@ -10,22 +10,12 @@
 #include <Servo.h>
 
 #include "../InterfaceMaster.h"
+#include "../Interface/Config.h"
 
 #include "Basket.h"
 #include "Door.h"
 #include "Sorting.h"
 
-// Sorting servo position constants (in degrees)
-const int BasketSorter::small_pos = 20;   // Position to direct raspberries to small compartment
-const int BasketSorter::idle_pos = 86;    // Neutral/idle position
-const int BasketSorter::large_pos = 152;  // Position to direct raspberries to large compartment
-
-// Door servo position constants (in degrees)
-const int BasketDoor::closed_pos = 170;  // Position when door is closed
-const int BasketDoor::open_pos = 10;     // Position when door is open
-const int BasketDoor::max_fill = 23;     // Maximum fill count before basket should be emptied
-const int BasketDoor::delay_ms = 10000;  // Time to wait for basket to empty (10 seconds)
-
 /**
  * Constructor - initializes basket controller with pin configuration.
  * @param pinout Pointer to BasketPinout structure with pin assignments
@@ -63,13 +53,13 @@ int BasketController::get_desired_door_pos(BasketDoor::DoorState new_door_state)
     switch (new_door_state)
     {
     case BasketDoor::DoorState::CLOSED:
-        desired_pos = BasketDoor::closed_pos;
+        desired_pos = Config::values.basket_door_closed_pos;
         break;
     case BasketDoor::DoorState::OPEN:
-        desired_pos = BasketDoor::open_pos;
+        desired_pos = Config::values.basket_door_open_pos;
         break;
     };
-    Serial.println((String) "desired door pos: " + desired_pos);
+    this->interface->log((String)F("desired door pos: ") + desired_pos);
     return desired_pos;
 }
 
@@ -82,8 +72,8 @@ void BasketController::set_door(BasketDoor::DoorState target_state)
     int target_position = this->get_desired_door_pos(target_state);
     this->door_state = target_state;
     this->door_servo.write(target_position);
-    this->interface->send_state("basket.door.state", BasketDoor::serialize_door_state(target_state));
-    this->interface->send_state("basket.door.position", target_position);
+    this->interface->send_state(TelemetryKey::BASKET_DOOR_STATE, target_state);
+    this->interface->send_state(TelemetryKey::BASKET_DOOR_POSITION, target_position);
 }
 
 /**
@@ -98,9 +88,9 @@ bool BasketController::reset_counter(bool force)
     if (reset)
     {
         this->fill_count.fill_small = 0;
-        this->interface->send_state("basket.fill_count.small", this->fill_count.fill_small);
+        this->interface->send_state(TelemetryKey::BASKET_FILL_COUNT_SMALL, this->fill_count.fill_small);
         this->fill_count.fill_large = 0;
-        this->interface->send_state("basket.fill_count.large", this->fill_count.fill_large);
+        this->interface->send_state(TelemetryKey::BASKET_FILL_COUNT_LARGE, this->fill_count.fill_large);
     }
 
     return reset;
@@ -118,13 +108,13 @@ int BasketController::get_desired_sorting_pos(BasketSorter::SortingState new_sor
     switch (new_sorting_state)
     {
     case BasketSorter::SortingState::IDLE:
-        desired_pos = BasketSorter::idle_pos;
+        desired_pos = Config::values.basket_sorting_idle_pos;
         break;
     case BasketSorter::SortingState::SMALL:
-        desired_pos = BasketSorter::small_pos;
+        desired_pos = Config::values.basket_sorting_small_pos;
         break;
     case BasketSorter::SortingState::LARGE:
-        desired_pos = BasketSorter::large_pos;
+        desired_pos = Config::values.basket_sorting_large_pos;
         break;
     };
     return desired_pos;
@@ -138,9 +128,9 @@ void BasketController::set_sorting(BasketSorter::SortingState target_state)
 {
     int target_position = this->get_desired_sorting_pos(target_state);
     this->sorting_state = target_state;
-    this->interface->send_state("basket.sorting.state", BasketSorter::serialize_sorting_state(target_state));
+    this->interface->send_state(TelemetryKey::BASKET_SORTING_STATE, target_state);
     this->sorting_servo.write(target_position);
-    this->interface->send_state("basket.sorting.position", target_position);
+    this->interface->send_state(TelemetryKey::BASKET_SORTING_POSITION, target_position);
 }
 
 /**
@@ -157,12 +147,37 @@ bool BasketController::increment_counter()
         break;
     case BasketSorter::SortingState::SMALL:
         this->fill_count.fill_small += 1;
-        this->interface->send_state("basket.fill_count.small", this->fill_count.fill_small);
+        this->interface->send_state(TelemetryKey::BASKET_FILL_COUNT_SMALL, this->fill_count.fill_small);
         break;
     case BasketSorter::SortingState::LARGE:
         this->fill_count.fill_large += 1;
-        this->interface->send_state("basket.fill_count.large", this->fill_count.fill_large);
+        this->interface->send_state(TelemetryKey::BASKET_FILL_COUNT_LARGE, this->fill_count.fill_large);
         break;
     }
     return true;
 }
+
+/**
+ * Gets the current door state.
+ * @return Door state (OPEN or CLOSED)
+ */
+BasketDoor::DoorState BasketController::get_door_state()
+{
+    return this->door_state;
+}
+
+/**
+ * Restores fill counts, sorting and door state journaled before a power loss.
+ * The servos are moved to the restored positions and the host is updated.
+ * @param fill_count Fill counts of both compartments
+ * @param sorting_state Sorting state
+ * @param door_state Door state
+ */
+void BasketController::restore(FillCount fill_count, BasketSorter::SortingState sorting_state, BasketDoor::DoorState door_state)
+{
+    this->fill_count = fill_count;
+    this->interface->send_state(TelemetryKey::BASKET_FILL_COUNT_SMALL, this->fill_count.fill_small);
+    this->interface->send_state(TelemetryKey::BASKET_FILL_COUNT_LARGE, this->fill_count.fill_large);
+    this->set_sorting(sorting_state);
+    this->set_door(door_state);
+}
@@ -85,6 +85,16 @@ public:
      */
     bool increment_counter();
 
+    /**
+     * Gets the current door state.
+     */
+    BasketDoor::DoorState get_door_state();
+
+    /**
+     * Restores fill counts, sorting and door state journaled before a power loss.
+     */
+    void restore(FillCount fill_count, BasketSorter::SortingState sorting_state, BasketDoor::DoorState door_state);
+
     FillCount fill_count;                          // Current fill counts for both compartments
     BasketSorter::SortingState sorting_state;      // Current sorting mechanism state
 
@@ -1,16 +1,23 @@
 /**
  * Door.h
  * 
- * Basket door state definitions and serialization utilities.
- * Provides functions to convert between DoorState enum and string representations.
+ * Basket door state definitions and configuration.
+ * DoorState is reflected, see EnumReflection.h for the conversion to and from strings.
  */
 
 #ifndef RASPBERRY_PICKER_BASKET_DOOR_H
 #define RASPBERRY_PICKER_BASKET_DOOR_H
 
+#include "../Interface/EnumReflection.h"
+
+// Values of BasketDoor::DoorState
+#define RASPBERRY_PICKER_DOOR_STATES(X) \
+    X(OPEN) \
+    X(CLOSED)
+
 /**
  * BasketDoor class - manages basket door state and configuration.
- * Provides door state serialization and position constants.
+ * Provides door state and position constants.
  */
 class BasketDoor
 {
@@ -22,24 +29,12 @@ public:
      */
     enum class DoorState
     {
-        OPEN,
-        CLOSED,
+        RASPBERRY_PICKER_DOOR_STATES(ENUM_REFLECTION_VALUE)
     };
 
-    /**
-     * Converts DoorState enum to string representation.
-     */
-    static const char *serialize_door_state(BasketDoor::DoorState door_state);
-    
-    /**
-     * Converts string to DoorState enum.
-     */
-    static bool deserialize_door_state(String door_state_str, BasketDoor::DoorState *out_door_state);
-
-    static const int closed_pos; // Servo position when door is closed [degrees]
-    static const int open_pos;   // Servo position when door is open [degrees]
-    static const int max_fill;   // Maximum number of raspberries before basket should be emptied
-    static const int delay_ms;   // Time to wait for basket to empty after opening door [ms]
+    // Servo positions, fill limit and emptying delay are configuration values, see Interface/Config.h
 };
 
+ENUM_REFLECTION_DECLARE(BasketDoor::DoorState)
+
 #endif
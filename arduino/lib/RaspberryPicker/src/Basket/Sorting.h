@@ -1,14 +1,22 @@
 /**
  * Sorting.h
  * 
- * Basket sorting mechanism state definitions and serialization utilities.
- * Provides functions to convert between SortingState enum and string representations.
+ * Basket sorting mechanism state definitions and configuration.
+ * SortingState is reflected, see EnumReflection.h for the conversion to and from strings.
  */
 
 #ifndef RASPBERRY_PICKER_BASKET_SORTING_H
 #define RASPBERRY_PICKER_BASKET_SORTING_H
 #include <Arduino.h>
 
+#include "../Interface/EnumReflection.h"
+
+// Values of BasketSorter::SortingState
+#define RASPBERRY_PICKER_SORTING_STATES(X) \
+    X(LARGE) \
+    X(SMALL) \
+    X(IDLE)
+
 /**
  * BasketSorter class - manages sorting mechanism state and configuration.
  * Controls the servo that directs raspberries to small or large compartments.
@@ -24,24 +32,12 @@ public:
      */
     enum class SortingState
     {
-        LARGE,
-        SMALL,
-        IDLE,
+        RASPBERRY_PICKER_SORTING_STATES(ENUM_REFLECTION_VALUE)
     };
-    
-    static const int large_pos;  // Servo position for directing to large compartment [degrees]
-    static const int small_pos;  // Servo position for directing to small compartment [degrees]
-    static const int idle_pos;   // Servo position for neutral/idle state [degrees]
 
-    /**
-     * Converts SortingState enum to string representation.
-     */
-    static const char *serialize_sorting_state(BasketSorter::SortingState sorting_state);
-    
-    /**
-     * Converts string to SortingState enum.
-     */
-    static bool deserialize_sorting_state(String sorting_state_str, BasketSorter::SortingState *out_sorting_state);
+    // Servo positions are configuration values, see Interface/Config.h
 };
 
+ENUM_REFLECTION_DECLARE(BasketSorter::SortingState)
+
 #endif
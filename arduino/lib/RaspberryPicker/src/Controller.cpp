@@ -14,6 +14,11 @@
 
 #include "Gripper/Gripper.h"
 #include "Gripper/GripperStepper.h"
+#include "Interface/Config.h"
+
+ENUM_REFLECTION_DEFINE(Controller::State, RASPBERRY_PICKER_CONTROLLER_STATES, controller_state_names)
+ENUM_REFLECTION_DEFINE(Controller::Program, RASPBERRY_PICKER_PROGRAMS, program_names)
+
 /**
  * Constructor - creates a controller with specified initial state.
  * @param state Initial state for the controller
@@ -36,6 +41,7 @@ Controller::Controller(State state, InterfaceMaster *interface)
     this->basket_controller = nullptr;
     this->gripper_controller = nullptr;
     this->interface = interface;
+    this->plate_position_trusted = false;
     this->set_state(state);
 }
 
@@ -77,7 +83,7 @@ void Controller::set_program(Controller::Program program)
     this->program = program;
     if (this->interface != nullptr)
     {
-        this->interface->send_state("controller.program", this->serialize_program(this->get_program()));
+        this->interface->send_state(TelemetryKey::CONTROLLER_PROGRAM, this->get_program());
     }
 }
 
@@ -91,7 +97,7 @@ void Controller::set_state(Controller::State state)
     this->state = state;
     if (this->interface != nullptr)
     {
-        this->interface->send_state("controller.state", this->serialize_state(this->get_state()));
+        this->interface->send_state(TelemetryKey::CONTROLLER_STATE, this->get_state());
     }
 }
 
@@ -106,6 +112,49 @@ void Controller::add_controllers(BasketController *basket_controller, GripperCon
     this->gripper_controller = gripper_controller;
 }
 
+/**
+ * Restores the state journaled before the last power loss.
+ * Fill counts, sorter and door are restored from any valid entry. The plate position
+ * only if the plate stood still, then the next RESET skips the homing sweep.
+ * @return COLD, WARM if homing can be skipped, or DIRTY
+ */
+StateJournal::Status Controller::resume()
+{
+    StateJournal::Snapshot snapshot;
+    StateJournal::Status status = StateJournal::restore(&snapshot);
+    if (status == StateJournal::Status::COLD)
+    {
+        return status;
+    }
+
+    FillCount fill_count{snapshot.fill_small, snapshot.fill_large};
+    this->basket_controller->restore(fill_count, static_cast<BasketSorter::SortingState>(snapshot.sorting_state),
+                                     static_cast<BasketDoor::DoorState>(snapshot.door_state));
+    if (status == StateJournal::Status::WARM)
+    {
+        this->gripper_controller->restore(snapshot.plate_position,
+                                          static_cast<GripperStepper::GripperState>(snapshot.gripper_state));
+        this->plate_position_trusted = true;
+    }
+    return status;
+}
+
+/**
+ * Journals the current state if it changed.
+ */
+void Controller::save_state()
+{
+    StateJournal::Snapshot snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+    snapshot.fill_small = this->basket_controller->fill_count.fill_small;
+    snapshot.fill_large = this->basket_controller->fill_count.fill_large;
+    snapshot.plate_position = this->gripper_controller->plate_stepper->currentPosition();
+    snapshot.gripper_state = static_cast<uint8_t>(this->gripper_controller->gripper_state);
+    snapshot.sorting_state = static_cast<uint8_t>(this->basket_controller->sorting_state);
+    snapshot.door_state = static_cast<uint8_t>(this->basket_controller->get_door_state());
+    StateJournal::record(snapshot);
+}
+
 /**
  * Adds reference to interface master for communication.
  * @param interface Pointer to InterfaceMaster
@@ -117,46 +166,37 @@ void Controller::add_interface(InterfaceMaster *interface)
 
 /**
  * Executes the close gripper program.
- * Attempts to close gripper in stages (LARGE -> SMALL -> LIMIT) until a raspberry
- * is detected. Measures color/ripeness and sets sorting mechanism accordingly.
+ * Closes the gripper in one motion towards the limit switch, classifying the raspberry
+ * by where it touches the pressure plate. Measures color/ripeness and sets sorting mechanism accordingly.
  * If raspberry is unripe, releases it immediately.
  */
 void Controller::run_close()
 {
 
-    // Attempt to close gripper at large size position
-    GripperStepper::RaspberrySize size = this->gripper_controller->set_gripper(GripperStepper::GripperState::CLOSED_LARGE);
-
-    this->interface->send_state("gripper.raspberry_size", GripperStepper::serialize_raspberry_size(size));
+    // Close in a single pass - the pressure plate stops the plate at the raspberry, which is sized by the contact position
+    PHASE_PROFILER_BEGIN(close_limit_start);
+    GripperStepper::RaspberrySize size = this->gripper_controller->set_gripper(GripperStepper::GripperState::CLOSED_LIMIT);
+    PHASE_PROFILER_END(this->profiler, close_limit_start, CLOSE_LIMIT);
 
-    // If no raspberry detected, try small size position
-    if (size == GripperStepper::RaspberrySize::UNKNOWN)
-    {
-        size = this->gripper_controller->set_gripper(GripperStepper::GripperState::CLOSED_SMALL);
-    }
-
-    this->interface->send_state("gripper.raspberry_size", GripperStepper::serialize_raspberry_size(size));
-
-    // If still no raspberry detected, close to limit switch
-    if (size == GripperStepper::RaspberrySize::UNKNOWN)
-    {
-        size = this->gripper_controller->set_gripper(GripperStepper::GripperState::CLOSED_LIMIT);
-    }
-
-    this->interface->send_state("gripper.raspberry_size", GripperStepper::serialize_raspberry_size(size));
+    this->interface->send_state(TelemetryKey::GRIPPER_RASPBERRY_SIZE, size);
 
     // Measure color to determine ripeness
+    PHASE_PROFILER_BEGIN(sense_start);
     bool is_ripe = this->gripper_controller->is_ripe();
-    this->interface->send_state("gripper.raspberry_ripeness", is_ripe ? "RIPE" : "UNRIPE");
+    PHASE_PROFILER_END(this->profiler, sense_start, SENSE_COLOR);
+    this->interface->send_state(TelemetryKey::GRIPPER_RASPBERRY_RIPENESS, is_ripe ? ColorSensor::Ripeness::RIPE : ColorSensor::Ripeness::UNRIPE);
 
     // If unripe, release raspberry and exit
     if (!is_ripe)
     {
+        PHASE_PROFILER_BEGIN(reopen_start);
         this->gripper_controller->set_gripper(GripperStepper::GripperState::OPEN);
+        PHASE_PROFILER_END(this->profiler, reopen_start, REOPEN);
         return;
     }
 
     // Set sorting mechanism to appropriate position based on size
+    PHASE_PROFILER_BEGIN(sort_start);
     switch (size)
     {
     case GripperStepper::RaspberrySize::LARGE:
@@ -170,6 +210,7 @@ void Controller::run_close()
         this->gripper_controller->set_gripper(GripperStepper::GripperState::OPEN);
         break;
     }
+    PHASE_PROFILER_END(this->profiler, sort_start, SORT);
 }
 
 /**
@@ -178,10 +219,12 @@ void Controller::run_close()
  */
 void Controller::run_release()
 {
+    PHASE_PROFILER_BEGIN(reopen_start);
     this->gripper_controller->set_gripper(GripperStepper::GripperState::OPEN);
+    PHASE_PROFILER_END(this->profiler, reopen_start, REOPEN);
     if (this->basket_controller->increment_counter() == false)
     {
-        Serial.println((String) "cannot increment counter on sorting state " + BasketSorter::serialize_sorting_state(this->basket_controller->sorting_state));
+        this->interface->log((String)F("cannot increment counter on sorting state ") + EnumReflection::serialize(this->basket_controller->sorting_state));
     }
     this->basket_controller->set_sorting(BasketSorter::SortingState::IDLE);
 }
@@ -194,17 +237,25 @@ void Controller::run_drop()
 {
     this->basket_controller->set_door(BasketDoor::DoorState::OPEN);
     this->basket_controller->reset_counter(false);
-    delay(BasketDoor::delay_ms);
+    PHASE_PROFILER_BEGIN(dwell_start);
+    delay(Config::values.basket_door_delay_ms);
+    PHASE_PROFILER_END(this->profiler, dwell_start, DOOR_DWELL);
     this->basket_controller->set_door(BasketDoor::DoorState::CLOSED);
 }
 
 /**
  * Executes the reset program.
- * Resets all components to their initial positions and clears counters.
+ * Homes the gripper plate at the zero limit switch, then resets all components
+ * to their initial positions and clears counters.
  */
 void Controller::run_reset()
 {
-    this->gripper_controller->set_gripper(GripperStepper::GripperState::CLOSED_LIMIT);
+    // After a warm start the plate position is known, so the first reset skips homing at the zero switch
+    if (!this->plate_position_trusted)
+    {
+        this->gripper_controller->home();
+    }
+    this->plate_position_trusted = false;
     this->gripper_controller->set_gripper(GripperStepper::GripperState::OPEN);
     this->basket_controller->set_door(BasketDoor::DoorState::CLOSED);
     this->basket_controller->set_sorting(BasketSorter::SortingState::IDLE);
@@ -232,15 +283,16 @@ void Controller::run_measure_color()
         int plate_distance = GripperStepper::steps_to_mm(current_position_step);
         
         // Report measurements
-        Serial.println((String) "raw_value:" + rgb_raw.r + "/" + rgb_raw.g + "/" + rgb_raw.b + "/" + rgb_raw.noise + "/" + plate_distance);
+        this->interface->log((String)F("raw_value:") + rgb_raw.r + '/' + rgb_raw.g + '/' + rgb_raw.b + '/' + rgb_raw.noise + '/' + plate_distance);
         
         // Move to half-open position for next measurement
-        this->gripper_controller->plate_stepper->setSpeed(GripperStepper::speed);
+        this->gripper_controller->plate_stepper->setSpeed(Config::values.gripper_speed);
         this->gripper_controller->plate_stepper->moveTo(desired_steps_halfopen);
         while (this->gripper_controller->plate_stepper->isRunning())
         {
             this->gripper_controller->plate_stepper->run();
         }
+        this->interface->flush();
         delay(100);
     }
 }
@@ -249,12 +301,11 @@ void Controller::run_measure_color()
  * Executes Program 1 - Complete automated picking sequence.
  * 
  * This program performs the full raspberry picking cycle:
- * 1. Closes gripper progressively (LARGE -> SMALL -> LIMIT) to detect size
- * 2. Measures color/ripeness
- * 3. If unripe, releases and exits
- * 4. If ripe, sets sorting mechanism based on size
- * 5. Waits for user to pick raspberry (monitors pressure plate)
- * 6. Opens gripper, increments counter, resets sorting
+ * 1. Closes gripper in one motion towards the limit switch, detecting the size at the pressure plate contact
+ * 2. Measures color/ripeness, positioning the sorting mechanism based on size meanwhile
+ * 3. If unripe, resets sorting, releases and exits
+ * 4. Waits for user to pick raspberry (monitors pressure plate)
+ * 5. Opens gripper, increments counter, resets sorting
  * 
  * Note: For UNKNOWN size (no pressure detected), assumes small size and
  * doesn't wait for pressure plate release.
@@ -262,37 +313,20 @@ void Controller::run_measure_color()
 void Controller::run_pgm1()
 {
     
-    // Progressively close gripper until raspberry size is detected
-    GripperStepper::RaspberrySize size = this->gripper_controller->set_gripper(GripperStepper::GripperState::CLOSED_LARGE);
-
-    this->interface->send_state("gripper.raspberry_size", GripperStepper::serialize_raspberry_size(size));
-
-    if (size == GripperStepper::RaspberrySize::UNKNOWN)
-    {
-        size = this->gripper_controller->set_gripper(GripperStepper::GripperState::CLOSED_SMALL);
-    }
-
-    this->interface->send_state("gripper.raspberry_size", GripperStepper::serialize_raspberry_size(size));
-
-    if (size == GripperStepper::RaspberrySize::UNKNOWN)
-    {
-        size = this->gripper_controller->set_gripper(GripperStepper::GripperState::CLOSED_LIMIT);
-    }
+    // Close in a single pass - one motion profile, sized at the pressure plate contact
+    PHASE_PROFILER_BEGIN(close_limit_start);
+    GripperStepper::RaspberrySize size = this->gripper_controller->set_gripper(GripperStepper::GripperState::CLOSED_LIMIT);
+    PHASE_PROFILER_END(this->profiler, close_limit_start, CLOSE_LIMIT);
 
-    this->interface->send_state("gripper.raspberry_size", GripperStepper::serialize_raspberry_size(size));
+    this->interface->send_state(TelemetryKey::GRIPPER_RASPBERRY_SIZE, size);
 
-    // Detect ripeness using color sensor
-    bool is_ripe = this->gripper_controller->is_ripe();
-    this->interface->send_state("gripper.raspberry_ripeness", is_ripe ? "RIPE" : "UNRIPE");
+    // Start measuring the color without blocking
+    PHASE_PROFILER_BEGIN(sense_start);
+    this->gripper_controller->begin_ripeness();
 
-    if (!is_ripe)
-    {
-        this->gripper_controller->set_gripper(GripperStepper::GripperState::OPEN);
-        return;
-    }
-
-    // Set sorting mechanism to appropriate position
+    // Set sorting mechanism to appropriate position while the color is measured
     // For unknown size: assume small (reached limit switch without detecting raspberry)
+    PHASE_PROFILER_BEGIN(sort_start);
     switch (size)
     {
     case GripperStepper::RaspberrySize::LARGE:
@@ -303,23 +337,48 @@ void Controller::run_pgm1()
         this->basket_controller->set_sorting(BasketSorter::SortingState::SMALL);
         break;
     }
+    PHASE_PROFILER_END(this->profiler, sort_start, SORT);
+
+    // Detect ripeness using color sensor, keeping the plate motion and the telemetry going meanwhile
+    bool is_ripe;
+    while (!this->gripper_controller->poll_ripeness(&is_ripe))
+    {
+        this->gripper_controller->tick();
+        this->interface->flush();
+    }
+    PHASE_PROFILER_END(this->profiler, sense_start, SENSE_COLOR);
+    this->interface->send_state(TelemetryKey::GRIPPER_RASPBERRY_RIPENESS, is_ripe ? ColorSensor::Ripeness::RIPE : ColorSensor::Ripeness::UNRIPE);
+
+    if (!is_ripe)
+    {
+        this->basket_controller->set_sorting(BasketSorter::SortingState::IDLE);
+        PHASE_PROFILER_BEGIN(reopen_start);
+        this->gripper_controller->set_gripper(GripperStepper::GripperState::OPEN);
+        PHASE_PROFILER_END(this->profiler, reopen_start, REOPEN);
+        return;
+    }
 
     // Wait for user to pick the raspberry
     // Exit when pressure plate loses contact or timeout reached
     // For UNKNOWN size, skip pressure monitoring (never detected contact)
+    PHASE_PROFILER_BEGIN(wait_start);
     int delayed_time_ms = 0;
     bool berry_is_touching = true;
     do {
         if (size != GripperStepper::RaspberrySize::UNKNOWN){
             berry_is_touching = this->gripper_controller->limit_switch_pressure->is_touching();
         }
+        this->interface->flush();
         delay(100);
         delayed_time_ms+=100;
 
-    } while (delayed_time_ms < GripperController::picking_delay_ms && berry_is_touching);
+    } while (delayed_time_ms < Config::values.gripper_picking_delay_ms && berry_is_touching);
+    PHASE_PROFILER_END(this->profiler, wait_start, WAIT_FOR_PICK);
 
     // Complete the cycle: open gripper, increment counter, reset sorting
+    PHASE_PROFILER_BEGIN(reopen_start);
     this->gripper_controller->set_gripper(GripperStepper::GripperState::OPEN);
+    PHASE_PROFILER_END(this->profiler, reopen_start, REOPEN);
     this->basket_controller->increment_counter();
     this->basket_controller->set_sorting(BasketSorter::SortingState::IDLE);
 }
@@ -333,113 +392,9 @@ void Controller::run_pgm2()
 {
     this->basket_controller->set_door(BasketDoor::DoorState::OPEN);
     this->basket_controller->reset_counter(false);
-    delay(BasketDoor::delay_ms);
+    PHASE_PROFILER_BEGIN(dwell_start);
+    delay(Config::values.basket_door_delay_ms);
+    PHASE_PROFILER_END(this->profiler, dwell_start, DOOR_DWELL);
     this->basket_controller->set_door(BasketDoor::DoorState::CLOSED);
 }
 
-/**
- * Converts program enum to string representation.
- * @param program Program enum value
- * @return String name of the program
- */
-const char *Controller::serialize_program(Program program)
-{
-    int idx = static_cast<int>(program);
-
-    const char *program_strings[] = {
-        "CLOSE_GRIPPER",
-        "RELEASE_GRIPPER",
-        "EMPTY_BASKET",
-        "RESET",
-        "MEASURE_COLOR",
-        "PROGRAM_1",
-        "PROGRAM_2",
-    };
-    return program_strings[idx];
-}
-/**
- * Converts string to program enum.
- * @param program String representation of program
- * @param out_program Pointer to store resulting Program enum
- * @return true if string matched a valid program, false otherwise
- */
-bool Controller::deserialize_program(String program, Controller::Program *out_program)
-{
-    bool matched = true;
-    if (program == "CLOSE_GRIPPER")
-    {
-        *out_program = Controller::Program::CLOSE_GRIPPER;
-    }
-    else if (program == "RELEASE_GRIPPER")
-    {
-        *out_program = Controller::Program::RELEASE_GRIPPER;
-    }
-    else if (program == "EMPTY_BASKET")
-    {
-        *out_program = Controller::Program::EMPTY_BASKET;
-    }
-    else if (program == "RESET")
-    {
-        *out_program = Controller::Program::RESET;
-    }
-    else if (program == "MEASURE_COLOR")
-    {
-        *out_program = Controller::Program::MEASURE_COLOR;
-    }
-    else if (program == "PROGRAM_1")
-    {
-        *out_program = Controller::Program::PROGRAM_1;
-    }
-    else if (program == "PROGRAM_2")
-    {
-        *out_program = Controller::Program::PROGRAM_2;
-    }
-    else
-    {
-        matched = false;
-    }
-    return matched;
-}
-
-/**
- * Converts state enum to string representation.
- * @param state State enum value
- * @return String name of the state
- */
-const char *Controller::serialize_state(State state)
-{
-    int idx = static_cast<int>(state);
-    const char *state_strings[3] = {
-        "MANUAL",
-        "IDLE",
-        "PROGRAM"};
-    return state_strings[idx];
-}
-
-/**
- * Converts string to state enum.
- * @param state String representation of state
- * @param out_state Pointer to store resulting State enum
- * @return true if string matched a valid state, false otherwise
- */
-bool Controller::deserialize_state(String state, Controller::State *out_state)
-{
-    bool matched = true;
-    if (state == "MANUAL")
-    {
-        *out_state = Controller::State::MANUAL;
-    }
-    else if (state == "IDLE")
-    {
-        *out_state = Controller::State::IDLE;
-    }
-    else if (state == "PROGRAM")
-    {
-        *out_state = Controller::State::PROGRAM;
-    }
-    else
-    {
-        matched = false;
-    }
-    return matched;
-}
@@ -11,6 +11,26 @@
 
 #include <Arduino.h>
 
+#include "Interface/EnumReflection.h"
+#include "Interface/PhaseProfiler.h"
+#include "Interface/StateJournal.h"
+
+// Values of Controller::State
+#define RASPBERRY_PICKER_CONTROLLER_STATES(X) \
+    X(MANUAL) \
+    X(IDLE) \
+    X(PROGRAM)
+
+// Values of Controller::Program
+#define RASPBERRY_PICKER_PROGRAMS(X) \
+    X(CLOSE_GRIPPER) \
+    X(RELEASE_GRIPPER) \
+    X(EMPTY_BASKET) \
+    X(RESET) \
+    X(MEASURE_COLOR) \
+    X(PROGRAM_1) \
+    X(PROGRAM_2)
+
 class BasketController;
 class GripperController;
 class InterfaceMaster;
@@ -30,9 +50,7 @@ public:
      */
     enum State
     {
-        MANUAL,
-        IDLE,
-        PROGRAM,
+        RASPBERRY_PICKER_CONTROLLER_STATES(ENUM_REFLECTION_VALUE)
     };
 
     /**
@@ -47,35 +65,9 @@ public:
      */
     enum Program
     {
-        CLOSE_GRIPPER,
-        RELEASE_GRIPPER,
-        EMPTY_BASKET,
-        RESET,
-        MEASURE_COLOR,
-        PROGRAM_1,
-        PROGRAM_2,
+        RASPBERRY_PICKER_PROGRAMS(ENUM_REFLECTION_VALUE)
     };
 
-    /**
-     * Converts program enum to string representation.
-     */
-    const char *serialize_program(Program program);
-    
-    /**
-     * Converts string to program enum.
-     */
-    bool deserialize_program(String program, Program *out_program);
-    
-    /**
-     * Converts state enum to string representation.
-     */
-    const char *serialize_state(State state);
-    
-    /**
-     * Converts string to state enum.
-     */
-    bool deserialize_state(String state, State *out_state);
-
     /**
      * Constructor - creates controller with specified initial state.
      */
@@ -120,6 +112,18 @@ public:
      * Adds reference to interface master for communication.
      */
     void add_interface(InterfaceMaster *interface);
+    /**
+     * Restores the state journaled before the last power loss, see StateJournal.h.
+     * Call once during setup, after add_controllers().
+     * @return COLD, WARM if homing can be skipped, or DIRTY
+     */
+    StateJournal::Status resume();
+
+    /**
+     * Journals the current state if it changed. Call only while the plate stands still.
+     */
+    void save_state();
+
     /**
      * Program CLOSE:
      * Used to close the grabbing mechanism
@@ -151,6 +155,7 @@ public:
     /**
      * Program RESET:
      * Used to reset the system
+     * - homes the grabbing mechanism on the zero limit switch, unless resumed warm
      * - sets sorter to central position (IDLE)
      * - moves grabbing mechanism to the open state
      * - closes the doors of the basket (CLOSED)
@@ -183,6 +188,14 @@ public:
     GripperController *gripper_controller;   // Pointer to gripper controller
     BasketController *basket_controller;     // Pointer to basket controller
     InterfaceMaster *interface;              // Pointer to interface master
+    bool plate_position_trusted;             // Whether the plate position was resumed warm and needs no homing
+
+#ifdef RASPBERRY_PICKER_PROFILE
+    PhaseProfiler profiler;                  // Durations of the phases of the programs
+#endif
 };
 
+ENUM_REFLECTION_DECLARE(Controller::State)
+ENUM_REFLECTION_DECLARE(Controller::Program)
+
 #endif
@@ -8,6 +8,12 @@
 
 #include <Arduino.h>
 #include "ColorSensor.h"
+#include "../Interface/Config.h"
+#include "RipenessModelData.h"
+
+using namespace ripeness_model_data;
+
+ENUM_REFLECTION_DEFINE(ColorSensor::Ripeness, RASPBERRY_PICKER_RIPENESS, ripeness_names)
 
 /**
  * Constructor - initializes color sensor with pin configuration.
@@ -24,63 +30,263 @@ ColorSensor::ColorSensor(ColorSensor::Pinout pinout)
 
     // Configure LDR pin as input
     pinMode(pinout.ldr, INPUT);
+
+    this->phase = MeasurementPhase::IDLE;
 }
 
 /**
  * Measures raw RGB color values and ambient light.
+ * Blocking wrapper around begin_measurement()/poll()/result().
  * 
  * Process:
  * 1. Turns on each LED color (R, G, B) sequentially
- * 2. Takes multiple LDR readings and averages them
- * 3. Also measures ambient light (no LED)
+ * 2. Waits until the LDR reading has settled
+ * 3. Takes multiple LDR readings and averages them
+ * 4. Also measures ambient light (no LED)
  * 
  * @return RAW_RGB structure with red, green, blue, and noise (ambient) values
  */
 RAW_RGB ColorSensor::measure_rgb_raw()
 {
-    int led_pins[] = {
-        this->pinout.led_r,
-        this->pinout.led_g,
-        this->pinout.led_b,
-        0 // Special case: measure ambient light with no LED on
-    };
-    float raw_measurement[] = {0, 0, 0, 0};
+    this->begin_measurement();
+    while (!this->poll())
+    {
+    }
+    return this->result();
+}
 
-    // Measure each color channel plus ambient light
-    for (int color_index = 0; color_index < 4; color_index++)
+/**
+ * Starts a non-blocking measurement of all color channels plus ambient light.
+ * Turns on the first LED; the measurement is advanced by poll().
+ */
+void ColorSensor::begin_measurement()
+{
+    this->sequential = false;
+    this->reset_measurement();
+}
+
+/**
+ * Starts a non-blocking sequential ripeness decision.
+ * Channels are measured one sample at a time in order of their information content;
+ * after every sample the running estimate is updated and the measurement stops
+ * as soon as the decision is confidently beyond sequential_margin.
+ * @param width Width of the raspberry [mm]
+ */
+void ColorSensor::begin_decision(int width)
+{
+    this->sequential = true;
+    this->decision_width = width;
+    this->decision_p_ripe_q = 1U << (ripeness_model_data::p_shift - 1);
+    this->reset_measurement();
+}
+
+/**
+ * Advances the running measurement without blocking.
+ * Switches LEDs and takes LDR samples once their deadlines have passed.
+ * @return true once the measurement is complete and result() is valid
+ */
+bool ColorSensor::poll()
+{
+    switch (this->phase)
+    {
+    case MeasurementPhase::IDLE:
+        return false;
+    case MeasurementPhase::DONE:
+        return true;
+    case MeasurementPhase::SETTLING:
+    case MeasurementPhase::SAMPLING:
+        break;
+    }
+
+    // Wait until the next deadline (overflow-safe comparison)
+    if ((long)(millis() - this->deadline_ms) < 0)
+    {
+        return false;
+    }
+
+    if (this->phase == MeasurementPhase::SETTLING)
     {
-        long long int measurement = 0;
+        // Probe the LDR until the reading stops changing or the settle budget is used up
+        int reading = analogRead(this->pinout.ldr);
+        unsigned long elapsed_ms = millis() - this->channel_started_ms;
+        if (this->settle_reading >= 0 && abs(reading - this->settle_reading) <= Config::values.color_settle_threshold)
+        {
+            this->settle_stable++;
+        }
+        else
+        {
+            this->settle_stable = 0;
+        }
+        this->settle_reading = reading;
+
+        if (this->settle_stable < Config::values.color_settle_stable_count && elapsed_ms < (unsigned long)Config::values.color_delay_color)
+        {
+            this->deadline_ms = millis() + Config::values.color_settle_probe_ms;
+            return false;
+        }
+
+        // LED has settled - start sampling
+        this->settle_ms[this->channel] = elapsed_ms;
+        this->phase = MeasurementPhase::SAMPLING;
+    }
 
-        // Turn on LED if pin is specified (skip for ambient measurement)
-        if (led_pins[color_index] > 0)
-            digitalWrite(led_pins[color_index], HIGH);
-        delay(ColorSensor::delay_color);
+    // Take one sample and schedule the next one
+    long sample = analogRead(this->pinout.ldr);
+    this->channel_sum[this->channel] += sample;
+    this->channel_sum_sq[this->channel] += sample * sample;
+    this->channel_samples[this->channel]++;
+    this->deadline_ms = millis() + Config::values.color_delay_probe;
 
-        // Take multiple measurements and average for accuracy
-        for (int i = 0; i < ColorSensor::measure_count; i++)
+    bool channel_done = this->channel_samples[this->channel] >= ColorSensor::measure_count;
+    if (this->sequential && this->channel_samples[this->channel] >= ColorSensor::sequential_min_samples)
+    {
+        if (this->update_decision())
         {
-            measurement += analogRead(this->pinout.ldr);
-            delay(ColorSensor::delay_probe);
+            // Confident decision - skip the remaining samples and channels
+            this->finish_channel();
+            this->phase = MeasurementPhase::DONE;
+            return true;
         }
+        // Move on early if more samples of this channel would not improve the estimate
+        channel_done = channel_done || this->channel_noise_var(this->channel_step) < ColorSensor::sequential_noise_var;
+    }
 
-        // Turn off LED
-        if (led_pins[color_index] > 0)
-            digitalWrite(led_pins[color_index], LOW);
+    if (!channel_done)
+    {
+        return false;
+    }
 
-        raw_measurement[color_index] = measurement / (float)ColorSensor::measure_count;
+    this->finish_channel();
+
+    if (this->channel_step + 1 < 4)
+    {
+        this->start_channel(this->channel_step + 1);
+        return false;
     }
 
+    this->phase = MeasurementPhase::DONE;
+    return true;
+}
+
+/**
+ * Gets the result of the last completed measurement.
+ * @return RAW_RGB structure with red, green, blue, and noise (ambient) values
+ */
+RAW_RGB ColorSensor::result()
+{
     // Package measurements into RAW_RGB structure
     RAW_RGB out_rgb{
-        .r = raw_measurement[0],
-        .g = raw_measurement[1],
-        .b = raw_measurement[2],
-        .noise = raw_measurement[3],  // Ambient light reading
+        .r = this->raw_measurement[0],
+        .g = this->raw_measurement[1],
+        .b = this->raw_measurement[2],
+        .noise = this->raw_measurement[3], // Ambient light reading
     };
 
     return out_rgb;
 }
 
+/**
+ * Gets the ripeness probability decided by the last sequential decision.
+ * @return Probability that the raspberry is ripe [2^-RipenessModels::p_shift]
+ */
+uint16_t ColorSensor::get_decision_p_q()
+{
+    return this->decision_p_ripe_q;
+}
+
+/**
+ * Gets the number of LDR samples taken by the last measurement.
+ * @return Total number of samples over all channels
+ */
+int ColorSensor::get_samples_used()
+{
+    int samples = 0;
+    for (int color_index = 0; color_index < 4; color_index++)
+    {
+        samples += this->channel_samples[color_index];
+    }
+    return samples;
+}
+
+/**
+ * Gets the time the LDR needed to settle for a channel in the last measurement.
+ * @param color_index Channel index (0=red, 1=green, 2=blue, 3=ambient)
+ * @return Settle time [ms], 0 if the channel was not measured
+ */
+int ColorSensor::get_settle_ms(int color_index)
+{
+    return this->settle_ms[color_index];
+}
+
+/**
+ * Gets the LED pin used for a channel.
+ * @param color_index Channel index (0=red, 1=green, 2=blue, 3=ambient)
+ * @return LED pin, or 0 for the ambient channel (no LED on)
+ */
+int ColorSensor::get_led_pin(int color_index)
+{
+    switch (color_index)
+    {
+    case 0:
+        return this->pinout.led_r;
+    case 1:
+        return this->pinout.led_g;
+    case 2:
+        return this->pinout.led_b;
+    default:
+        return 0; // Special case: measure ambient light with no LED on
+    }
+}
+
+/**
+ * Clears all channel accumulators and starts with the first channel.
+ */
+void ColorSensor::reset_measurement()
+{
+    for (int color_index = 0; color_index < 4; color_index++)
+    {
+        this->raw_measurement[color_index] = 0;
+        this->channel_sum[color_index] = 0;
+        this->channel_sum_sq[color_index] = 0;
+        this->channel_samples[color_index] = 0;
+        this->settle_ms[color_index] = 0;
+    }
+    this->start_channel(0);
+}
+
+/**
+ * Turns on the LED of a channel and waits for it to settle before sampling.
+ * @param channel_step Position in the measurement order (sequential order in decision mode)
+ */
+void ColorSensor::start_channel(int channel_step)
+{
+    this->channel_step = channel_step;
+    this->channel = this->sequential ? pgm_read_byte(&sequential_order[channel_step]) : channel_step;
+
+    // Turn on LED if pin is specified (skip for ambient measurement)
+    int led_pin = this->get_led_pin(this->channel);
+    if (led_pin > 0)
+        digitalWrite(led_pin, HIGH);
+
+    // Probe the LDR until it has settled (at most delay_color)
+    this->phase = MeasurementPhase::SETTLING;
+    this->settle_reading = -1;
+    this->settle_stable = 0;
+    this->channel_started_ms = millis();
+    this->deadline_ms = this->channel_started_ms + Config::values.color_settle_probe_ms;
+}
+
+/**
+ * Turns off the LED of the current channel and stores its average.
+ */
+void ColorSensor::finish_channel()
+{
+    int led_pin = this->get_led_pin(this->channel);
+    if (led_pin > 0)
+        digitalWrite(led_pin, LOW);
+    this->raw_measurement[this->channel] = this->channel_sum[this->channel] / (float)this->channel_samples[this->channel];
+}
+
 /**
  * Sigmoid activation function for logistic regression.
  * Maps input to range [0, 1].
@@ -92,12 +298,8 @@ float sigmoid(float x)
     return 0.5f * (x / (1.0f + fabsf(x)) + 1.0f);
 }
 
-// Logistic regression model parameters for ripeness classification
-// These were trained on actual raspberry color data
-const float logistic_regression_w[] = {-4.50230706, 11.26159486, 3.55473385, -6.83999956, -0.52119049};  // Feature weights
-const float logistic_regression_b = -0.2995281290741155;  // Bias term
-const float logistic_regression_mean[] = {648.86074332, 440.45632985, 412.50301974, 353.28095238, 25.94192799};  // Feature means for normalization
-const float logistic_regression_std[] = {117.48639278, 171.45333209, 172.45127903, 181.21577300, 4.11776362};  // Feature std devs for normalization
+// The model parameters (logistic_regression_*) are generated into RipenessModelData.h
+// by data/classifier/export.py from data_labeled_ambient_width.csv
 
 /**
  * Calculates the probability that a raspberry is ripe using logistic regression.
@@ -113,21 +315,16 @@ const float logistic_regression_std[] = {117.48639278, 171.45333209, 172.4512790
  */
 float ColorSensor::get_ripenesses_p(RAW_RGB rgb_raw, int width)
 {
-    // Normalize features using z-score normalization
-    float X0 = (rgb_raw.r - (logistic_regression_mean[0])) / (logistic_regression_std[0]);
-    float X1 = (rgb_raw.g - (logistic_regression_mean[1])) / (logistic_regression_std[1]);
-    float X2 = (rgb_raw.b - (logistic_regression_mean[2])) / (logistic_regression_std[2]);
-    float X3 = (rgb_raw.noise - (logistic_regression_mean[3])) / (logistic_regression_std[3]);
-    float X4 = (width - (logistic_regression_mean[4])) / (logistic_regression_std[4]);
+    // Normalize features using z-score normalization (the model is stored in flash)
+    float features[5] = {rgb_raw.r, rgb_raw.g, rgb_raw.b, rgb_raw.noise, (float)width};
 
     // Calculate weighted sum (linear combination)
-    float z =
-        logistic_regression_w[0] * X0 +
-        logistic_regression_w[1] * X1 +
-        logistic_regression_w[2] * X2 +
-        logistic_regression_w[3] * X3 +
-        logistic_regression_w[4] * X4 +
-        logistic_regression_b;
+    float z = pgm_read_float(&logistic_regression_b);
+    for (int i = 0; i < 5; i++)
+    {
+        float x = (features[i] - pgm_read_float(&logistic_regression_mean[i])) / pgm_read_float(&logistic_regression_std[i]);
+        z += pgm_read_float(&logistic_regression_w[i]) * x;
+    }
 
     // Apply sigmoid to get probability
     // Label map: 0=ripe, 1=unripe (model predicts unripe)
@@ -137,4 +334,109 @@ float ColorSensor::get_ripenesses_p(RAW_RGB rgb_raw, int width)
     float p_hat_ripe = 1 - p_hat_unripe;
 
     return p_hat_ripe;
-}
\ No newline at end of file
+}
+
+/**
+ * Gets the ADC sums of the last completed measurement.
+ * @param channel_sums Output, sums of the samples per channel (r, g, b, ambient)
+ */
+void ColorSensor::result_sums(int16_t channel_sums[4])
+{
+    for (int color_index = 0; color_index < 4; color_index++)
+    {
+        channel_sums[color_index] = this->channel_sum[color_index];
+    }
+}
+
+// Fixed-point partial models for the sequential decision (sequential_*), one per number of measured channels,
+// are generated into RipenessModelData.h together with the models above, see export.py
+
+/**
+ * Calculates the integer square root.
+ * @param x Radicand
+ * @return Largest integer whose square is at most x
+ */
+static uint16_t isqrt(uint32_t x)
+{
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+    while (bit > x)
+    {
+        bit >>= 2;
+    }
+    while (bit != 0)
+    {
+        if (x >= root + bit)
+        {
+            x -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+/**
+ * Gets the variance of the linear model output caused by sampling noise of one channel.
+ * @param channel_step Position of the channel in the sequential order
+ * @return Variance of z contributed by the standard error of the channel mean [2^-sequential_var_shift]
+ */
+uint32_t ColorSensor::channel_noise_var(int channel_step)
+{
+    int color_index = pgm_read_byte(&sequential_order[channel_step]);
+    long n = this->channel_samples[color_index];
+    if (n < 2)
+    {
+        return 0;
+    }
+    // n * sum_sq - sum^2 = n (n - 1) var, at most 26e6 for 10 samples of a 10 bit ADC
+    uint32_t spread = n * this->channel_sum_sq[color_index] - this->channel_sum[color_index] * this->channel_sum[color_index];
+    uint32_t var = (spread << 4) / (n * (n - 1)); // [counts², 2^-4]
+    if (var < ColorSensor::sequential_min_var)
+    {
+        var = ColorSensor::sequential_min_var; // ADC quantization floor
+    }
+    if (var > 0xFFFF)
+    {
+        var = 0xFFFF; // Keeps the product below in 32 bit, far beyond any confident decision
+    }
+    uint32_t weight = pgm_read_word(&sequential_noise_w[this->channel_step][color_index]);
+    return ((weight * var) >> (sequential_noise_shift + 4 - sequential_var_shift)) / n;
+}
+
+/**
+ * Updates the running ripeness estimate from the samples taken so far.
+ * Uses the partial model for the channels measured up to now and checks whether
+ * the confidence interval of the model output lies beyond the decision margin.
+ * @return true if the decision is confident and sampling can stop
+ */
+bool ColorSensor::update_decision()
+{
+    int step = this->channel_step;
+    int32_t z = (int32_t)pgm_read_dword(&sequential_q_b[step]);
+    uint32_t var = pgm_read_dword(&sequential_q_var[step]);
+
+    for (int i = 0; i <= step; i++)
+    {
+        int color_index = pgm_read_byte(&sequential_order[i]);
+        int n = this->channel_samples[color_index];
+        // Scale the sum to the sample_count samples the models are made for
+        int16_t sum = (this->channel_sum[color_index] * sample_count + n / 2) / n;
+        z += (int32_t)pgm_read_dword(&sequential_q_w[step][color_index]) * sum;
+        var += this->channel_noise_var(i);
+    }
+    z += (int32_t)pgm_read_dword(&sequential_q_w[step][4]) * (int16_t)(this->decision_width * sample_count);
+
+    this->decision_p_ripe_q = RipenessModels::LogisticRegression::get_p_ripe_q(z);
+
+    // The standard deviation has half the fraction bits of the variance
+    int32_t deviation = ((int32_t)ColorSensor::sequential_confidence * isqrt(var)) << (logistic_regression_q_shift - sequential_var_shift / 2);
+    uint16_t p_ripe_low = RipenessModels::LogisticRegression::get_p_ripe_q(z + deviation);
+    uint16_t p_ripe_high = RipenessModels::LogisticRegression::get_p_ripe_q(z - deviation);
+    uint16_t half = 1U << (ripeness_model_data::p_shift - 1);
+    return p_ripe_low > half + ColorSensor::sequential_margin || p_ripe_high < half - ColorSensor::sequential_margin;
+}
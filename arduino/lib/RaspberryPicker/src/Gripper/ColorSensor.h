@@ -3,12 +3,43 @@
  * 
  * RGB color sensor interface using LDR (Light Dependent Resistor) and RGB LEDs.
  * Measures color by illuminating object with R, G, B LEDs separately and reading reflected light.
- * Includes logistic regression model for raspberry ripeness detection based on color and size.
+ * Includes logistic regression model for raspberry ripeness detection based on color and size,
+ * and evaluates the fixed-point models of RipenessModels.h on the measurement.
  */
 
 #ifndef RASPBERRY_PICKER_GRIPPER_COLOR_SENSOR_H
 #define RASPBERRY_PICKER_GRIPPER_COLOR_SENSOR_H
 
+#include <Arduino.h>
+
+#include "../Interface/EnumReflection.h"
+#include "RipenessModels.h"
+
+// Ripeness model of the firmware, see RipenessModels.h.
+// The sequential decision only exists for the logistic regression: selecting another model,
+// or RASPBERRY_PICKER_RIPENESS_FULL_MEASUREMENT, measures every channel and lets RipenessModel decide.
+#if defined(RASPBERRY_PICKER_RIPENESS_TREE)
+typedef RipenessModels::DecisionTree RipenessModel;
+#elif defined(RASPBERRY_PICKER_RIPENESS_FOREST)
+typedef RipenessModels::DecisionForest RipenessModel;
+#elif defined(RASPBERRY_PICKER_RIPENESS_PCA)
+typedef RipenessModels::PrincipalComponent RipenessModel;
+#else
+typedef RipenessModels::LogisticRegression RipenessModel;
+#endif
+
+#if defined(RASPBERRY_PICKER_RIPENESS_TREE) || defined(RASPBERRY_PICKER_RIPENESS_FOREST) || \
+    defined(RASPBERRY_PICKER_RIPENESS_PCA) || defined(RASPBERRY_PICKER_RIPENESS_FULL_MEASUREMENT)
+#define RASPBERRY_PICKER_RIPENESS_SEQUENTIAL false
+#else
+#define RASPBERRY_PICKER_RIPENESS_SEQUENTIAL true
+#endif
+
+// Values of ColorSensor::Ripeness
+#define RASPBERRY_PICKER_RIPENESS(X) \
+    X(RIPE) \
+    X(UNRIPE)
+
 /**
  * RAW_RGB structure - raw color measurements including ambient light.
  * r: Red channel reading
@@ -46,9 +77,40 @@ public:
         int ldr;
     };
 
-    static const int measure_count; // Number of measurements to average per color
-    static const int delay_probe;   // Delay between individual measurements [ms]
-    static const int delay_color;   // Delay after LED activation before measurement [ms]
+    /**
+     * Ripeness enum - classification result reported to the host.
+     * RIPE: Raspberry can be picked
+     * UNRIPE: Raspberry is released again
+     */
+    enum class Ripeness
+    {
+        RASPBERRY_PICKER_RIPENESS(ENUM_REFLECTION_VALUE)
+    };
+
+    /**
+     * MeasurementPhase enum - progress of a non-blocking measurement.
+     * IDLE: No measurement started
+     * SETTLING: LED switched on, probing the LDR until its reading is stable
+     * SAMPLING: Taking LDR samples for the current channel
+     * DONE: All channels measured, result is available
+     */
+    enum class MeasurementPhase
+    {
+        IDLE,
+        SETTLING,
+        SAMPLING,
+        DONE,
+    };
+
+    static const int measure_count; // Number of measurements to average per color, fixed by the ripeness models
+    // Sampling and settle timing are configuration values, see Interface/Config.h
+
+    static const bool sequential_decision;     // Use the sequential early-stopping decision for ripeness, see RASPBERRY_PICKER_RIPENESS_SEQUENTIAL
+    static const int sequential_min_samples;   // Samples per channel before the decision is evaluated
+    static const uint16_t sequential_margin;   // Required distance of the probability from 0.5 [2^-RipenessModels::p_shift]
+    static const uint8_t sequential_confidence; // Width of the confidence interval [standard deviations]
+    static const uint32_t sequential_noise_var; // Channel noise variance of z below which the next channel is measured [2^-16]
+    static const uint16_t sequential_min_var;  // Lower bound for the sample variance (ADC quantization) [counts², 2^-4]
 
     /**
      * Constructor - initializes the color sensor with pin configuration.
@@ -63,6 +125,51 @@ public:
      * @return RAW_RGB structure with color and ambient measurements
      */
     RAW_RGB measure_rgb_raw();
+
+    /**
+     * Starts a non-blocking measurement of all channels.
+     * Call poll() until it returns true, then read the values with result().
+     */
+    void begin_measurement();
+
+    /**
+     * Advances the running measurement against millis() deadlines.
+     * @return true once the measurement is complete
+     */
+    bool poll();
+
+    /**
+     * Gets the values of the last completed measurement.
+     * @return RAW_RGB structure with color and ambient measurements
+     */
+    RAW_RGB result();
+
+    /**
+     * Starts a non-blocking sequential ripeness decision.
+     * Samples are taken one at a time and the measurement stops as soon as
+     * the ripeness probability is confidently beyond sequential_margin.
+     * Call poll() until it returns true, then read get_decision_p_q().
+     * @param width Width of the raspberry [mm]
+     */
+    void begin_decision(int width);
+
+    /**
+     * Gets the ripeness probability of the last sequential decision.
+     * @return Probability that raspberry is ripe [2^-RipenessModels::p_shift]
+     */
+    uint16_t get_decision_p_q();
+
+    /**
+     * Gets the number of LDR samples taken by the last measurement.
+     */
+    int get_samples_used();
+
+    /**
+     * Gets the time the LDR needed to settle for a channel in the last measurement.
+     * @param color_index Channel index (0=red, 1=green, 2=blue, 3=ambient)
+     * @return Settle time [ms]
+     */
+    int get_settle_ms(int color_index);
     
     /**
      * Calculates the probability that a raspberry is ripe using logistic regression.
@@ -73,8 +180,78 @@ public:
      */
     float get_ripenesses_p(RAW_RGB rgb_raw, int width);
 
+    /**
+     * Gets the ADC sums of the last completed measurement.
+     * @param channel_sums Output, sums of the samples per channel (r, g, b, ambient)
+     */
+    void result_sums(int16_t channel_sums[4]);
+
+    /**
+     * Calculates the ripeness probability of the last completed measurement with a fixed-point model.
+     * The model is selected at compile time, the firmware uses RipenessModel. Its coefficients are
+     * generated by data/classifier/export.py and assume sums of measure_count = 10 samples.
+     * @tparam Model Model from RipenessModels.h
+     * @param width Width of the raspberry [mm]
+     * @return Probability that raspberry is ripe [2^-RipenessModels::p_shift]
+     */
+    template <class Model = RipenessModel>
+    uint16_t get_ripeness_p_q(int width)
+    {
+        int16_t channel_sums[4];
+        this->result_sums(channel_sums);
+        return Model::get_p_ripe_q(channel_sums, width);
+    }
+
 private:
+    /**
+     * Gets the LED pin for a channel (0 for ambient).
+     */
+    int get_led_pin(int color_index);
+
+    /**
+     * Clears the channel accumulators and starts with the first channel.
+     */
+    void reset_measurement();
+
+    /**
+     * Switches on the LED of a channel and schedules its settle deadline.
+     */
+    void start_channel(int channel_step);
+
+    /**
+     * Switches off the LED of the current channel and stores its average.
+     */
+    void finish_channel();
+
+    /**
+     * Gets the variance of the model output caused by sampling noise of a channel.
+     */
+    uint32_t channel_noise_var(int channel_step);
+
+    /**
+     * Updates the running ripeness estimate and checks whether it is confident.
+     */
+    bool update_decision();
+
     Pinout pinout;  // Pin configuration for LEDs and LDR
+
+    MeasurementPhase phase;        // Progress of the running measurement
+    bool sequential;               // Whether a sequential decision is running
+    int channel_step;              // Position of the current channel in the measurement order
+    int channel;                   // Channel being measured (0=r, 1=g, 2=b, 3=ambient)
+    unsigned long deadline_ms;     // Time of the next LED/sample action [ms]
+    unsigned long channel_started_ms; // Time the LED of the current channel was switched [ms]
+    int settle_reading;            // Previous LDR probe while settling (-1 if none)
+    int settle_stable;             // Consecutive stable probes while settling
+    int settle_ms[4];              // Settle time per channel [ms]
+    long channel_sum[4];           // Sum of samples per channel
+    long channel_sum_sq[4];        // Sum of squared samples per channel
+    int channel_samples[4];        // Samples taken per channel
+    float raw_measurement[4];      // Averaged values per channel
+    int decision_width;            // Raspberry width used by the sequential decision [mm]
+    uint16_t decision_p_ripe_q;    // Ripeness probability of the sequential decision [2^-RipenessModels::p_shift]
 };
 
+ENUM_REFLECTION_DECLARE(ColorSensor::Ripeness)
+
 #endif
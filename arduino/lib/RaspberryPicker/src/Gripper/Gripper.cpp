@@ -14,31 +14,41 @@
 
 #include "../InterfaceMaster.h"
 #include "../Basket/Basket.h"
+#include "../Interface/Config.h"
+#include "../Interface/StateJournal.h"
 
 #include "Gripper.h"
 #include "ColorSensor.h"
 #include "GripperStepper.h"
 #include "LimitSwitch.h"
 
-// Color sensor timing constants
+// Color sensor constants
 const int ColorSensor::measure_count = 10;     // Number of samples per measurement
-const int ColorSensor::delay_probe = 10;       // Delay between samples (ms)
-const int ColorSensor::delay_color = 200;      // Delay after LED activation (ms)
+
+// Sequential ripeness decision constants
+const bool ColorSensor::sequential_decision = RASPBERRY_PICKER_RIPENESS_SEQUENTIAL; // Stop sampling as soon as the decision is confident
+const int ColorSensor::sequential_min_samples = 3;    // Samples per channel before evaluating the decision
+const uint16_t ColorSensor::sequential_margin = 0.3 * (1U << 15); // Decide once p_ripe is confidently above 0.8 or below 0.2
+const uint8_t ColorSensor::sequential_confidence = 2;            // Confidence interval width (standard deviations)
+const uint32_t ColorSensor::sequential_noise_var = 0.01 * (1UL << 16); // Channel noise contribution considered negligible
+const uint16_t ColorSensor::sequential_min_var = 0.25 * (1U << 4);  // Sample variance floor (ADC counts²)
 
 // Gripper stepper motor constants
 const float GripperStepper::transmission_ratio = 1.5 * 18 * PI;  // Gear ratio * diameter * pi (mm/rotation)
-const int GripperStepper::plate_distance_open = 65;              // Fully open position (mm)
-const int GripperStepper::plate_distance_large = 30;             // Position for large raspberry detection (mm)
-const int GripperStepper::plate_distance_small = 20;             // Position for small raspberry detection (mm)
-const int GripperStepper::plate_distance_limit = 13;             // Limit switch position (mm)
 const int GripperStepper::steps_per_revolution = 2048 * 2;       // Steps for one full rotation (half-step mode)
-const int GripperStepper::speed = 200;                           // Target speed (steps/sec)
-const int GripperStepper::max_speed = 1200;                      // Maximum speed (steps/sec)
-const int GripperStepper::acceleration = 300;                    // Acceleration rate (steps/sec²)
 
 // Gripper controller constants
-const int GripperController::berry_size_threshold_mm = 21;  // Threshold between small and large raspberries (mm)
-const int GripperController::picking_delay_ms = 10000;      // Maximum wait time for user to pick raspberry (ms)
+const unsigned long GripperController::switch_debounce_us = 2000; // Debounce time of the limit switch interrupts (us)
+
+/**
+ * Position source for the limit switches - reads the plate stepper position at contact.
+ * @param context Pointer to the plate stepper
+ * @return Current plate position [steps]
+ */
+static long read_plate_position(void *context)
+{
+    return static_cast<PlateStepper *>(context)->currentPosition();
+}
 
 /**
  * Constructor - initializes gripper controller with all sensors and motors.
@@ -49,6 +59,15 @@ GripperController::GripperController(GripperPinout *pinout, InterfaceMaster *int
 {
     this->interface = interface;
     this->gripper_state = GripperStepper::GripperState::OPEN;
+
+    // No motion running yet
+    this->motion_status = MotionStatus::IDLE;
+    this->motion_handle = 0;
+    this->motion_target = GripperStepper::GripperState::OPEN;
+    this->motion_result = GripperStepper::RaspberrySize::UNKNOWN;
+    this->motion_callback = nullptr;
+    this->homing_limit_position = 0;
+    this->homing_result = GripperStepper::HomingStatus::OK;
     
     // Initialize color sensor
     this->color_sensor = new ColorSensor(pinout->color_sensor_pinout);
@@ -58,215 +77,497 @@ GripperController::GripperController(GripperPinout *pinout, InterfaceMaster *int
     this->limit_switch_zero = new LimitSwitch(pinout->limit_switch_zero_pin);
     
     // Initialize plate distance
-    this->plate_distance = GripperStepper::plate_distance_open;
+    this->plate_distance = Config::values.gripper_plate_distance_open;
     
     // Initialize stepper motor with half-step 4-wire configuration
-    this->plate_stepper = new AccelStepper(
+    this->plate_stepper = new PlateStepper(
         AccelStepper::HALF4WIRE,
         pinout->stepper_motor_pins[0],
         pinout->stepper_motor_pins[2],
         pinout->stepper_motor_pins[1],
         pinout->stepper_motor_pins[3]);
 
+#ifdef RASPBERRY_PICKER_ISR_STEPPER
+    // Let the stepping interrupt stop the plate as soon as a switch fires while closing
+    this->plate_stepper->set_stop_pins(pinout->limit_switch_pressure_pin, pinout->limit_switch_zero_pin);
+#endif
+
+    // Latch switch contacts together with the plate position from interrupts where available.
+    // Only the interrupt-driven stepper reads its position atomically; the others step from the
+    // main loop, so an interrupt could split the update and the position is read when taking the contact
+#ifdef RASPBERRY_PICKER_ISR_STEPPER
+    bool position_interrupt_safe = true;
+#else
+    bool position_interrupt_safe = false;
+#endif
+    this->limit_switch_pressure->set_position_source(read_plate_position, this->plate_stepper, position_interrupt_safe);
+    this->limit_switch_zero->set_position_source(read_plate_position, this->plate_stepper, position_interrupt_safe);
+    this->limit_switch_pressure->enable_interrupt(GripperController::switch_debounce_us);
+    this->limit_switch_zero->enable_interrupt(GripperController::switch_debounce_us);
+
     // Configure stepper motor parameters
     this->plate_stepper->setCurrentPosition(
         GripperStepper::get_desired_step_position(GripperStepper::GripperState::OPEN));
-    this->plate_stepper->setSpeed(GripperStepper::speed);
-    this->plate_stepper->setMaxSpeed(GripperStepper::max_speed);
-    this->plate_stepper->setAcceleration(GripperStepper::acceleration);
+    this->apply_config();
+}
+
+/**
+ * Applies the configured speed, maximum speed and acceleration to the plate stepper.
+ * The acceleration profile is recomputed, a running motion continues with the new values.
+ */
+void GripperController::apply_config()
+{
+    this->plate_stepper->setSpeed(Config::values.gripper_speed);
+    this->plate_stepper->setMaxSpeed(Config::values.gripper_max_speed);
+    this->plate_stepper->setAcceleration(Config::values.gripper_acceleration);
+}
+
+/**
+ * Restores the plate position journaled before a power loss, without moving the plate.
+ * @param position Plate stepper position [steps]
+ * @param state Gripper state at that position
+ */
+void GripperController::restore(long position, GripperStepper::GripperState state)
+{
+    this->plate_stepper->setCurrentPosition(position);
+    this->plate_distance = GripperStepper::steps_to_mm(position);
+    this->gripper_state = state;
+    this->interface->send_state(TelemetryKey::GRIPPER_STATE, this->gripper_state);
+    this->interface->send_state(TelemetryKey::GRIPPER_PLATE_DISTANCE, this->plate_distance);
 }
 
 /**
  * Sets the gripper to the desired state and attempts to detect raspberry size.
+ * Blocking wrapper around start_gripper()/tick(): returns once the motion is done.
  * 
  * Behavior varies by desired state:
  * - OPEN: Fully opens gripper
- * - CLOSED_LIMIT: Closes until limit switch or pressure plate activated
+ * - CLOSED_LIMIT: Closes until limit switch or pressure plate activated, in one motion;
+ *   a raspberry is sized by the position at which it touches the pressure plate
  * - CLOSED_SMALL/LARGE: Closes to specific position, detecting raspberry if pressure plate activated
  * 
  * @param desired_gripper_state Target gripper state
  * @return Detected raspberry size (LARGE, SMALL, or UNKNOWN)
  */
 GripperStepper::RaspberrySize GripperController::set_gripper(GripperStepper::GripperState desired_gripper_state)
+{
+    this->start_gripper(desired_gripper_state, nullptr);
+    while (this->tick())
+    {
+    }
+    return this->motion_result;
+}
+
+/**
+ * Starts moving the gripper towards the desired state without blocking.
+ * The motion is advanced by calling tick() until it returns false.
+ * A motion that is still running is superseded by the new one.
+ * 
+ * @param desired_gripper_state Target gripper state
+ * @param callback Function called with the detected size once the motion is done (may be nullptr)
+ * @return Handle identifying this motion, used with get_result()
+ */
+GripperController::MotionHandle GripperController::start_gripper(GripperStepper::GripperState desired_gripper_state, MotionCallback callback)
 {
     int target_steps = GripperStepper::get_desired_step_position(desired_gripper_state);
-    this->plate_stepper->setSpeed(GripperStepper::speed);
-    switch (desired_gripper_state)
+
+    this->begin_motion(desired_gripper_state, callback);
+    this->motion_status = MotionStatus::RUNNING;
+
+    this->plate_stepper->setSpeed(Config::values.gripper_speed);
+    this->plate_stepper->moveTo(target_steps);
+
+    return this->motion_handle;
+}
+
+/**
+ * Finds the zero limit switch and recalibrates the plate position.
+ * Blocking wrapper around start_homing()/tick(): returns once the switch was found or given up on.
+ * @return Homing result
+ */
+GripperStepper::HomingStatus GripperController::home()
+{
+    this->start_homing(nullptr);
+    while (this->tick())
     {
-    case GripperStepper::GripperState::OPEN:
+    }
+    return this->homing_result;
+}
+
+/**
+ * Starts finding the zero limit switch without blocking.
+ * The plate closes with the usual speed profile towards a target beyond the expected zero,
+ * so a contact at speed does not decelerate first. It then backs off until the switch is
+ * released and closes again at creep speed, where the contact position is repeatable.
+ * Each phase is bounded: the approach ends at the search distance past the expected zero,
+ * the creep after twice the back-off distance.
+ * 
+ * @param callback Function called with an UNKNOWN size once the motion is done (may be nullptr)
+ * @return Handle identifying this motion, used with get_result()
+ */
+GripperController::MotionHandle GripperController::start_homing(MotionCallback callback)
+{
+    int zero_steps = GripperStepper::get_desired_step_position(GripperStepper::GripperState::CLOSED_LIMIT);
+
+    this->begin_motion(GripperStepper::GripperState::CLOSED_LIMIT, callback);
+    this->motion_status = MotionStatus::HOMING_APPROACH;
+
+    this->homing_limit_position = zero_steps - GripperStepper::mm_to_steps(Config::values.gripper_homing_search_mm);
+    this->plate_stepper->setSpeed(Config::values.gripper_speed);
+    this->plate_stepper->moveTo(this->homing_limit_position);
+
+    return this->motion_handle;
+}
+
+/**
+ * Prepares a new motion, superseding one that is still running, without moving the plate yet.
+ * @param target Target gripper state
+ * @param callback Function called with the detected size once the motion is done (may be nullptr)
+ */
+void GripperController::begin_motion(GripperStepper::GripperState target, MotionCallback callback)
+{
+    // The journaled plate position is no longer valid once the plate moves
+    StateJournal::mark_moving();
+
+    this->motion_handle++;
+    this->motion_target = target;
+    this->motion_result = GripperStepper::RaspberrySize::UNKNOWN;
+    this->motion_callback = callback;
+    this->motion_started_ms = millis();
+    this->motion_start_position = this->plate_stepper->currentPosition();
+    this->motion_actuated = false;
+
+    // Only contacts made during this motion count
+    this->limit_switch_pressure->clear_contact();
+    this->limit_switch_zero->clear_contact();
+}
+
+/**
+ * Advances the current motion by at most one stepper step and checks the limit switches.
+ * Must be called as often as possible while a motion is running.
+ * Also writes queued telemetry, since blocking motions keep the main loop from doing so.
+ * 
+ * @return true while the motion is still running, false once it is done (or none was started)
+ */
+bool GripperController::tick()
+{
+    this->interface->flush();
+
+    switch (this->motion_status)
     {
-        // Open gripper fully - simple movement with periodic status updates
-        this->plate_stepper->moveTo(target_steps);
-        int i = 0;
-        while (this->plate_stepper->isRunning())
+    case MotionStatus::IDLE:
+    case MotionStatus::DONE:
+        return false;
+    case MotionStatus::FINDING_ZERO:
+        // Creep towards the zero limit switch at constant speed, up to the search distance
+        if (this->switch_triggered(this->limit_switch_zero))
         {
-            this->plate_stepper->run();
-            i++;
-            if (i > 10000)
-            {
-                // Periodically update interface with current position
-                i = 0;
-                int current_position_step = this->plate_stepper->currentPosition();
-                this->plate_distance = GripperStepper::steps_to_mm(current_position_step);
-                this->interface->send_state("gripper.plate_distance", this->plate_distance);
-            }
+            this->rezero();
+            return false;
         }
+        if (this->plate_stepper->currentPosition() <= this->homing_limit_position)
+        {
+            this->fail_homing(GripperStepper::HomingStatus::NO_SWITCH);
+            return false;
+        }
+        this->plate_stepper->runSpeed();
+        return true;
+    case MotionStatus::HOMING_APPROACH:
+    case MotionStatus::HOMING_BACK_OFF:
+    case MotionStatus::HOMING_CREEP:
+        return this->tick_homing();
+    case MotionStatus::RUNNING:
+        break;
+    }
 
-        // Update final position
+    this->plate_stepper->run();
+
+    if (!this->motion_actuated && this->plate_stepper->currentPosition() != this->motion_start_position)
+    {
+        // First step taken - report command-to-actuation latency
+        this->motion_actuated = true;
+        this->interface->send_state(TelemetryKey::GRIPPER_MOTION_LATENCY_MS, millis() - this->motion_started_ms);
+    }
+
+    if (this->interface->is_state_due(TelemetryKey::GRIPPER_PLATE_DISTANCE))
+    {
+        // Update interface with current position, as often as its telemetry interval allows
         int current_position_step = this->plate_stepper->currentPosition();
         this->plate_distance = GripperStepper::steps_to_mm(current_position_step);
-        this->gripper_state = GripperStepper::GripperState::OPEN;
-        this->interface->send_state("gripper.gripper_state", GripperStepper::serialize_gripper_state(this->gripper_state));
-        this->interface->send_state("gripper.plate_distance", this->plate_distance);
-        return GripperStepper::RaspberrySize::UNKNOWN;
+        this->interface->send_state(TelemetryKey::GRIPPER_PLATE_DISTANCE, this->plate_distance);
     }
-    break;
-    case GripperStepper::GripperState::CLOSED_LIMIT:
+
+    if (this->motion_target == GripperStepper::GripperState::OPEN)
     {
-        // Close gripper until pressure plate or zero limit switch is triggered
-        this->plate_stepper->moveTo(target_steps);
-        bool limit_switch_zero = false;
-        bool limit_switch_pressure = false;
-        int i = 0;
-        do
+        // Open gripper fully - simple movement without switch checks
+        if (this->plate_stepper->isRunning())
         {
-            this->plate_stepper->run();
+            return true;
+        }
 
-            i++;
-            if (i > 10000)
-            {
-                // Periodically update interface with current position
-                i = 0;
-                int current_position_step = this->plate_stepper->currentPosition();
-                this->plate_distance = GripperStepper::steps_to_mm(current_position_step);
-                this->interface->send_state("gripper.plate_distance", this->plate_distance);
-            }
+        // Update final position
+        int current_position_step = this->plate_stepper->currentPosition();
+        this->plate_distance = GripperStepper::steps_to_mm(current_position_step);
+        this->gripper_state = GripperStepper::GripperState::OPEN;
+        this->interface->send_state(TelemetryKey::GRIPPER_STATE, this->gripper_state);
+        this->interface->send_state(TelemetryKey::GRIPPER_PLATE_DISTANCE, this->plate_distance);
+        this->finish_motion(GripperStepper::RaspberrySize::UNKNOWN);
+        return false;
+    }
+
+    // Closing motions stop if pressure plate or zero limit switch is triggered
+    bool limit_switch_pressure = this->switch_triggered(this->limit_switch_pressure);
+    bool limit_switch_zero = this->switch_triggered(this->limit_switch_zero);
+
+    if (!limit_switch_pressure && !limit_switch_zero && this->plate_stepper->isRunning())
+    {
+        return true;
+    }
 
-            // Check both limit switches
-            limit_switch_pressure = this->limit_switch_pressure->is_touching();
-            limit_switch_zero = this->limit_switch_zero->is_touching();
+    if (limit_switch_pressure)
+    {
+        // Pressure plate activated - raspberry detected
+        // Determine size based on current position
+        GripperStepper::RaspberrySize size;
+        GripperStepper::GripperState state;
 
-        } while (!limit_switch_pressure && !limit_switch_zero && this->plate_stepper->isRunning());
+        this->plate_stepper->setSpeed(0); // Stop immediately
 
-        if (limit_switch_pressure)
+        // Use the position latched at the moment of contact if available
+        LimitSwitch::Contact contact;
+        long contact_position_step = this->plate_stepper->currentPosition();
+        if (this->limit_switch_pressure->take_contact(&contact))
         {
-            // Pressure plate activated - raspberry detected
-            // Determine size based on current position
-            GripperStepper::RaspberrySize size;
-            GripperStepper::GripperState state;
-
-            this->plate_stepper->setSpeed(0);  // Stop immediately
-
-            int current_position_step = this->plate_stepper->currentPosition();
-            int raspberry_width = GripperStepper::steps_to_mm(current_position_step);
-
-            // Classify raspberry size based on width
-            if (raspberry_width > GripperController::berry_size_threshold_mm)
-            {
-                size = GripperStepper::RaspberrySize::LARGE;
-                state = GripperStepper::GripperState::CLOSED_LARGE;
-            }
-            else
-            {
-                size = GripperStepper::RaspberrySize::SMALL;
-                state = GripperStepper::GripperState::CLOSED_SMALL;
-            }
-
-            this->gripper_state = state;
-            this->interface->send_state("gripper.gripper_state",
-                                        GripperStepper::serialize_gripper_state(state));
-
-            return size;
+            contact_position_step = contact.position;
         }
-        else if (limit_switch_zero)
+        int raspberry_width = GripperStepper::steps_to_mm(contact_position_step);
+
+        // Classify raspberry size based on width
+        if (raspberry_width > Config::values.gripper_berry_size_threshold_mm)
         {
-            // Hit zero limit switch - recalibrate zero position
-            this->plate_stepper->setSpeed(0);
-            this->plate_stepper->setCurrentPosition(target_steps);
+            size = GripperStepper::RaspberrySize::LARGE;
+            state = GripperStepper::GripperState::CLOSED_LARGE;
         }
         else
         {
-            // Reached expected zero without triggering limit switch
-            // Continue at low speed to find actual zero position
-            Serial.println((String) + "closed without reaching limit switch. finding zero");
-            this->plate_stepper->setSpeed(-GripperStepper::speed);
-            while (!this->limit_switch_zero->is_touching())
-            {
-                this->plate_stepper->runSpeed();
-            }
-            this->plate_stepper->setCurrentPosition(target_steps);
+            size = GripperStepper::RaspberrySize::SMALL;
+            state = GripperStepper::GripperState::CLOSED_SMALL;
         }
-        return GripperStepper::RaspberrySize::UNKNOWN;
+
+        this->gripper_state = state;
+        this->interface->send_state(TelemetryKey::GRIPPER_STATE, state);
+        this->finish_motion(size);
+        return false;
     }
-    break;
-    case GripperStepper::GripperState::CLOSED_LARGE:
-    case GripperStepper::GripperState::CLOSED_SMALL:
-    {
-        // Close gripper to specific position (small or large)
-        // Stop if pressure plate or zero limit switch is triggered
-        this->plate_stepper->moveTo(target_steps);
-        bool limit_switch_pressure = false;
-        bool limit_switch_zero = false;
-        int i = 0;
-        do
-        {
-            this->plate_stepper->run();
 
-            i++;
-            if (i > 10000)
-            {
-                // Periodically update interface with current position
-                i = 0;
-                int current_position_step = this->plate_stepper->currentPosition();
-                this->plate_distance = GripperStepper::steps_to_mm(current_position_step);
-                this->interface->send_state("gripper.plate_distance", this->plate_distance);
-            }
+    if (this->motion_target != GripperStepper::GripperState::CLOSED_LIMIT)
+    {
+        // No raspberry detected - reached target position or limit switch
+        this->gripper_state = this->motion_target;
+        this->interface->send_state(TelemetryKey::GRIPPER_STATE, this->gripper_state);
+        this->finish_motion(GripperStepper::RaspberrySize::UNKNOWN);
+        return false;
+    }
 
-            // Check both limit switches
-            limit_switch_pressure = this->limit_switch_pressure->is_touching();
-            limit_switch_zero = this->limit_switch_zero->is_touching();
+    if (limit_switch_zero)
+    {
+        // Hit zero limit switch - recalibrate zero position
+        this->rezero();
+        return false;
+    }
 
-        } while (!limit_switch_pressure && !limit_switch_zero && this->plate_stepper->isRunning());
+    // Reached expected zero without triggering limit switch
+    // Continue at low speed to find actual zero position, up to the search distance
+    this->interface->log(F("closed without reaching limit switch. finding zero"));
+    this->homing_limit_position = this->plate_stepper->currentPosition() - GripperStepper::mm_to_steps(Config::values.gripper_homing_search_mm);
+    this->plate_stepper->setSpeed(-Config::values.gripper_speed);
+    this->motion_status = MotionStatus::FINDING_ZERO;
+    return true;
+}
 
-        GripperStepper::RaspberrySize size;
-        GripperStepper::GripperState state;
+/**
+ * Advances a homing motion through approach, back-off and creep.
+ * @return true while the motion is still running, false once it is done
+ */
+bool GripperController::tick_homing()
+{
+    if (this->interface->is_state_due(TelemetryKey::GRIPPER_PLATE_DISTANCE))
+    {
+        int current_position_step = this->plate_stepper->currentPosition();
+        this->plate_distance = GripperStepper::steps_to_mm(current_position_step);
+        this->interface->send_state(TelemetryKey::GRIPPER_PLATE_DISTANCE, this->plate_distance);
+    }
 
-        if (limit_switch_pressure)
+    long current_position_step;
+    switch (this->motion_status)
+    {
+    case MotionStatus::HOMING_APPROACH:
+        this->plate_stepper->run();
+        if (this->switch_triggered(this->limit_switch_pressure))
         {
-            // Pressure plate activated - raspberry detected during closure
-            this->plate_stepper->setSpeed(0);
-
-            int current_position_step = this->plate_stepper->currentPosition();
-            int raspberry_width = GripperStepper::steps_to_mm(current_position_step);
-
-            // Determine actual size based on where pressure was detected
-            if (raspberry_width > GripperController::berry_size_threshold_mm)
-            {
-                size = GripperStepper::RaspberrySize::LARGE;
-                state = GripperStepper::GripperState::CLOSED_LARGE;
-            }
-            else
-            {
-                size = GripperStepper::RaspberrySize::SMALL;
-                state = GripperStepper::GripperState::CLOSED_SMALL;
-            }
+            // Something between the plates - the zero cannot be reached
+            this->fail_homing(GripperStepper::HomingStatus::BLOCKED);
+            return false;
         }
-        else
+        if (this->switch_triggered(this->limit_switch_zero))
+        {
+            // A contact at full speed may overshoot or lose steps - back off and approach again slowly
+            current_position_step = this->plate_stepper->currentPosition();
+            this->plate_stepper->setCurrentPosition(current_position_step); // Stop immediately
+            this->plate_stepper->moveTo(current_position_step + GripperStepper::mm_to_steps(Config::values.gripper_homing_back_off_mm));
+            this->motion_status = MotionStatus::HOMING_BACK_OFF;
+            return true;
+        }
+        if (!this->plate_stepper->isRunning())
+        {
+            this->fail_homing(GripperStepper::HomingStatus::NO_SWITCH);
+            return false;
+        }
+        return true;
+    case MotionStatus::HOMING_BACK_OFF:
+        this->plate_stepper->run();
+        if (this->plate_stepper->isRunning())
+        {
+            return true;
+        }
+        if (this->limit_switch_zero->is_touching())
+        {
+            this->fail_homing(GripperStepper::HomingStatus::STUCK);
+            return false;
+        }
+        // Switch released - approach again at creep speed, up to twice the back-off distance
+        this->limit_switch_zero->clear_contact();
+        this->homing_limit_position = this->plate_stepper->currentPosition() - 2 * GripperStepper::mm_to_steps(Config::values.gripper_homing_back_off_mm);
+        this->plate_stepper->setSpeed(-Config::values.gripper_homing_creep_speed);
+        this->motion_status = MotionStatus::HOMING_CREEP;
+        return true;
+    case MotionStatus::HOMING_CREEP:
+        if (this->switch_triggered(this->limit_switch_zero))
         {
-            // No raspberry detected - reached target position or limit switch
-            state = desired_gripper_state;
-            size = GripperStepper::RaspberrySize::UNKNOWN;
+            this->rezero();
+            return false;
         }
+        if (this->plate_stepper->currentPosition() <= this->homing_limit_position)
+        {
+            this->fail_homing(GripperStepper::HomingStatus::NO_SWITCH);
+            return false;
+        }
+        this->plate_stepper->runSpeed();
+        return true;
+    default:
+        return false;
+    }
+}
 
-        this->gripper_state = state;
-        this->interface->send_state("gripper.gripper_state",
-                                    GripperStepper::serialize_gripper_state(state));
+/**
+ * Recalibrates the plate position at the zero limit switch and finishes the motion.
+ * The switch position is the expected zero; the drift is how far the step count was off at the
+ * contact, positive if the switch triggered before the count reached the expected zero.
+ */
+void GripperController::rezero()
+{
+    int zero_steps = GripperStepper::get_desired_step_position(GripperStepper::GripperState::CLOSED_LIMIT);
 
-        return size;
+    // Use the position latched at the moment of contact if available, the plate may have stepped on since
+    LimitSwitch::Contact contact;
+    long current_position_step = this->plate_stepper->currentPosition();
+    long contact_position_step = current_position_step;
+    if (this->limit_switch_zero->take_contact(&contact))
+    {
+        contact_position_step = contact.position;
+    }
+    long drift_steps = contact_position_step - zero_steps;
+    this->plate_stepper->setCurrentPosition(current_position_step - drift_steps);
+
+    this->homing_result = GripperStepper::HomingStatus::OK;
+    this->plate_distance = GripperStepper::steps_to_mm(current_position_step - drift_steps);
+    this->gripper_state = GripperStepper::GripperState::CLOSED_LIMIT;
+    this->interface->send_state(TelemetryKey::GRIPPER_STATE, this->gripper_state);
+    this->interface->send_state(TelemetryKey::GRIPPER_PLATE_DISTANCE, this->plate_distance);
+    this->interface->send_state(TelemetryKey::GRIPPER_HOMING_DRIFT_STEPS, drift_steps);
+    this->interface->send_state(TelemetryKey::GRIPPER_HOMING_STATUS, this->homing_result);
+    this->finish_motion(GripperStepper::RaspberrySize::UNKNOWN);
+}
+
+/**
+ * Stops the plate where it is, without recalibrating it, and finishes the motion.
+ * @param status Reason the zero limit switch was not found
+ */
+void GripperController::fail_homing(GripperStepper::HomingStatus status)
+{
+    long current_position_step = this->plate_stepper->currentPosition();
+    this->plate_stepper->setCurrentPosition(current_position_step); // Stop immediately
+
+    this->homing_result = status;
+    this->plate_distance = GripperStepper::steps_to_mm(current_position_step);
+    this->interface->log(F("zero limit switch not found")); // The reason follows as gripper.homing.status
+    this->interface->send_state(TelemetryKey::GRIPPER_PLATE_DISTANCE, this->plate_distance);
+    this->interface->send_state(TelemetryKey::GRIPPER_HOMING_STATUS, this->homing_result);
+    this->finish_motion(GripperStepper::RaspberrySize::UNKNOWN);
+}
+
+/**
+ * Checks whether a plate motion is currently in progress.
+ * @return true if tick() still has work to do
+ */
+bool GripperController::is_moving()
+{
+    return this->motion_status != MotionStatus::IDLE && this->motion_status != MotionStatus::DONE;
+}
+
+/**
+ * Polls the result of a motion started with start_gripper().
+ * A motion superseded by a newer one counts as done with UNKNOWN size.
+ * @param handle Handle returned by start_gripper()
+ * @param out_size Pointer to store the detected raspberry size
+ * @return true if the motion is done and out_size was written, false while still running
+ */
+bool GripperController::get_result(MotionHandle handle, GripperStepper::RaspberrySize *out_size)
+{
+    if (handle != this->motion_handle)
+    {
+        *out_size = GripperStepper::RaspberrySize::UNKNOWN;
+        return true;
+    }
+    if (this->motion_status != MotionStatus::DONE)
+    {
+        return false;
+    }
+    *out_size = this->motion_result;
+    return true;
+}
+
+/**
+ * Checks whether a limit switch is touching.
+ * With the interrupt-driven stepper, a switch that stopped the plate counts as triggered
+ * even if it has already bounced open again.
+ * @param limit_switch Limit switch to check
+ * @return true if the switch is touching or stopped the current motion
+ */
+bool GripperController::switch_triggered(LimitSwitch *limit_switch)
+{
+#ifdef RASPBERRY_PICKER_ISR_STEPPER
+    if (this->plate_stepper->stopped_by() == limit_switch->get_pin())
+    {
+        return true;
     }
-    break;
+#endif
+    return limit_switch->is_touching();
+}
+
+/**
+ * Marks the current motion as done, reports its duration and notifies the callback.
+ * @param size Detected raspberry size
+ */
+void GripperController::finish_motion(GripperStepper::RaspberrySize size)
+{
+    this->motion_result = size;
+    this->motion_status = MotionStatus::DONE;
+    this->interface->send_state(TelemetryKey::GRIPPER_MOTION_DURATION_MS, millis() - this->motion_started_ms);
+    if (this->motion_callback != nullptr)
+    {
+        this->motion_callback(this, size);
     }
-    return GripperStepper::RaspberrySize::UNKNOWN;
 }
 
 /**
@@ -277,23 +578,102 @@ GripperStepper::RaspberrySize GripperController::set_gripper(GripperStepper::Gri
  */
 bool GripperController::is_ripe()
 {
-    // Measure color values
-    RAW_RGB color = this->color_sensor->measure_rgb_raw();
+    bool is_ripe;
+
+    // Measure color values, keeping any plate motion going meanwhile
+    this->begin_ripeness();
+    while (!this->poll_ripeness(&is_ripe))
+    {
+        this->tick();
+    }
+    return is_ripe;
+}
+
+/**
+ * Starts a non-blocking ripeness measurement.
+ * Uses the sequential early-stopping decision if enabled, otherwise a full measurement.
+ */
+void GripperController::begin_ripeness()
+{
+    if (ColorSensor::sequential_decision)
+    {
+        int current_position_step = this->plate_stepper->currentPosition();
+        int plate_distance = GripperStepper::steps_to_mm(current_position_step);
+        this->color_sensor->begin_decision(plate_distance);
+    }
+    else
+    {
+        this->color_sensor->begin_measurement();
+    }
+}
 
+/**
+ * Advances the ripeness measurement started with begin_ripeness().
+ * 
+ * @param out_is_ripe Pointer to store the decision once available
+ * @return true once the decision is available
+ */
+bool GripperController::poll_ripeness(bool *out_is_ripe)
+{
+    if (!this->color_sensor->poll())
+    {
+        return false;
+    }
+
+    this->report_settle_times();
+
+    if (!ColorSensor::sequential_decision)
+    {
+        *out_is_ripe = this->evaluate_ripeness(this->color_sensor->result());
+        return true;
+    }
+
+    // Report samples used for the decision and the decided probability
+    uint16_t ripeness_p_q = this->color_sensor->get_decision_p_q();
+    float ripeness_p = ripeness_p_q / (float)(1U << RipenessModels::p_shift);
+    this->interface->send_state(TelemetryKey::GRIPPER_RIPENESS_SAMPLES, this->color_sensor->get_samples_used());
+    this->interface->send_state(TelemetryKey::GRIPPER_RASPBERRY_RIPENESS_P_RIPE, ripeness_p);
+    this->interface->send_state(TelemetryKey::GRIPPER_RASPBERRY_RIPENESS_P_UNRIPE, 1 - ripeness_p);
+    *out_is_ripe = ripeness_p_q > (1U << (RipenessModels::p_shift - 1));
+    return true;
+}
+
+/**
+ * Sends the LDR settle time of each channel of the last measurement to the interface.
+ */
+void GripperController::report_settle_times()
+{
+    this->interface->send_state(TelemetryKey::GRIPPER_RIPENESS_SETTLE_MS_R, this->color_sensor->get_settle_ms(0));
+    this->interface->send_state(TelemetryKey::GRIPPER_RIPENESS_SETTLE_MS_G, this->color_sensor->get_settle_ms(1));
+    this->interface->send_state(TelemetryKey::GRIPPER_RIPENESS_SETTLE_MS_B, this->color_sensor->get_settle_ms(2));
+    this->interface->send_state(TelemetryKey::GRIPPER_RIPENESS_SETTLE_MS_NOISE, this->color_sensor->get_settle_ms(3));
+}
+
+/**
+ * Applies the ripeness model to a completed color measurement.
+ * 
+ * @param color Color values measured by the color sensor
+ * @return true if raspberry is ripe, false if unripe
+ */
+bool GripperController::evaluate_ripeness(RAW_RGB color)
+{
     // Send color measurements to interface
-    this->interface->send_state("gripper.ripeness.r", color.r);
-    this->interface->send_state("gripper.ripeness.g", color.g);
-    this->interface->send_state("gripper.ripeness.b", color.b);
-    this->interface->send_state("gripper.ripeness.noise", color.noise);
+    this->interface->send_state(TelemetryKey::GRIPPER_RIPENESS_R, color.r);
+    this->interface->send_state(TelemetryKey::GRIPPER_RIPENESS_G, color.g);
+    this->interface->send_state(TelemetryKey::GRIPPER_RIPENESS_B, color.b);
+    this->interface->send_state(TelemetryKey::GRIPPER_RIPENESS_NOISE, color.noise);
 
     // Get current plate distance for model input
     int current_position_step = this->plate_stepper->currentPosition();
     int plate_distance = GripperStepper::steps_to_mm(current_position_step);
     
-    // Calculate ripeness probability using logistic regression model
-    float ripeness_p = this->color_sensor->get_ripenesses_p(color, plate_distance);
-    this->interface->send_state("gripper.raspberry_ripeness.p_ripe", ripeness_p);
-    this->interface->send_state("gripper.raspberry_ripeness.p_unripe", 1 - ripeness_p);
+    // Calculate ripeness probability using the fixed-point ripeness model selected at compile time
+    uint16_t ripeness_p_q = this->color_sensor->get_ripeness_p_q(plate_distance);
+    float ripeness_p = ripeness_p_q / (float)(1U << RipenessModels::p_shift);
+    this->interface->send_state(TelemetryKey::GRIPPER_RASPBERRY_RIPENESS_P_RIPE, ripeness_p);
+    this->interface->send_state(TelemetryKey::GRIPPER_RASPBERRY_RIPENESS_P_UNRIPE, 1 - ripeness_p);
+
+    this->interface->send_state(TelemetryKey::GRIPPER_RIPENESS_SAMPLES, this->color_sensor->get_samples_used());
 
     // TODO: Consider adding bias/threshold adjustment instead of 50/50 split
     return ripeness_p > 0.5;
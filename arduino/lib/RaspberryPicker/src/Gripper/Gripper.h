@@ -21,6 +21,16 @@
 #include "ColorSensor.h"
 #include "GripperStepper.h"
 
+#if defined(RASPBERRY_PICKER_ISR_STEPPER)
+#include "IsrStepper.h"
+typedef IsrStepper PlateStepper;   // Plate motor stepped from a timer interrupt
+#elif defined(RASPBERRY_PICKER_TABLE_STEPPER)
+#include "TableStepper.h"
+typedef TableStepper PlateStepper; // Plate motor stepped from the motion loop with a precomputed profile
+#else
+typedef AccelStepper PlateStepper; // Plate motor stepped from the motion loop
+#endif
+
 /**
  * GripperPinout structure - defines pin assignments for gripper components.
  */
@@ -39,6 +49,37 @@ typedef struct
 class GripperController
 {
 public:
+    /**
+     * MotionStatus enum - progress of the current plate motion.
+     * IDLE: No motion has been started yet
+     * RUNNING: Plate is moving towards the target position
+     * FINDING_ZERO: Expected zero reached without limit switch, creeping until it triggers
+     * HOMING_APPROACH: Homing - closing at full speed until the zero limit switch triggers
+     * HOMING_BACK_OFF: Homing - opening until the zero limit switch is released
+     * HOMING_CREEP: Homing - closing at creep speed until the zero limit switch triggers again
+     * DONE: Motion finished, result is available
+     */
+    enum class MotionStatus
+    {
+        IDLE,
+        RUNNING,
+        FINDING_ZERO,
+        HOMING_APPROACH,
+        HOMING_BACK_OFF,
+        HOMING_CREEP,
+        DONE,
+    };
+
+    /**
+     * Handle identifying a motion started with start_gripper().
+     */
+    typedef unsigned int MotionHandle;
+
+    /**
+     * Completion callback - called once with the detected raspberry size when a motion is done.
+     */
+    typedef void (*MotionCallback)(GripperController *gripper_controller, GripperStepper::RaspberrySize size);
+
     /**
      * Constructor - initializes the gripper controller with all sensors and motors.
      * Initializes all subcomponents: color sensor, limit switches, and stepper motor.
@@ -51,7 +92,8 @@ public:
      * 
      * Behavior varies by desired state:
      * - OPEN: Fully opens gripper
-     * - CLOSED_LIMIT: Closes until limit switch or pressure plate activated
+     * - CLOSED_LIMIT: Closes until limit switch or pressure plate activated, in one motion;
+     *   a raspberry is sized by the position at which it touches the pressure plate
      * - CLOSED_SMALL/LARGE: Closes to specific position, detecting raspberry if present
      * 
      * @param desired_gripper_state Target gripper state
@@ -59,6 +101,65 @@ public:
      */
     GripperStepper::RaspberrySize set_gripper(GripperStepper::GripperState desired_gripper_state);
 
+    /**
+     * Starts moving the gripper to a specified state without blocking.
+     * The motion is advanced by tick(); the detected size is passed to the callback
+     * and can be polled with get_result().
+     * @param desired_gripper_state Target gripper state
+     * @param callback Called once the motion is done (may be nullptr)
+     * @return Handle identifying the motion
+     */
+    MotionHandle start_gripper(GripperStepper::GripperState desired_gripper_state, MotionCallback callback);
+
+    /**
+     * Finds the zero limit switch and recalibrates the plate position.
+     * Blocking wrapper around start_homing()/tick().
+     * @return Homing result, also reported as gripper.homing.status
+     */
+    GripperStepper::HomingStatus home();
+
+    /**
+     * Starts finding the zero limit switch without blocking: a fast approach, a short
+     * back-off and a slow re-approach, each bounded so a missing switch cannot stall the plate.
+     * The motion is advanced by tick(); the callback gets an UNKNOWN size.
+     * @param callback Called once the motion is done (may be nullptr)
+     * @return Handle identifying the motion
+     */
+    MotionHandle start_homing(MotionCallback callback);
+
+    /**
+     * Advances the current motion and checks the limit switches.
+     * Call this from the main loop as often as possible.
+     * @return true while a motion is running
+     */
+    bool tick();
+
+    /**
+     * Checks whether a motion is currently running.
+     */
+    bool is_moving();
+
+    /**
+     * Applies the configured speed, maximum speed and acceleration to the plate stepper.
+     * Call this after changing them in the configuration.
+     */
+    void apply_config();
+
+    /**
+     * Restores the plate position journaled before a power loss, without moving the plate.
+     * @param position Plate stepper position [steps]
+     * @param state Gripper state at that position
+     */
+    void restore(long position, GripperStepper::GripperState state);
+
+    /**
+     * Polls the result of a motion started with start_gripper().
+     * @param handle Handle returned by start_gripper()
+     * @param out_size Pointer to store the detected raspberry size
+     * @return true if the motion is done and out_size was written
+     */
+    bool get_result(MotionHandle handle, GripperStepper::RaspberrySize *out_size);
+
     /**
      * Determines if the currently held raspberry is ripe.
      * Uses color sensor to measure RGB values and applies ripeness detection model.
@@ -66,18 +167,83 @@ public:
      */
     bool is_ripe();
 
+    /**
+     * Applies the ripeness detection model to a completed color measurement.
+     * Used together with the non-blocking ColorSensor measurement API.
+     * @param color Color values measured by the color sensor
+     * @return true if the raspberry is ripe, false if unripe
+     */
+    bool evaluate_ripeness(RAW_RGB color);
+
+    /**
+     * Starts a non-blocking ripeness measurement (sequential decision if enabled).
+     */
+    void begin_ripeness();
+
+    /**
+     * Advances the ripeness measurement started with begin_ripeness().
+     * @param out_is_ripe Pointer to store the decision once available
+     * @return true once the decision is available
+     */
+    bool poll_ripeness(bool *out_is_ripe);
+
     ColorSensor *color_sensor;                      // Pointer to color sensor
     GripperStepper::GripperState gripper_state;     // Current gripper state
     float plate_distance;                           // Current distance between gripper plates [mm]
-    AccelStepper *plate_stepper;                    // Pointer to stepper motor controller
+    PlateStepper *plate_stepper;                    // Pointer to stepper motor controller
     InterfaceMaster *interface;                     // Pointer to interface master
     LimitSwitch *limit_switch_zero;                 // Pointer to zero position limit switch
     LimitSwitch *limit_switch_pressure;             // Pointer to pressure detection limit switch
 
-    const static int berry_size_threshold_mm;       // Threshold between small and large raspberries [mm]
-    const static int picking_delay_ms;              // Maximum wait time for user to pick raspberry [ms]
+    const static unsigned long switch_debounce_us;  // Debounce time of the limit switch interrupts [us]
 
 private:
+    /**
+     * Checks whether a limit switch is touching or has stopped the plate.
+     */
+    bool switch_triggered(LimitSwitch *limit_switch);
+
+    /**
+     * Prepares a new motion towards a gripper state, without moving the plate yet.
+     */
+    void begin_motion(GripperStepper::GripperState target, MotionCallback callback);
+
+    /**
+     * Advances a homing motion started with start_homing().
+     */
+    bool tick_homing();
+
+    /**
+     * Recalibrates the plate position at the zero limit switch contact and reports the drift.
+     */
+    void rezero();
+
+    /**
+     * Stops the plate without recalibrating it and reports why the zero switch was not found.
+     */
+    void fail_homing(GripperStepper::HomingStatus status);
+
+    /**
+     * Sends the LDR settle time per channel of the last measurement.
+     */
+    void report_settle_times();
+
+    /**
+     * Marks the current motion as done and notifies the callback.
+     */
+    void finish_motion(GripperStepper::RaspberrySize size);
+
+    MotionStatus motion_status;                     // Progress of the current motion
+    MotionHandle motion_handle;                     // Handle of the most recently started motion
+    GripperStepper::GripperState motion_target;     // Target state of the current motion
+    GripperStepper::RaspberrySize motion_result;    // Detected size once the motion is done
+    MotionCallback motion_callback;                 // Completion callback of the current motion
+    unsigned long motion_started_ms;                // Time the current motion was started [ms]
+    long motion_start_position;                     // Stepper position when the motion was started [steps]
+    bool motion_actuated;                           // Whether the first step of the motion was taken
+    long homing_limit_position;                     // Position at which the current search gives up [steps]
+    GripperStepper::HomingStatus homing_result;     // Result of the most recent homing
+
     /**
      * Destructor - prevents memory leak by cleaning up stepper motor.
      */
@@ -2,63 +2,17 @@
  * GripperStepper.cpp
  * 
  * Gripper stepper motor state management and unit conversion utilities.
- * Provides serialization/deserialization of gripper and raspberry size states,
+ * Provides the name tables of the gripper and raspberry size states,
  * and conversion functions between millimeters and stepper motor steps.
  */
 
 #include <Arduino.h>
 #include "GripperStepper.h"
+#include "../Interface/Config.h"
 
-// String representations of gripper states
-static const char *gripper_state_strings[4] = {
-    "OPEN",
-    "CLOSED_SMALL",
-    "CLOSED_LARGE",
-    "CLOSED_LIMIT",
-};
-
-/**
- * Converts GripperState enum to string representation.
- * @param gripper_state Gripper state enum value
- * @return String representation of the gripper state
- */
-const char *GripperStepper::serialize_gripper_state(GripperStepper::GripperState gripper_state)
-{
-    int idx = (int)gripper_state;
-    return gripper_state_strings[idx];
-}
-
-/**
- * Converts string to GripperState enum.
- * @param gripper_state_str String representation of gripper state
- * @param out_gripper_state Pointer to store resulting GripperState enum
- * @return true if string matched a valid state, false otherwise
- */
-bool GripperStepper::deserialize_gripper_state(String gripper_state_str, GripperStepper::GripperState *out_gripper_state)
-{
-    bool matched = true;
-    if (gripper_state_str == "CLOSED_SMALL")
-    {
-        *out_gripper_state = GripperStepper::GripperState::CLOSED_SMALL;
-    }
-    else if (gripper_state_str == "CLOSED_LARGE")
-    {
-        *out_gripper_state = GripperStepper::GripperState::CLOSED_LARGE;
-    }
-    else if (gripper_state_str == "CLOSED_LIMIT")
-    {
-        *out_gripper_state = GripperStepper::GripperState::CLOSED_LIMIT;
-    }
-    else if (gripper_state_str == "OPEN")
-    {
-        *out_gripper_state = GripperStepper::GripperState::OPEN;
-    }
-    else
-    {
-        matched = false;
-    }
-    return matched;
-}
+ENUM_REFLECTION_DEFINE(GripperStepper::RaspberrySize, RASPBERRY_PICKER_RASPBERRY_SIZES, raspberry_size_names)
+ENUM_REFLECTION_DEFINE(GripperStepper::GripperState, RASPBERRY_PICKER_GRIPPER_STATES, gripper_state_names)
+ENUM_REFLECTION_DEFINE(GripperStepper::HomingStatus, RASPBERRY_PICKER_HOMING_STATUSES, homing_status_names)
 
 /**
  * Converts millimeters to stepper motor steps.
@@ -100,16 +54,16 @@ int GripperStepper::get_desired_step_position(GripperState state)
     switch (state)
     {
     case GripperStepper::GripperState::OPEN:
-        desired_mm = GripperStepper::plate_distance_open;
+        desired_mm = Config::values.gripper_plate_distance_open;
         break;
     case GripperStepper::GripperState::CLOSED_SMALL:
-        desired_mm = GripperStepper::plate_distance_small;
+        desired_mm = Config::values.gripper_plate_distance_small;
         break;
     case GripperStepper::GripperState::CLOSED_LARGE:
-        desired_mm = GripperStepper::plate_distance_large;
+        desired_mm = Config::values.gripper_plate_distance_large;
         break;
     case GripperStepper::GripperState::CLOSED_LIMIT:
-        desired_mm = GripperStepper::plate_distance_limit;
+        desired_mm = Config::values.gripper_plate_distance_limit;
         break;
     }
 
@@ -118,48 +72,3 @@ int GripperStepper::get_desired_step_position(GripperState state)
     return desired_steps;
 }
 
-// String representations of raspberry sizes
-static const char *raspberry_size_strings[] = {
-    "LARGE",
-    "SMALL",
-    "UNKNOWN",
-};
-
-/**
- * Converts RaspberrySize enum to string representation.
- * @param raspberry_size Raspberry size enum value
- * @return String representation of the raspberry size
- */
-const char *GripperStepper::serialize_raspberry_size(GripperStepper::RaspberrySize raspberry_size)
-{
-    int idx = (int)raspberry_size;
-    return raspberry_size_strings[idx];
-}
-
-/**
- * Converts string to RaspberrySize enum.
- * @param raspberry_size_str String representation of raspberry size
- * @param out_raspberry_size Pointer to store resulting RaspberrySize enum
- * @return true if string matched a valid size, false otherwise
- */
-bool GripperStepper::deserialize_raspberry_size(String raspberry_size_str, GripperStepper::RaspberrySize *out_raspberry_size)
-{
-    bool matched = true;
-    if (raspberry_size_str == "LARGE")
-    {
-        *out_raspberry_size = GripperStepper::RaspberrySize::LARGE;
-    }
-    else if (raspberry_size_str == "SMALL")
-    {
-        *out_raspberry_size = GripperStepper::RaspberrySize::SMALL;
-    }
-    else if (raspberry_size_str == "UNKNOWN")
-    {
-        *out_raspberry_size = GripperStepper::RaspberrySize::UNKNOWN;
-    }
-    else
-    {
-        matched = false;
-    }
-    return matched;
-}
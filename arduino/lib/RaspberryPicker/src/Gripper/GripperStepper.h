@@ -2,20 +2,42 @@
  * GripperStepper.h
  * 
  * Gripper stepper motor state management and unit conversion utilities.
- * Provides serialization/deserialization of gripper and raspberry size states,
+ * Provides the gripper and raspberry size states (reflected, see EnumReflection.h)
  * and conversion functions between millimeters and stepper motor steps.
  */
 
 #ifndef RASPBERRY_PICKER_GRIPPER_PLATE_H
 #define RASPBERRY_PICKER_GRIPPER_PLATE_H
 
+#include "../Interface/EnumReflection.h"
+
+// Values of GripperStepper::RaspberrySize
+#define RASPBERRY_PICKER_RASPBERRY_SIZES(X) \
+    X(LARGE) \
+    X(SMALL) \
+    X(UNKNOWN)
+
+// Values of GripperStepper::GripperState
+#define RASPBERRY_PICKER_GRIPPER_STATES(X) \
+    X(OPEN) \
+    X(CLOSED_SMALL) \
+    X(CLOSED_LARGE) \
+    X(CLOSED_LIMIT)
+
+// Values of GripperStepper::HomingStatus
+#define RASPBERRY_PICKER_HOMING_STATUSES(X) \
+    X(OK) \
+    X(NO_SWITCH) \
+    X(STUCK) \
+    X(BLOCKED)
+
 #ifndef PI
 #define PI 3.141592653589793
 #endif
 
 /**
  * GripperStepper class - manages gripper stepper motor state and conversions.
- * Provides utilities for state serialization and distance calculations.
+ * Provides utilities for distance calculations.
  */
 class GripperStepper
 {
@@ -29,21 +51,9 @@ public:
      */
     enum RaspberrySize
     {
-        LARGE,
-        SMALL,
-        UNKNOWN,
+        RASPBERRY_PICKER_RASPBERRY_SIZES(ENUM_REFLECTION_VALUE)
     };
 
-    /**
-     * Converts RaspberrySize enum to string representation.
-     */
-    static const char *serialize_raspberry_size(GripperStepper::RaspberrySize raspberry_size);
-
-    /**
-     * Converts string to RaspberrySize enum.
-     */
-    static bool deserialize_raspberry_size(String raspberry_size_str, GripperStepper::RaspberrySize *out_raspberry_size);
-
     /**
      * GripperState enum - operational states of the gripper.
      * OPEN: Gripper fully open
@@ -53,21 +63,20 @@ public:
      */
     enum class GripperState
     {
-        OPEN,
-        CLOSED_SMALL,
-        CLOSED_LARGE,
-        CLOSED_LIMIT,
+        RASPBERRY_PICKER_GRIPPER_STATES(ENUM_REFLECTION_VALUE)
     };
 
     /**
-     * Converts GripperState enum to string representation.
-     */
-    static const char *serialize_gripper_state(GripperStepper::GripperState gripper_state);
-
-    /**
-     * Converts string to GripperState enum.
+     * HomingStatus enum - result of finding the zero limit switch.
+     * OK: Zero switch found, position recalibrated
+     * NO_SWITCH: Zero switch not found within the search distance, position unchanged
+     * STUCK: Zero switch still pressed after backing off, position unchanged
+     * BLOCKED: Pressure plate pressed before the zero switch, position unchanged
      */
-    static bool deserialize_gripper_state(String gripper_state_str, GripperStepper::GripperState *out_gripper_state);
+    enum class HomingStatus
+    {
+        RASPBERRY_PICKER_HOMING_STATUSES(ENUM_REFLECTION_VALUE)
+    };
 
     /**
      * Gets the desired stepper motor position for a given gripper state.
@@ -85,14 +94,12 @@ public:
     static int steps_to_mm(int steps);
 
     static const int steps_per_revolution; // Steps per full rotation (half-step mode)
-    static const int speed;                // Target speed for normal operation [steps/sec]
-    static const int max_speed;            // Maximum speed for rapid movements [steps/sec]
-    static const int acceleration;         // Acceleration rate [steps/sec²]
     static const float transmission_ratio; // Distance traveled per rotation [mm/rotation]
-    static const int plate_distance_open;  // Plate separation when fully open [mm]
-    static const int plate_distance_large; // Plate separation for large raspberry detection [mm]
-    static const int plate_distance_small; // Plate separation for small raspberry detection [mm]
-    static const int plate_distance_limit; // Plate separation at limit switch [mm]
+    // Plate distances, speeds and acceleration are configuration values, see Interface/Config.h
 };
 
+ENUM_REFLECTION_DECLARE(GripperStepper::RaspberrySize)
+ENUM_REFLECTION_DECLARE(GripperStepper::GripperState)
+ENUM_REFLECTION_DECLARE(GripperStepper::HomingStatus)
+
 #endif
@@ -0,0 +1,346 @@
+/**
+ * IsrStepper.cpp
+ *
+ * Timer-interrupt driven stepper backend implementation for the gripper plate motor.
+ * The acceleration profile is precomputed as a table of speed levels: the ISR only
+ * counts down ticks, outputs the next half-step and moves between levels based on
+ * the steps taken and the steps remaining, without any floating point math.
+ */
+
+#ifdef RASPBERRY_PICKER_ISR_STEPPER
+
+#include <Arduino.h>
+#include <avr/interrupt.h>
+
+#include "IsrStepper.h"
+
+#if !defined(__AVR_ATmega328P__) && !defined(__AVR_ATmega32U4__)
+#error "IsrStepper supports the ATmega328P (Uno) and ATmega32U4 (Leonardo) only"
+#endif
+
+const long IsrStepper::tick_hz = 20000; // 50us tick, 16+ ticks per step at 1200 steps/sec
+
+IsrStepper *IsrStepper::instance = nullptr;
+
+/**
+ * Constructor - configures the motor pins and starts the stepping timer.
+ * @param interface Motor interface type (ignored, always half-step 4-wire)
+ * @param pin1 First motor pin
+ * @param pin2 Second motor pin
+ * @param pin3 Third motor pin
+ * @param pin4 Fourth motor pin
+ */
+IsrStepper::IsrStepper(uint8_t interface, uint8_t pin1, uint8_t pin2, uint8_t pin3, uint8_t pin4)
+    : profile(IsrStepper::tick_hz)
+{
+    uint8_t pins[4] = {pin1, pin2, pin3, pin4};
+    for (int i = 0; i < 4; i++)
+    {
+        pinMode(pins[i], OUTPUT);
+        this->pin_ports[i] = portOutputRegister(digitalPinToPort(pins[i]));
+        this->pin_masks[i] = digitalPinToBitMask(pins[i]);
+    }
+    for (int i = 0; i < 2; i++)
+    {
+        this->stop_ports[i] = nullptr;
+        this->stop_masks[i] = 0;
+        this->stop_pins[i] = -1;
+    }
+
+    this->position = 0;
+    this->remaining = 0;
+    this->ramp_steps = 0;
+    this->direction = 0;
+    this->accelerated = false;
+    this->level = 0;
+    this->interval = 0;
+    this->countdown = 0;
+    this->stopped_pin = -1;
+
+    this->max_speed = 1;
+    this->acceleration = 1;
+    this->constant_speed = 0;
+
+    instance = this;
+
+    // Configure the timer in CTC mode to fire at tick_hz
+    uint8_t sreg = SREG;
+    cli();
+#if defined(__AVR_ATmega328P__)
+    TCCR2A = (1 << WGM21);
+    TCCR2B = (1 << CS21) | (1 << CS20); // prescaler 32
+    OCR2A = F_CPU / 32 / IsrStepper::tick_hz - 1;
+    TIMSK2 |= (1 << OCIE2A);
+#elif defined(__AVR_ATmega32U4__)
+    TCCR3A = 0;
+    TCCR3B = (1 << WGM32) | (1 << CS31); // prescaler 8
+    OCR3A = F_CPU / 8 / IsrStepper::tick_hz - 1;
+    TIMSK3 |= (1 << OCIE3A);
+#endif
+    SREG = sreg;
+}
+
+/**
+ * Sets the pins of the switches that stop the motor while closing.
+ * @param stop_pin_a First stop switch pin (active HIGH)
+ * @param stop_pin_b Second stop switch pin (active HIGH)
+ */
+void IsrStepper::set_stop_pins(int stop_pin_a, int stop_pin_b)
+{
+    int pins[2] = {stop_pin_a, stop_pin_b};
+    uint8_t sreg = SREG;
+    cli();
+    for (int i = 0; i < 2; i++)
+    {
+        this->stop_pins[i] = pins[i];
+        this->stop_ports[i] = portInputRegister(digitalPinToPort(pins[i]));
+        this->stop_masks[i] = digitalPinToBitMask(pins[i]);
+    }
+    SREG = sreg;
+}
+
+/**
+ * Gets the pin of the switch that stopped the last motion.
+ * @return Pin number, or -1 if the motion was not stopped by a switch
+ */
+int IsrStepper::stopped_by()
+{
+    return this->stopped_pin;
+}
+
+/**
+ * Starts an accelerated move to an absolute position.
+ * A move in the same direction keeps its current speed level.
+ * @param absolute Target position [steps]
+ */
+void IsrStepper::moveTo(long absolute)
+{
+    long steps = absolute - this->currentPosition();
+    if (steps == 0)
+    {
+        return;
+    }
+    this->start_motion(steps > 0 ? steps : -steps, steps > 0 ? 1 : -1, true, 0);
+}
+
+/**
+ * Compatibility with AccelStepper - stepping is done by the ISR.
+ * @return true while the motor is running
+ */
+bool IsrStepper::run()
+{
+    return this->isRunning();
+}
+
+/**
+ * Starts a constant-speed move at the speed set with setSpeed().
+ * @return true while the motor is running
+ */
+bool IsrStepper::runSpeed()
+{
+    if (this->constant_speed == 0)
+    {
+        return false;
+    }
+    int8_t constant_direction = this->constant_speed > 0 ? 1 : -1;
+    if (this->direction != constant_direction || this->accelerated)
+    {
+        float speed = this->constant_speed > 0 ? this->constant_speed : -this->constant_speed;
+        this->start_motion(-1, constant_direction, false, (uint16_t)(IsrStepper::tick_hz / speed));
+    }
+    return this->isRunning();
+}
+
+/**
+ * Checks whether the motor is currently stepping.
+ */
+bool IsrStepper::isRunning()
+{
+    return this->direction != 0;
+}
+
+/**
+ * Gets the current motor position.
+ * @return Position [steps]
+ */
+long IsrStepper::currentPosition()
+{
+    uint8_t sreg = SREG;
+    cli();
+    long current = this->position;
+    SREG = sreg;
+    return current;
+}
+
+/**
+ * Stops the motor and redefines the current position.
+ * @param position New current position [steps]
+ */
+void IsrStepper::setCurrentPosition(long position)
+{
+    uint8_t sreg = SREG;
+    cli();
+    this->direction = 0;
+    this->position = position;
+    SREG = sreg;
+}
+
+/**
+ * Sets the speed for constant-speed moves. A speed of 0 stops the motor.
+ * @param speed Speed [steps/sec], negative to close
+ */
+void IsrStepper::setSpeed(float speed)
+{
+    this->constant_speed = speed;
+    if (speed == 0)
+    {
+        this->direction = 0;
+    }
+}
+
+/**
+ * Sets the maximum speed and recomputes the acceleration profile.
+ * @param speed Maximum speed [steps/sec]
+ */
+void IsrStepper::setMaxSpeed(float speed)
+{
+    this->max_speed = speed;
+    this->compute_profile();
+}
+
+/**
+ * Sets the acceleration and recomputes the acceleration profile.
+ * @param acceleration Acceleration [steps/sec²]
+ */
+void IsrStepper::setAcceleration(float acceleration)
+{
+    this->acceleration = acceleration;
+    this->compute_profile();
+}
+
+/**
+ * Recomputes the acceleration profile.
+ * The new profile is computed outside the ISR and copied in with interrupts disabled.
+ */
+void IsrStepper::compute_profile()
+{
+    MotionProfile profile(IsrStepper::tick_hz);
+    profile.compute(this->max_speed, this->acceleration);
+
+    uint8_t sreg = SREG;
+    cli();
+    this->profile = profile;
+    SREG = sreg;
+}
+
+/**
+ * Starts a move in the ISR.
+ * @param steps Number of steps to move (-1 for an endless constant-speed move)
+ * @param direction 1 to open (increasing position), -1 to close
+ * @param accelerated Whether to follow the acceleration profile
+ * @param interval Step interval for constant-speed moves [ticks]
+ */
+void IsrStepper::start_motion(long steps, int8_t direction, bool accelerated, uint16_t interval)
+{
+    uint8_t sreg = SREG;
+    cli();
+    bool continuing = accelerated && this->accelerated && this->direction == direction;
+    if (!continuing)
+    {
+        this->level = 0;
+        this->ramp_steps = 0;
+        this->interval = accelerated ? this->profile.get_interval(0) : interval;
+        this->countdown = 1; // first step on the next tick
+    }
+    this->remaining = steps;
+    this->accelerated = accelerated;
+    this->stopped_pin = -1;
+    this->direction = direction;
+    SREG = sreg;
+}
+
+/**
+ * Energizes the coils for the given position in the half-step sequence.
+ * @param position Motor position [steps]
+ */
+void IsrStepper::output_step(long position)
+{
+    uint8_t pattern = MotionProfile::get_coil_pattern(position);
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        if (pattern & (1 << i))
+        {
+            *this->pin_ports[i] |= this->pin_masks[i];
+        }
+        else
+        {
+            *this->pin_ports[i] &= ~this->pin_masks[i];
+        }
+    }
+}
+
+/**
+ * Timer interrupt handler - advances the motor by at most one step.
+ * While closing, the stop switches are checked on every tick, so the motor
+ * stops within one tick of a switch firing and the position is exact.
+ */
+void IsrStepper::handle_tick()
+{
+    if (this->direction == 0)
+    {
+        return;
+    }
+
+    if (this->direction < 0)
+    {
+        for (uint8_t i = 0; i < 2; i++)
+        {
+            if (this->stop_ports[i] != nullptr && (*this->stop_ports[i] & this->stop_masks[i]))
+            {
+                this->direction = 0;
+                this->stopped_pin = this->stop_pins[i];
+                return;
+            }
+        }
+    }
+
+    if (--this->countdown > 0)
+    {
+        return;
+    }
+
+    this->position += this->direction;
+    this->output_step(this->position);
+    this->ramp_steps++;
+
+    if (this->remaining > 0)
+    {
+        this->remaining--;
+        if (this->remaining == 0)
+        {
+            this->direction = 0;
+            return;
+        }
+    }
+
+    if (this->accelerated)
+    {
+        this->level = this->profile.get_next_level(this->level, this->ramp_steps, this->remaining);
+        this->interval = this->profile.get_interval(this->level);
+    }
+    this->countdown = this->interval;
+}
+
+#if defined(__AVR_ATmega328P__)
+ISR(TIMER2_COMPA_vect)
+#elif defined(__AVR_ATmega32U4__)
+ISR(TIMER3_COMPA_vect)
+#endif
+{
+    if (IsrStepper::instance != nullptr)
+    {
+        IsrStepper::instance->handle_tick();
+    }
+}
+
+#endif
@@ -0,0 +1,156 @@
+/**
+ * IsrStepper.h
+ *
+ * Timer-interrupt driven stepper backend for the gripper plate motor.
+ * Generates the half-step sequence of a 4-wire stepper from a timer ISR instead of
+ * a busy loop, using a precomputed acceleration profile (see MotionProfile.h).
+ * The ISR also stops the motor as soon as one of the stop switches fires while closing.
+ *
+ * Provides the subset of the AccelStepper interface used by the gripper,
+ * so it can replace AccelStepper when RASPBERRY_PICKER_ISR_STEPPER is defined.
+ * Uses Timer2 on the ATmega328P (Uno) and Timer3 on the ATmega32U4 (Leonardo),
+ * since Timer1 is used by the Servo library.
+ */
+
+#ifndef RASPBERRY_PICKER_GRIPPER_ISR_STEPPER_H
+#define RASPBERRY_PICKER_GRIPPER_ISR_STEPPER_H
+
+#include <Arduino.h>
+
+#include "MotionProfile.h"
+
+/**
+ * IsrStepper class - steps a HALF4WIRE stepper motor from a timer interrupt.
+ * Only one instance is supported, as it owns the timer.
+ */
+class IsrStepper
+{
+public:
+    static const long tick_hz;                // Frequency of the stepping timer interrupt [Hz]
+
+    /**
+     * Constructor - configures the motor pins and starts the stepping timer.
+     * Takes the same arguments as AccelStepper; only HALF4WIRE is supported.
+     * @param interface Motor interface type (ignored, always half-step 4-wire)
+     * @param pin1 First motor pin
+     * @param pin2 Second motor pin
+     * @param pin3 Third motor pin
+     * @param pin4 Fourth motor pin
+     */
+    IsrStepper(uint8_t interface, uint8_t pin1, uint8_t pin2, uint8_t pin3, uint8_t pin4);
+
+    /**
+     * Sets the pins of the switches that stop the motor while closing (moving to lower positions).
+     * The ISR checks them on every tick and stops in the same tick they fire.
+     * @param stop_pin_a First stop switch pin (active HIGH)
+     * @param stop_pin_b Second stop switch pin (active HIGH)
+     */
+    void set_stop_pins(int stop_pin_a, int stop_pin_b);
+
+    /**
+     * Gets the pin of the switch that stopped the last motion.
+     * @return Pin number, or -1 if the motion was not stopped by a switch
+     */
+    int stopped_by();
+
+    /**
+     * Starts an accelerated move to an absolute position.
+     * @param absolute Target position [steps]
+     */
+    void moveTo(long absolute);
+
+    /**
+     * Compatibility with AccelStepper - stepping is done by the ISR.
+     * @return true while the motor is running
+     */
+    bool run();
+
+    /**
+     * Starts a constant-speed move at the speed set with setSpeed().
+     * The move ends when a stop switch fires or a new move is started.
+     * @return true while the motor is running
+     */
+    bool runSpeed();
+
+    /**
+     * Checks whether the motor is currently stepping.
+     */
+    bool isRunning();
+
+    /**
+     * Gets the current motor position [steps].
+     */
+    long currentPosition();
+
+    /**
+     * Stops the motor and redefines the current position.
+     * @param position New current position [steps]
+     */
+    void setCurrentPosition(long position);
+
+    /**
+     * Sets the speed for constant-speed moves. A speed of 0 stops the motor.
+     * @param speed Speed [steps/sec], negative to close
+     */
+    void setSpeed(float speed);
+
+    /**
+     * Sets the maximum speed and recomputes the acceleration profile.
+     * @param speed Maximum speed [steps/sec]
+     */
+    void setMaxSpeed(float speed);
+
+    /**
+     * Sets the acceleration and recomputes the acceleration profile.
+     * @param acceleration Acceleration [steps/sec²]
+     */
+    void setAcceleration(float acceleration);
+
+    /**
+     * Timer interrupt handler - advances the motor by at most one step.
+     * Called from the timer ISR only.
+     */
+    void handle_tick();
+
+    static IsrStepper *instance;  // Instance driven by the timer ISR
+
+private:
+    /**
+     * Recomputes the acceleration profile and swaps it in with interrupts disabled.
+     */
+    void compute_profile();
+
+    /**
+     * Energizes the coils for the given position in the half-step sequence.
+     */
+    void output_step(long position);
+
+    /**
+     * Starts a move in the ISR with interrupts disabled.
+     */
+    void start_motion(long steps, int8_t direction, bool accelerated, uint16_t interval);
+
+    volatile uint8_t *pin_ports[4];  // Output registers of the motor pins
+    uint8_t pin_masks[4];            // Bit masks of the motor pins
+    volatile uint8_t *stop_ports[2]; // Input registers of the stop switches
+    uint8_t stop_masks[2];           // Bit masks of the stop switches
+    int stop_pins[2];                // Pin numbers of the stop switches
+
+    float max_speed;                 // Maximum speed [steps/sec]
+    float acceleration;              // Acceleration [steps/sec²]
+    float constant_speed;            // Speed for constant-speed moves [steps/sec]
+
+    MotionProfile profile;           // Speed levels of the acceleration ramp [ticks]
+
+    volatile long position;          // Current position [steps]
+    volatile long remaining;         // Steps left in the current move (-1 for constant speed)
+    volatile long ramp_steps;        // Steps taken since the move started
+    volatile int8_t direction;       // Direction of the current move (1, -1, or 0 if stopped)
+    volatile bool accelerated;       // Whether the move follows the acceleration profile
+    volatile uint8_t level;          // Current speed level
+    volatile uint16_t interval;      // Current step interval [ticks]
+    volatile uint16_t countdown;     // Ticks until the next step
+    volatile int stopped_pin;        // Pin of the switch that stopped the last move (-1 if none)
+};
+
+#endif
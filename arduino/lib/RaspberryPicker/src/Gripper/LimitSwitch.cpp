@@ -3,11 +3,31 @@
  * 
  * Simple limit switch interface implementation.
  * Provides digital input reading for detecting physical contact/touch.
+ * In interrupt mode, edges are detected by the external interrupt of the pin or,
+ * where there is none, by its pin-change interrupt group.
  */
 
 #include <Arduino.h>
 #include "LimitSwitch.h"
 
+const int LimitSwitch::max_interrupt_switches = 4;
+
+// Switches served by the interrupt handlers
+static LimitSwitch *interrupt_switches[4] = {nullptr, nullptr, nullptr, nullptr};
+static int interrupt_switch_count = 0;
+
+// External interrupt handlers, one per registered switch
+static void external_interrupt_0() { interrupt_switches[0]->handle_interrupt(); }
+static void external_interrupt_1() { interrupt_switches[1]->handle_interrupt(); }
+static void external_interrupt_2() { interrupt_switches[2]->handle_interrupt(); }
+static void external_interrupt_3() { interrupt_switches[3]->handle_interrupt(); }
+static void (*const external_interrupts[4])() = {
+    external_interrupt_0,
+    external_interrupt_1,
+    external_interrupt_2,
+    external_interrupt_3,
+};
+
 /**
  * Constructor - initializes limit switch on specified pin.
  * @param pin Digital pin number for the limit switch
@@ -16,13 +36,226 @@ LimitSwitch::LimitSwitch(int pin)
 {
     this->pin = pin;
     pinMode(this->pin, INPUT);  // Configure as input without pull-up
+
+    this->interrupt_mode = false;
+    this->debounce_us = 0;
+    this->position_source = nullptr;
+    this->position_context = nullptr;
+    this->position_interrupt_safe = false;
+    this->touching = false;
+    this->resync = false;
+    this->last_edge_us = 0;
+    this->contact_pending = false;
+    this->contact_time_us = 0;
+    this->contact_position = 0;
+}
+
+/**
+ * Switches to interrupt mode.
+ * Uses the external interrupt of the pin if it has one, otherwise its pin-change interrupt.
+ * @param debounce_us Edges closer than this to the last accepted edge are ignored [us]
+ * @return true if interrupt mode is active, false if the switch stays polled
+ */
+bool LimitSwitch::enable_interrupt(unsigned long debounce_us)
+{
+    if (this->interrupt_mode)
+    {
+        return true;
+    }
+    if (interrupt_switch_count >= LimitSwitch::max_interrupt_switches)
+    {
+        return false;
+    }
+
+    int slot = interrupt_switch_count;
+    this->debounce_us = debounce_us;
+    this->touching = digitalRead(this->pin) == HIGH;
+    this->last_edge_us = micros();
+
+    int external_interrupt = digitalPinToInterrupt(this->pin);
+    if (external_interrupt != NOT_AN_INTERRUPT)
+    {
+        interrupt_switches[slot] = this;
+        interrupt_switch_count++;
+        this->interrupt_mode = true;
+        attachInterrupt(external_interrupt, external_interrupts[slot], CHANGE);
+        return true;
+    }
+
+#if defined(__AVR__)
+    volatile uint8_t *pcmsk = digitalPinToPCMSK(this->pin);
+    if (pcmsk != nullptr)
+    {
+        uint8_t sreg = SREG;
+        cli();
+        interrupt_switches[slot] = this;
+        interrupt_switch_count++;
+        this->interrupt_mode = true;
+        *digitalPinToPCICR(this->pin) |= (1 << digitalPinToPCICRbit(this->pin));
+        *pcmsk |= (1 << digitalPinToPCMSKbit(this->pin));
+        SREG = sreg;
+        return true;
+    }
+#endif
+
+    return false;
+}
+
+/**
+ * Sets the function used to latch the stepper position at contact.
+ * @param source Function returning the current position
+ * @param context Pointer passed to the function
+ * @param interrupt_safe Whether the source may be called from the switch interrupt
+ */
+void LimitSwitch::set_position_source(PositionSource source, void *context, bool interrupt_safe)
+{
+    this->position_source = source;
+    this->position_context = context;
+    this->position_interrupt_safe = interrupt_safe;
 }
 
 /**
  * Checks if the limit switch is currently activated.
+ * In interrupt mode, the pin is only read again after an edge was ignored by the debounce.
  * @return true if switch is pressed/touching (HIGH signal), false otherwise
  */
 bool LimitSwitch::is_touching()
 {
-    return digitalRead(this->pin) == HIGH;
+    if (!this->interrupt_mode)
+    {
+        return digitalRead(this->pin) == HIGH;
+    }
+
+    if (this->resync)
+    {
+        noInterrupts();
+        unsigned long now_us = micros();
+        if (now_us - this->last_edge_us >= this->debounce_us)
+        {
+            // Bouncing is over - pick up the final state of the pin
+            this->resync = false;
+            this->latch(digitalRead(this->pin) == HIGH, now_us);
+        }
+        interrupts();
+    }
+    return this->touching;
+}
+
+/**
+ * Takes the latched contact event, if any.
+ * A position source that is not interrupt-safe is read here, in the main context.
+ * @param out_contact Pointer to store the contact
+ * @return true if a contact was latched since the last call or clear_contact()
+ */
+bool LimitSwitch::take_contact(Contact *out_contact)
+{
+    bool pending;
+    noInterrupts();
+    pending = this->contact_pending;
+    if (pending)
+    {
+        out_contact->time_us = this->contact_time_us;
+        out_contact->position = this->contact_position;
+        this->contact_pending = false;
+    }
+    interrupts();
+    if (pending && !this->position_interrupt_safe && this->position_source != nullptr)
+    {
+        out_contact->position = this->position_source(this->position_context);
+    }
+    return pending;
+}
+
+/**
+ * Discards a latched contact event.
+ */
+void LimitSwitch::clear_contact()
+{
+    this->contact_pending = false;
+}
+
+/**
+ * Gets the digital pin of the limit switch.
+ * @return Digital pin number
+ */
+int LimitSwitch::get_pin()
+{
+    return this->pin;
+}
+
+/**
+ * Interrupt handler - latches a debounced edge of this switch.
+ * Edges within debounce_us of the last accepted edge are ignored and
+ * the pin is re-read by is_touching() once the bouncing is over.
+ */
+void LimitSwitch::handle_interrupt()
+{
+    bool level = digitalRead(this->pin) == HIGH;
+    if (level == this->touching)
+    {
+        return;
+    }
+
+    unsigned long now_us = micros();
+    if (now_us - this->last_edge_us < this->debounce_us)
+    {
+        this->resync = true;
+        return;
+    }
+    this->latch(level, now_us);
+}
+
+/**
+ * Pin-change interrupt handler - checks all interrupt-driven switches for edges.
+ * Switches on external interrupts ignore it, as their level did not change.
+ */
+void LimitSwitch::handle_pin_change()
+{
+    for (int i = 0; i < interrupt_switch_count; i++)
+    {
+        interrupt_switches[i]->handle_interrupt();
+    }
+}
+
+/**
+ * Stores a new debounced state and latches a contact on a rising edge.
+ * @param touching New state of the switch
+ * @param now_us Time of the edge [us]
+ */
+void LimitSwitch::latch(bool touching, unsigned long now_us)
+{
+    if (touching == this->touching)
+    {
+        return;
+    }
+    this->touching = touching;
+    this->last_edge_us = now_us;
+    if (touching)
+    {
+        this->contact_time_us = now_us;
+        bool read_position = this->position_interrupt_safe && this->position_source != nullptr;
+        this->contact_position = read_position ? this->position_source(this->position_context) : 0;
+        this->contact_pending = true;
+    }
+}
+
+#if defined(__AVR__)
+#if defined(PCINT0_vect)
+ISR(PCINT0_vect)
+{
+    LimitSwitch::handle_pin_change();
+}
+#endif
+#if defined(PCINT1_vect)
+ISR(PCINT1_vect)
+{
+    LimitSwitch::handle_pin_change();
+}
+#endif
+#if defined(PCINT2_vect)
+ISR(PCINT2_vect)
+{
+    LimitSwitch::handle_pin_change();
 }
+#endif
+#endif
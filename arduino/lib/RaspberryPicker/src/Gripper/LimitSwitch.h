@@ -4,6 +4,8 @@
  * Simple limit switch interface.
  * Provides digital input reading for detecting physical contact/touch.
  * Used for gripper zero position detection and raspberry pressure sensing.
+ * Optionally interrupt-driven: edges are latched together with their time and
+ * the stepper position - read in the interrupt only if that is safe, see set_position_source().
  */
 
 #ifndef RASPBERRY_PICKER_GRIPPER_LIMIT_SWITCH_H
@@ -16,20 +18,102 @@
 class LimitSwitch
 {
 public:
+    /**
+     * Contact structure - latched at the moment the switch started touching.
+     * time_us: micros() timestamp of the contact edge
+     * position: Stepper position at the contact edge, or when the contact was taken
+     *           if the position source cannot be read from an interrupt [steps]
+     */
+    struct Contact
+    {
+        unsigned long time_us;
+        long position;
+    };
+
+    /**
+     * Position source - returns the current stepper position.
+     */
+    typedef long (*PositionSource)(void *context);
+
+    static const int max_interrupt_switches; // Maximum number of interrupt-driven switches
+
     /**
      * Constructor - initializes limit switch on specified pin.
      * @param pin Digital pin number for the limit switch
      */
     LimitSwitch(int pin);
 
+    /**
+     * Switches to interrupt mode using the external or pin-change interrupt of the pin.
+     * @param debounce_us Edges closer than this to the last accepted edge are ignored [us]
+     * @return true if interrupt mode is active, false if the switch stays polled
+     */
+    bool enable_interrupt(unsigned long debounce_us);
+
+    /**
+     * Sets the function used to latch the stepper position at contact.
+     * @param source Function returning the current position
+     * @param context Pointer passed to the function
+     * @param interrupt_safe Whether the source may be called from the switch interrupt, i.e. the position
+     *                       is never updated by non-atomic writes the interrupt could split; otherwise it is
+     *                       read by take_contact()
+     */
+    void set_position_source(PositionSource source, void *context, bool interrupt_safe);
+
     /**
      * Checks if the limit switch is currently activated.
+     * In interrupt mode this returns the latched, debounced state without reading the pin.
      * @return true if switch is pressed/touching (HIGH signal), false otherwise
      */
     bool is_touching();
 
+    /**
+     * Takes the latched contact event, if any.
+     * @param out_contact Pointer to store the contact
+     * @return true if a contact was latched since the last call or clear_contact()
+     */
+    bool take_contact(Contact *out_contact);
+
+    /**
+     * Discards a latched contact event.
+     */
+    void clear_contact();
+
+    /**
+     * Gets the digital pin of the limit switch.
+     */
+    int get_pin();
+
+    /**
+     * Interrupt handler - latches a debounced edge of this switch.
+     */
+    void handle_interrupt();
+
+    /**
+     * Pin-change interrupt handler - checks all interrupt-driven switches for edges.
+     */
+    static void handle_pin_change();
+
 private:
+    /**
+     * Stores a new debounced state and latches a contact on a rising edge.
+     */
+    void latch(bool touching, unsigned long now_us);
+
     int pin;  // Digital pin number for limit switch
+
+    bool interrupt_mode;                 // Whether the switch is interrupt-driven
+    unsigned long debounce_us;           // Minimum time between accepted edges [us]
+    PositionSource position_source;      // Function returning the stepper position
+    void *position_context;              // Context for the position source
+    bool position_interrupt_safe;        // Whether the position source may be called from the interrupt
+
+    volatile bool touching;              // Debounced state in interrupt mode
+    volatile bool resync;                // An edge was ignored, the state must be re-read
+    volatile unsigned long last_edge_us; // Time of the last accepted edge [us]
+    volatile bool contact_pending;       // A contact was latched and not taken yet
+    volatile unsigned long contact_time_us; // Time of the latched contact [us]
+    volatile long contact_position;      // Stepper position of the latched contact [steps]
 };
 
 #endif
@@ -0,0 +1,65 @@
+/**
+ * MotionProfile.cpp
+ *
+ * Precomputed trapezoidal acceleration profile of the plate stepper.
+ * Only compute() uses floating point math; it runs at startup, not per step.
+ */
+
+#include "MotionProfile.h"
+
+// Coil patterns of the half-step sequence (bit i drives motor pin i+1), same order as AccelStepper
+static const uint8_t half_step_patterns[8] = {
+    0b0001,
+    0b0101,
+    0b0100,
+    0b0110,
+    0b0010,
+    0b1010,
+    0b1000,
+    0b1001,
+};
+
+/**
+ * Constructor - creates a profile for 1 step/sec at 1 step/sec².
+ * @param tick_hz Unit of the step intervals [Hz]
+ */
+MotionProfile::MotionProfile(long tick_hz)
+{
+    this->tick_hz = tick_hz;
+    this->compute(1, 1);
+}
+
+/**
+ * Recomputes the speed levels.
+ * Level l covers the part of the ramp from l/levels to (l+1)/levels of the
+ * maximum speed, which ends after v²/(2a) steps. It runs at the mean speed of that
+ * part, so the staircase takes as long as the ideal ramp.
+ * @param max_speed Maximum speed [steps/sec]
+ * @param acceleration Acceleration [steps/sec²]
+ */
+void MotionProfile::compute(float max_speed, float acceleration)
+{
+    for (uint8_t l = 0; l < MotionProfile::levels; l++)
+    {
+        float end_speed = max_speed * (l + 1) / MotionProfile::levels;
+        float mean_speed = max_speed * (l + 0.5f) / MotionProfile::levels;
+        float level_interval = this->tick_hz / mean_speed;
+        float level_steps = end_speed * end_speed / (2 * acceleration);
+        this->level_interval[l] = level_interval > 65535 ? 65535 : (uint16_t)level_interval;
+        this->level_steps[l] = level_steps > 65535 ? 65535 : (uint16_t)level_steps;
+        if (this->level_interval[l] == 0)
+        {
+            this->level_interval[l] = 1;
+        }
+    }
+}
+
+/**
+ * Gets the coil pattern of a position in the half-step sequence of a 4-wire stepper.
+ * @param position Motor position [steps]
+ * @return Pattern, bit i drives motor pin i+1 (same order as AccelStepper)
+ */
+uint8_t MotionProfile::get_coil_pattern(long position)
+{
+    return half_step_patterns[position & 0x7];
+}
@@ -0,0 +1,84 @@
+/**
+ * MotionProfile.h
+ *
+ * Precomputed trapezoidal acceleration profile of the plate stepper.
+ * The ramp from standstill to the maximum speed is divided into speed levels,
+ * each with a fixed-point step interval and the step at which it ends. The profile
+ * is computed once when speed or acceleration change; while stepping, the next
+ * level is found by comparing step counts with the table, without floating point math.
+ * All plate moves (OPEN, CLOSED_LARGE, CLOSED_SMALL, CLOSED_LIMIT) share the table:
+ * they accelerate along it from the start and decelerate along it towards the target,
+ * and only differ in the level they reach.
+ */
+
+#ifndef RASPBERRY_PICKER_GRIPPER_MOTION_PROFILE_H
+#define RASPBERRY_PICKER_GRIPPER_MOTION_PROFILE_H
+
+#include <Arduino.h>
+
+/**
+ * MotionProfile class - speed levels of the acceleration ramp.
+ */
+class MotionProfile
+{
+public:
+    static const uint8_t levels = 48; // Number of speed levels of the ramp
+
+    /**
+     * Constructor - creates a profile for 1 step/sec at 1 step/sec².
+     * @param tick_hz Unit of the step intervals [Hz]
+     */
+    MotionProfile(long tick_hz);
+
+    /**
+     * Recomputes the speed levels.
+     * @param max_speed Maximum speed [steps/sec]
+     * @param acceleration Acceleration [steps/sec²]
+     */
+    void compute(float max_speed, float acceleration);
+
+    /**
+     * Gets the step interval of a speed level.
+     * @param level Speed level
+     * @return Interval between two steps [ticks]
+     */
+    uint16_t get_interval(uint8_t level) const
+    {
+        return this->level_interval[level];
+    }
+
+    /**
+     * Gets the speed level for the next step of a move, one level up or down from the current one.
+     * Decelerates when the remaining steps are needed to stop, accelerates at the end of a level.
+     * @param level Current speed level
+     * @param ramp_steps Steps taken since the move started
+     * @param remaining Steps left to the target
+     * @return Speed level of the next step
+     */
+    uint8_t get_next_level(uint8_t level, long ramp_steps, long remaining) const
+    {
+        if (level > 0 && remaining <= this->level_steps[level - 1])
+        {
+            return level - 1;
+        }
+        if (level + 1 < MotionProfile::levels && ramp_steps >= this->level_steps[level] && remaining > this->level_steps[level])
+        {
+            return level + 1;
+        }
+        return level;
+    }
+
+    /**
+     * Gets the coil pattern of a position in the half-step sequence of a 4-wire stepper.
+     * @param position Motor position [steps]
+     * @return Pattern, bit i drives motor pin i+1 (same order as AccelStepper)
+     */
+    static uint8_t get_coil_pattern(long position);
+
+private:
+    long tick_hz;                       // Unit of the step intervals [Hz]
+    uint16_t level_interval[levels];    // Step interval for each speed level [ticks]
+    uint16_t level_steps[levels];       // Steps from standstill to the end of each speed level
+};
+
+#endif
@@ -0,0 +1,229 @@
+/**
+ * RipenessModelData.h
+ *
+ * Generated by data/classifier/export.py from data_labeled_ambient_width.csv - do not edit.
+ * Retrain and regenerate with data/classifier/train_data_labeled_ambient_width.sh.
+ * Coefficients of the ripeness models evaluated by ColorSensor and RipenessModels.h,
+ * with the expected outputs of every model for a few inputs to check the firmware against.
+ */
+
+#ifndef RASPBERRY_PICKER_GRIPPER_RIPENESS_MODEL_DATA_H
+#define RASPBERRY_PICKER_GRIPPER_RIPENESS_MODEL_DATA_H
+
+#include <Arduino.h>
+
+#include "RipenessModels.h"
+
+namespace ripeness_model_data
+{
+constexpr uint8_t sample_count = 10; // Samples per channel sum the fixed-point models are made for
+constexpr uint8_t p_shift = 15;      // Fraction bits of the probabilities
+
+// Logistic regression on the normalized features (red, green, blue, ambient, width)
+constexpr float logistic_regression_w[5] PROGMEM = {-4.84228531, 11.43222114, 4.70892998, -8.17508924, -0.21195556};
+constexpr float logistic_regression_b PROGMEM = -0.3529516680896334;
+constexpr float logistic_regression_mean[5] PROGMEM = {644.25969803, 434.76480836, 406.75249710, 347.26341463, 26.05110337};
+constexpr float logistic_regression_std[5] PROGMEM = {119.43950914, 172.77980288, 173.90084779, 181.51810882, 4.02428047};
+
+// Fixed-point version: z = b + sum(w[i] * x[i]), where x are the channel sums and the width
+// times sample_count, with the normalization folded into w and b
+constexpr uint8_t logistic_regression_q_shift = 20; // Fraction bits of w, b and z
+constexpr uint8_t logistic_regression_sigmoid_shift = 12; // Fraction bits of z in the sigmoid
+constexpr int16_t logistic_regression_q_w[5] PROGMEM = {-4251, 6938, 2839, -4723, -5523};
+constexpr int32_t logistic_regression_q_b PROGMEM = 3142986;
+
+// Partial models of the sequential decision, one per number of measured channels (in sequential_order),
+// in the fixed-point format above with int32 weights. The normalized features not measured yet are
+// conditioned on the measured ones using the feature covariance of the dataset; var is the variance of z
+// caused by them, noise_w the squared weight of a channel per ADC count, which turns the variance of the
+// channel mean into variance of z
+constexpr uint8_t sequential_var_shift = 16;   // Fraction bits of var and the variances of z
+constexpr uint8_t sequential_noise_shift = 20; // Fraction bits of noise_w
+constexpr uint8_t sequential_order[4] PROGMEM = {1, 0, 3, 2};
+constexpr int32_t sequential_q_w[4][5] PROGMEM = {
+    {0, 2752, 0, 0, -55136},
+    {-3810, 5248, 0, 0, -54179},
+    {-4263, 8644, 0, -3515, -12102},
+    {-4251, 6938, 2839, -4723, -5523},
+};
+constexpr int32_t sequential_q_b[4] PROGMEM = {1978547, 15417510, 4870004, 3142986};
+constexpr uint32_t sequential_q_var[4] PROGMEM = {231673, 117394, 3061, 0};
+constexpr uint16_t sequential_noise_w[4][4] PROGMEM = {
+    {0, 722, 0, 0},
+    {1384, 2627, 0, 0},
+    {1733, 7126, 0, 1178},
+    {1723, 4591, 769, 2127},
+};
+
+// First principal component of the features: the berry is ripe if theta . x is at or below the threshold,
+// with x the channel sums and the width times sample_count
+constexpr uint8_t pca_shift = 14; // Fraction bits of theta
+constexpr int16_t pca_theta[5] PROGMEM = {10735, 7716, 7283, 6359, 420};
+constexpr int32_t pca_threshold = 161586560;
+constexpr bool pca_ripe_above = false;
+
+// Decision trees in preorder: a node continues with the next node if input <= threshold,
+// otherwise with the node right entries further. Inputs: 0=red, 1=green, 2=blue, 3=ambient, 4=width, 5=red - ambient, 6=green - ambient, 7=blue - ambient
+// (channel sums, width [mm])
+constexpr uint8_t decision_tree_leaf = 0xFF; // Feature of a leaf, whose threshold is its probability
+constexpr RipenessModels::TreeNode decision_tree_nodes[13] PROGMEM = {
+    {1, 10, 4605},
+    {6, 8, 1820},
+    {4, 4, 17},
+    {5, 2, 3499},
+    {255, 0, 0},
+    {255, 0, 29319},
+    {2, 2, 4364},
+    {255, 0, 32477},
+    {255, 0, 13107},
+    {255, 0, 0},
+    {1, 2, 4798},
+    {255, 0, 6554},
+    {255, 0, 0},
+};
+
+// Random forest: the trees are stored one after the other, the probability is their mean
+constexpr uint8_t decision_forest_tree_count = 8;
+constexpr uint8_t decision_forest_roots[8] PROGMEM = {0, 15, 24, 41, 54, 69, 88, 105};
+constexpr RipenessModels::TreeNode decision_forest_nodes[120] PROGMEM = {
+    {1, 12, 4431},
+    {3, 8, 2296},
+    {7, 4, 1176},
+    {5, 2, 2632},
+    {255, 0, 0},
+    {255, 0, 29999},
+    {6, 2, 1806},
+    {255, 0, 21845},
+    {255, 0, 0},
+    {2, 2, 4577},
+    {255, 0, 32768},
+    {255, 0, 0},
+    {7, 2, 358},
+    {255, 0, 5461},
+    {255, 0, 0},
+    {1, 8, 4556},
+    {6, 6, 1772},
+    {5, 2, 1381},
+    {255, 0, 0},
+    {7, 2, 712},
+    {255, 0, 32768},
+    {255, 0, 25443},
+    {255, 0, 0},
+    {255, 0, 0},
+    {1, 16, 4605},
+    {7, 8, 1163},
+    {7, 4, 514},
+    {6, 2, 36},
+    {255, 0, 23406},
+    {255, 0, 32768},
+    {3, 2, 1237},
+    {255, 0, 31020},
+    {255, 0, 14418},
+    {1, 4, 2701},
+    {2, 2, 1597},
+    {255, 0, 0},
+    {255, 0, 32768},
+    {1, 2, 3231},
+    {255, 0, 6554},
+    {255, 0, 0},
+    {255, 0, 0},
+    {2, 12, 4484},
+    {7, 6, 1176},
+    {6, 2, 868},
+    {255, 0, 32768},
+    {3, 2, 1247},
+    {255, 0, 30559},
+    {255, 0, 6144},
+    {1, 4, 3175},
+    {0, 2, 5077},
+    {255, 0, 0},
+    {255, 0, 10923},
+    {255, 0, 0},
+    {255, 0, 0},
+    {1, 12, 4605},
+    {4, 6, 17},
+    {3, 4, 1247},
+    {7, 2, 888},
+    {255, 0, 16384},
+    {255, 0, 30247},
+    {255, 0, 0},
+    {6, 4, 1823},
+    {7, 2, 511},
+    {255, 0, 32681},
+    {255, 0, 29597},
+    {255, 0, 0},
+    {6, 2, 304},
+    {255, 0, 10923},
+    {255, 0, 0},
+    {2, 16, 4408},
+    {5, 8, 4154},
+    {6, 4, 975},
+    {6, 2, 848},
+    {255, 0, 32768},
+    {255, 0, 26214},
+    {2, 2, 2019},
+    {255, 0, 26624},
+    {255, 0, 6036},
+    {7, 4, 1177},
+    {0, 2, 5983},
+    {255, 0, 32768},
+    {255, 0, 26214},
+    {1, 2, 2857},
+    {255, 0, 7562},
+    {255, 0, 0},
+    {1, 2, 4972},
+    {255, 0, 6554},
+    {255, 0, 0},
+    {1, 14, 4605},
+    {3, 8, 1864},
+    {2, 4, 2343},
+    {6, 2, 1839},
+    {255, 0, 30922},
+    {255, 0, 0},
+    {4, 2, 22},
+    {255, 0, 0},
+    {255, 0, 18725},
+    {2, 4, 4657},
+    {7, 2, 490},
+    {255, 0, 32768},
+    {255, 0, 21845},
+    {255, 0, 0},
+    {0, 2, 6861},
+    {255, 0, 3641},
+    {255, 0, 0},
+    {1, 12, 4556},
+    {7, 6, 1164},
+    {2, 4, 4364},
+    {0, 2, 4727},
+    {255, 0, 23059},
+    {255, 0, 32622},
+    {255, 0, 10923},
+    {5, 4, 5017},
+    {7, 2, 1313},
+    {255, 0, 4468},
+    {255, 0, 0},
+    {255, 0, 21845},
+    {1, 2, 4704},
+    {255, 0, 6554},
+    {255, 0, 0},
+};
+
+// Self-check: channel sums and width of rows of the dataset and the expected probabilities [2^-p_shift]
+constexpr uint8_t check_count = 8;
+constexpr int16_t check_inputs[8][5] = {
+    {7792, 6518, 6240, 5665, 28},
+    {8161, 7094, 6842, 6279, 28},
+    {5368, 2901, 2766, 2547, 28},
+    {6394, 3976, 3840, 3551, 28},
+    {6476, 4267, 4150, 3887, 28},
+    {7002, 5170, 4674, 3824, 28},
+    {5608, 3498, 3017, 1572, 17},
+    {5943, 2769, 2319, 1240, 18},
+};
+constexpr uint16_t logistic_regression_check_p[8] = {3012, 2475, 30051, 29275, 28423, 4340, 3562, 28702};
+constexpr uint16_t pca_check_p[8] = {0, 0, 32768, 32768, 32768, 0, 32768, 32768};
+constexpr uint16_t decision_tree_check_p[8] = {0, 0, 32477, 32477, 32477, 0, 0, 32477};
+constexpr uint16_t decision_forest_check_p[8] = {0, 0, 32738, 32738, 32738, 0, 754, 28291};
+} // namespace ripeness_model_data
+
+#endif
@@ -0,0 +1,153 @@
+/**
+ * RipenessModels.cpp
+ *
+ * Fixed-point ripeness models implementation.
+ * The coefficients are read from flash, see RipenessModelData.h.
+ */
+
+#include <Arduino.h>
+
+#include "RipenessModels.h"
+#include "RipenessModelData.h"
+
+using namespace ripeness_model_data;
+
+const uint8_t RipenessModels::p_shift = ripeness_model_data::p_shift;
+
+/**
+ * Calculates the output of the linear model.
+ * Multiplies int16 weights with int16 inputs into an int32 sum; the sums of
+ * 10 samples of a 10 bit ADC fit int16 and the sum of the products fits int32.
+ * @param channel_sums Sums of measure_count samples per channel (r, g, b, ambient)
+ * @param width Width of the raspberry [mm]
+ * @return Model output, positive for unripe [2^-20]
+ */
+int32_t RipenessModels::LogisticRegression::get_z_q(const int16_t channel_sums[4], int width)
+{
+    int32_t z = (int32_t)pgm_read_dword(&logistic_regression_q_b);
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        z += (int32_t)(int16_t)pgm_read_word(&logistic_regression_q_w[i]) * channel_sums[i];
+    }
+    z += (int32_t)(int16_t)pgm_read_word(&logistic_regression_q_w[4]) * (int16_t)(width * sample_count);
+    return z;
+}
+
+/**
+ * Calculates the probability that the raspberry is ripe.
+ * @param channel_sums Sums of measure_count samples per channel (r, g, b, ambient)
+ * @param width Width of the raspberry [mm]
+ * @return Probability [2^-p_shift]
+ */
+uint16_t RipenessModels::LogisticRegression::get_p_ripe_q(const int16_t channel_sums[4], int width)
+{
+    return LogisticRegression::get_p_ripe_q(LogisticRegression::get_z_q(channel_sums, width));
+}
+
+/**
+ * Applies the soft sigmoid to the model output.
+ * The soft sigmoid 0.5 * (z / (1 + |z|) + 1) of the unripe probability leaves
+ * 0.5 / (1 + |z|) on the far side of 0.5, which takes a single division.
+ * @param z_q Model output [2^-20]
+ * @return Probability that the raspberry is ripe [2^-p_shift]
+ */
+uint16_t RipenessModels::LogisticRegression::get_p_ripe_q(int32_t z_q)
+{
+    int32_t z = z_q >> (logistic_regression_q_shift - logistic_regression_sigmoid_shift);
+    uint32_t magnitude = z < 0 ? -z : z;
+    uint32_t half_tail = (1UL << (logistic_regression_sigmoid_shift + ripeness_model_data::p_shift - 1)) / ((1UL << logistic_regression_sigmoid_shift) + magnitude);
+
+    // Label map: 0=ripe, 1=unripe (model predicts unripe)
+    return z >= 0 ? half_tail : (1U << ripeness_model_data::p_shift) - half_tail;
+}
+
+/**
+ * Classifies a measurement by projecting it onto the principal component.
+ * @param channel_sums Sums of measure_count samples per channel (r, g, b, ambient)
+ * @param width Width of the raspberry [mm]
+ * @return Probability that the raspberry is ripe, 0 or 1 [2^-p_shift]
+ */
+uint16_t RipenessModels::PrincipalComponent::get_p_ripe_q(const int16_t channel_sums[4], int width)
+{
+    int32_t projection = 0;
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        projection += (int32_t)(int16_t)pgm_read_word(&pca_theta[i]) * channel_sums[i];
+    }
+    projection += (int32_t)(int16_t)pgm_read_word(&pca_theta[4]) * (int16_t)(width * sample_count);
+
+    bool above = projection > pca_threshold;
+    return above == pca_ripe_above ? (1U << ripeness_model_data::p_shift) : 0;
+}
+
+/**
+ * Calculates the inputs of the decision trees, in the order of the generated feature indices.
+ * All of them are raw ADC sums or differences of them, so no normalization is needed.
+ * @param channel_sums Sums of measure_count samples per channel (r, g, b, ambient)
+ * @param width Width of the raspberry [mm]
+ * @param inputs Inputs of the trees (r, g, b, ambient, width, r - ambient, g - ambient, b - ambient)
+ */
+static void get_tree_inputs(const int16_t channel_sums[4], int width, uint16_t inputs[8])
+{
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        inputs[i] = channel_sums[i];
+    }
+    inputs[4] = width;
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        int16_t denoised = channel_sums[i] - channel_sums[3];
+        inputs[5 + i] = denoised > 0 ? denoised : 0;
+    }
+}
+
+/**
+ * Walks a tree from the root to a leaf.
+ * The step to the next node is computed, not branched on, so only the loop
+ * condition depends on the path through the tree.
+ * @param node Root of the tree in flash
+ * @param inputs Inputs of the trees
+ * @return Probability of the leaf [2^-p_shift]
+ */
+static uint16_t walk_tree(const RipenessModels::TreeNode *node, const uint16_t inputs[8])
+{
+    uint8_t feature;
+    while ((feature = pgm_read_byte(&node->feature)) != decision_tree_leaf)
+    {
+        uint8_t go_right = inputs[feature] > pgm_read_word(&node->threshold);
+        node += 1 + ((pgm_read_byte(&node->right) - 1) & -go_right);
+    }
+    return pgm_read_word(&node->threshold);
+}
+
+/**
+ * Classifies a measurement by walking the tree from the root to a leaf.
+ * @param channel_sums Sums of measure_count samples per channel (r, g, b, ambient)
+ * @param width Width of the raspberry [mm]
+ * @return Share of ripe berries in the leaf [2^-p_shift]
+ */
+uint16_t RipenessModels::DecisionTree::get_p_ripe_q(const int16_t channel_sums[4], int width)
+{
+    uint16_t inputs[8];
+    get_tree_inputs(channel_sums, width, inputs);
+    return walk_tree(decision_tree_nodes, inputs);
+}
+
+/**
+ * Classifies a measurement by averaging the leaves of all trees.
+ * @param channel_sums Sums of measure_count samples per channel (r, g, b, ambient)
+ * @param width Width of the raspberry [mm]
+ * @return Mean share of ripe berries in the leaves [2^-p_shift]
+ */
+uint16_t RipenessModels::DecisionForest::get_p_ripe_q(const int16_t channel_sums[4], int width)
+{
+    uint16_t inputs[8];
+    get_tree_inputs(channel_sums, width, inputs);
+
+    uint32_t p_sum = 0;
+    for (uint8_t tree = 0; tree < decision_forest_tree_count; tree++)
+    {
+        p_sum += walk_tree(decision_forest_nodes + pgm_read_byte(&decision_forest_roots[tree]), inputs);
+    }
+    return p_sum / decision_forest_tree_count;
+}
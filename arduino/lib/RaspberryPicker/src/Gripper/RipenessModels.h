@@ -0,0 +1,115 @@
+/**
+ * RipenessModels.h
+ *
+ * Fixed-point ripeness models, evaluated on the ADC sums of a color measurement.
+ * Their coefficients are generated by data/classifier/export.py into RipenessModelData.h,
+ * so retraining does not touch this code. Each model provides the same static interface,
+ * so the firmware selects one at compile time with the template parameter of
+ * ColorSensor::get_ripeness_p_q():
+ *
+ *   static uint16_t get_p_ripe_q(const int16_t channel_sums[4], int width);
+ *
+ * which returns the probability that the raspberry is ripe [2^-p_shift].
+ */
+
+#ifndef RASPBERRY_PICKER_GRIPPER_RIPENESS_MODELS_H
+#define RASPBERRY_PICKER_GRIPPER_RIPENESS_MODELS_H
+
+#include <Arduino.h>
+
+namespace RipenessModels
+{
+    extern const uint8_t p_shift; // Fraction bits of the probabilities
+
+    /**
+     * LogisticRegression - logistic regression with the normalization folded into int16 weights.
+     * Most accurate model; one 32 bit division for the sigmoid.
+     */
+    struct LogisticRegression
+    {
+        /**
+         * Calculates the output of the linear model.
+         * @param channel_sums Sums of measure_count samples per channel (r, g, b, ambient)
+         * @param width Width of the raspberry [mm]
+         * @return Model output, positive for unripe [2^-20]
+         */
+        static int32_t get_z_q(const int16_t channel_sums[4], int width);
+
+        /**
+         * Calculates the probability that the raspberry is ripe.
+         * @param channel_sums Sums of measure_count samples per channel (r, g, b, ambient)
+         * @param width Width of the raspberry [mm]
+         * @return Probability [2^-p_shift]
+         */
+        static uint16_t get_p_ripe_q(const int16_t channel_sums[4], int width);
+
+        /**
+         * Applies the soft sigmoid 0.5 * (z / (1 + |z|) + 1) and returns the ripe side.
+         * @param z_q Model output [2^-20]
+         * @return Probability that the raspberry is ripe [2^-p_shift]
+         */
+        static uint16_t get_p_ripe_q(int32_t z_q);
+    };
+
+    /**
+     * PrincipalComponent - threshold on the first principal component of the features.
+     * Cheapest model, five multiply-adds; only decides ripe (1) or unripe (0).
+     */
+    struct PrincipalComponent
+    {
+        /**
+         * Classifies a measurement by projecting it onto the principal component.
+         * @param channel_sums Sums of measure_count samples per channel (r, g, b, ambient)
+         * @param width Width of the raspberry [mm]
+         * @return Probability that the raspberry is ripe, 0 or 1 [2^-p_shift]
+         */
+        static uint16_t get_p_ripe_q(const int16_t channel_sums[4], int width);
+    };
+
+    /**
+     * TreeNode - node of a decision tree, stored in flash.
+     * The nodes of a tree are stored in preorder, so the left child directly follows its parent.
+     * feature: Index of the compared input, decision_tree_leaf for a leaf
+     * right: Offset of the right child from this node
+     * threshold: Inputs up to it go left; the probability that the raspberry is ripe [2^-p_shift] in a leaf
+     */
+    struct TreeNode
+    {
+        uint8_t feature;
+        uint8_t right;
+        uint16_t threshold;
+    };
+
+    /**
+     * DecisionTree - decision tree with integer thresholds on the channel sums,
+     * the width and the channel sums minus the ambient sum.
+     * A few comparisons, no multiplication; the leaves hold the share of ripe berries.
+     */
+    struct DecisionTree
+    {
+        /**
+         * Classifies a measurement by walking the tree from the root to a leaf.
+         * @param channel_sums Sums of measure_count samples per channel (r, g, b, ambient)
+         * @param width Width of the raspberry [mm]
+         * @return Share of ripe berries in the leaf [2^-p_shift]
+         */
+        static uint16_t get_p_ripe_q(const int16_t channel_sums[4], int width);
+    };
+
+    /**
+     * DecisionForest - random forest of small decision trees on the same inputs as DecisionTree.
+     * Smoother probabilities than a single tree, at the cost of walking every tree.
+     */
+    struct DecisionForest
+    {
+        /**
+         * Classifies a measurement by averaging the leaves of all trees.
+         * @param channel_sums Sums of measure_count samples per channel (r, g, b, ambient)
+         * @param width Width of the raspberry [mm]
+         * @return Mean share of ripe berries in the leaves [2^-p_shift]
+         */
+        static uint16_t get_p_ripe_q(const int16_t channel_sums[4], int width);
+    };
+}
+
+#endif
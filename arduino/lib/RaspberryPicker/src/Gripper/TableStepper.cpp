@@ -0,0 +1,225 @@
+/**
+ * TableStepper.cpp
+ *
+ * Polled stepper backend implementation for the gripper plate motor.
+ * A step costs a micros() call, a table lookup and the coil outputs;
+ * the profile is only recomputed when speed or acceleration change.
+ */
+
+#include <Arduino.h>
+
+#include "TableStepper.h"
+
+const long TableStepper::tick_hz = 250000; // 4us, the resolution of micros() at 16 MHz
+
+/**
+ * Constructor - configures the motor pins.
+ * @param interface Motor interface type (ignored, always half-step 4-wire)
+ * @param pin1 First motor pin
+ * @param pin2 Second motor pin
+ * @param pin3 Third motor pin
+ * @param pin4 Fourth motor pin
+ */
+TableStepper::TableStepper(uint8_t /*interface*/, uint8_t pin1, uint8_t pin2, uint8_t pin3, uint8_t pin4)
+    : profile(TableStepper::tick_hz)
+{
+    uint8_t pins[4] = {pin1, pin2, pin3, pin4};
+    for (int i = 0; i < 4; i++)
+    {
+        this->pins[i] = pins[i];
+        pinMode(pins[i], OUTPUT);
+    }
+
+    this->position = 0;
+    this->remaining = 0;
+    this->ramp_steps = 0;
+    this->direction = 0;
+    this->accelerated = false;
+    this->level = 0;
+    this->interval_us = 0;
+    this->last_step_us = 0;
+
+    this->max_speed = 1;
+    this->acceleration = 1;
+    this->constant_speed = 0;
+}
+
+/**
+ * Starts an accelerated move to an absolute position.
+ * A move in the same direction keeps its current speed level.
+ * @param absolute Target position [steps]
+ */
+void TableStepper::moveTo(long absolute)
+{
+    long steps = absolute - this->position;
+    if (steps == 0)
+    {
+        return;
+    }
+    this->start_motion(steps > 0 ? steps : -steps, steps > 0 ? 1 : -1, true, 0);
+}
+
+/**
+ * Steps if a step is due.
+ * The interval of the next step is taken from the profile: one level up while
+ * accelerating, one level down once the remaining steps are needed to stop.
+ * @return true while the motor is running
+ */
+bool TableStepper::run()
+{
+    if (this->direction == 0)
+    {
+        return false;
+    }
+    uint32_t now_us = micros();
+    if (now_us - this->last_step_us < this->interval_us)
+    {
+        return true;
+    }
+    this->last_step_us = now_us;
+
+    this->position += this->direction;
+    this->output_step(this->position);
+    this->ramp_steps++;
+
+    if (this->remaining > 0)
+    {
+        this->remaining--;
+        if (this->remaining == 0)
+        {
+            this->direction = 0;
+            return false;
+        }
+    }
+
+    if (this->accelerated)
+    {
+        this->level = this->profile.get_next_level(this->level, this->ramp_steps, this->remaining);
+        this->interval_us = (uint32_t)this->profile.get_interval(this->level) * (1000000 / TableStepper::tick_hz);
+    }
+    return true;
+}
+
+/**
+ * Steps at the speed set with setSpeed() if a step is due.
+ * Starts a constant-speed move if none is running in that direction.
+ * @return true while the motor is running
+ */
+bool TableStepper::runSpeed()
+{
+    if (this->constant_speed == 0)
+    {
+        return false;
+    }
+    int8_t constant_direction = this->constant_speed > 0 ? 1 : -1;
+    if (this->direction != constant_direction || this->accelerated)
+    {
+        float speed = this->constant_speed > 0 ? this->constant_speed : -this->constant_speed;
+        this->start_motion(-1, constant_direction, false, (uint32_t)(1000000 / speed));
+    }
+    return this->run();
+}
+
+/**
+ * Checks whether the motor is currently moving.
+ */
+bool TableStepper::isRunning()
+{
+    return this->direction != 0;
+}
+
+/**
+ * Gets the current motor position.
+ * @return Position [steps]
+ */
+long TableStepper::currentPosition()
+{
+    return this->position;
+}
+
+/**
+ * Gets the time the next step is due.
+ * @return micros() of the next step, only valid while the motor is running [us]
+ */
+uint32_t TableStepper::get_next_step_us()
+{
+    return this->last_step_us + this->interval_us;
+}
+
+/**
+ * Stops the motor and redefines the current position.
+ * @param position New current position [steps]
+ */
+void TableStepper::setCurrentPosition(long position)
+{
+    this->direction = 0;
+    this->position = position;
+}
+
+/**
+ * Sets the speed for constant-speed moves. A speed of 0 stops the motor.
+ * @param speed Speed [steps/sec], negative to close
+ */
+void TableStepper::setSpeed(float speed)
+{
+    this->constant_speed = speed;
+    if (speed == 0)
+    {
+        this->direction = 0;
+    }
+}
+
+/**
+ * Sets the maximum speed and recomputes the acceleration profile.
+ * @param speed Maximum speed [steps/sec]
+ */
+void TableStepper::setMaxSpeed(float speed)
+{
+    this->max_speed = speed;
+    this->profile.compute(this->max_speed, this->acceleration);
+}
+
+/**
+ * Sets the acceleration and recomputes the acceleration profile.
+ * @param acceleration Acceleration [steps/sec²]
+ */
+void TableStepper::setAcceleration(float acceleration)
+{
+    this->acceleration = acceleration;
+    this->profile.compute(this->max_speed, this->acceleration);
+}
+
+/**
+ * Starts a move.
+ * @param steps Number of steps to move (-1 for an endless constant-speed move)
+ * @param direction 1 to open (increasing position), -1 to close
+ * @param accelerated Whether to follow the acceleration profile
+ * @param interval_us Step interval for constant-speed moves [us]
+ */
+void TableStepper::start_motion(long steps, int8_t direction, bool accelerated, uint32_t interval_us)
+{
+    bool continuing = accelerated && this->accelerated && this->direction == direction;
+    if (!continuing)
+    {
+        this->level = 0;
+        this->ramp_steps = 0;
+        this->interval_us = accelerated ? (uint32_t)this->profile.get_interval(0) * (1000000 / TableStepper::tick_hz) : interval_us;
+        this->last_step_us = micros() - this->interval_us; // first step on the next run()
+    }
+    this->remaining = steps;
+    this->accelerated = accelerated;
+    this->direction = direction;
+}
+
+/**
+ * Energizes the coils for the given position in the half-step sequence.
+ * @param position Motor position [steps]
+ */
+void TableStepper::output_step(long position)
+{
+    uint8_t pattern = MotionProfile::get_coil_pattern(position);
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        digitalWrite(this->pins[i], (pattern & (1 << i)) ? HIGH : LOW);
+    }
+}
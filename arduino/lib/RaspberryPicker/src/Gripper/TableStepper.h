@@ -0,0 +1,127 @@
+/**
+ * TableStepper.h
+ *
+ * Polled stepper backend for the gripper plate motor with a precomputed acceleration profile.
+ * Steps from the motion loop like AccelStepper, but looks the step interval up in
+ * a fixed-point table (see MotionProfile.h) instead of computing the next speed with
+ * floating point math on every step, so the step rate is limited by the motor
+ * rather than by the CPU of an AVR without FPU.
+ *
+ * Provides the subset of the AccelStepper interface used by the gripper,
+ * so it can replace AccelStepper when RASPBERRY_PICKER_TABLE_STEPPER is defined.
+ */
+
+#ifndef RASPBERRY_PICKER_GRIPPER_TABLE_STEPPER_H
+#define RASPBERRY_PICKER_GRIPPER_TABLE_STEPPER_H
+
+#include <Arduino.h>
+
+#include "MotionProfile.h"
+
+/**
+ * TableStepper class - steps a HALF4WIRE stepper motor from the motion loop.
+ */
+class TableStepper
+{
+public:
+    static const long tick_hz;  // Unit of the profile intervals [Hz]
+
+    /**
+     * Constructor - configures the motor pins.
+     * Takes the same arguments as AccelStepper; only HALF4WIRE is supported.
+     * @param interface Motor interface type (ignored, always half-step 4-wire)
+     * @param pin1 First motor pin
+     * @param pin2 Second motor pin
+     * @param pin3 Third motor pin
+     * @param pin4 Fourth motor pin
+     */
+    TableStepper(uint8_t interface, uint8_t pin1, uint8_t pin2, uint8_t pin3, uint8_t pin4);
+
+    /**
+     * Starts an accelerated move to an absolute position.
+     * @param absolute Target position [steps]
+     */
+    void moveTo(long absolute);
+
+    /**
+     * Steps if a step is due. Must be called as often as possible while moving.
+     * @return true while the motor is running
+     */
+    bool run();
+
+    /**
+     * Steps at the speed set with setSpeed() if a step is due.
+     * The move ends when a new move is started or the speed is set to 0.
+     * @return true while the motor is running
+     */
+    bool runSpeed();
+
+    /**
+     * Checks whether the motor is currently moving.
+     */
+    bool isRunning();
+
+    /**
+     * Gets the current motor position [steps].
+     */
+    long currentPosition();
+
+    /**
+     * Gets the time the next step is due, e.g. to sleep until then.
+     * @return micros() of the next step, only valid while the motor is running [us]
+     */
+    uint32_t get_next_step_us();
+
+    /**
+     * Stops the motor and redefines the current position.
+     * @param position New current position [steps]
+     */
+    void setCurrentPosition(long position);
+
+    /**
+     * Sets the speed for constant-speed moves. A speed of 0 stops the motor.
+     * @param speed Speed [steps/sec], negative to close
+     */
+    void setSpeed(float speed);
+
+    /**
+     * Sets the maximum speed and recomputes the acceleration profile.
+     * @param speed Maximum speed [steps/sec]
+     */
+    void setMaxSpeed(float speed);
+
+    /**
+     * Sets the acceleration and recomputes the acceleration profile.
+     * @param acceleration Acceleration [steps/sec²]
+     */
+    void setAcceleration(float acceleration);
+
+private:
+    /**
+     * Energizes the coils for the given position in the half-step sequence.
+     */
+    void output_step(long position);
+
+    /**
+     * Starts a move with its first step due right away.
+     */
+    void start_motion(long steps, int8_t direction, bool accelerated, uint32_t interval_us);
+
+    uint8_t pins[4];                 // Motor pins
+
+    float max_speed;                 // Maximum speed [steps/sec]
+    float acceleration;              // Acceleration [steps/sec²]
+    float constant_speed;            // Speed for constant-speed moves [steps/sec]
+    MotionProfile profile;           // Speed levels of the acceleration ramp [ticks]
+
+    long position;                   // Current position [steps]
+    long remaining;                  // Steps left in the current move (-1 for constant speed)
+    long ramp_steps;                 // Steps taken since the move started
+    int8_t direction;                // Direction of the current move (1, -1, or 0 if stopped)
+    bool accelerated;                // Whether the move follows the acceleration profile
+    uint8_t level;                   // Current speed level
+    uint32_t interval_us;            // Current step interval [us]
+    uint32_t last_step_us;           // Time of the last step [us]
+};
+
+#endif
@@ -0,0 +1,163 @@
+/**
+ * BinaryProtocol.cpp
+ *
+ * Compact binary encoding of state updates.
+ * Frames are built in a small stack buffer and COBS-encoded into the caller's buffer,
+ * so they can be queued and written without heap allocation.
+ */
+
+#include "BinaryProtocol.h"
+#include "TelemetryKeys.h"
+
+#include <string.h>
+
+/**
+ * Encodes a numeric state update as INT16, or as INT32 if it does not fit.
+ * Profiler times, durations and counters are exact integers, so they are
+ * not sent as FLOAT, which would round them above 2^24 and format them with decimals.
+ * @param key_id Key ID
+ * @param value Value to encode
+ * @param out Buffer of at least max_frame_length bytes
+ * @return Length of the encoded frame
+ */
+uint8_t BinaryProtocol::encode_number(uint8_t key_id, long value, uint8_t *out)
+{
+    int32_t value_int32 = value;
+    uint8_t bytes[4] = {
+        (uint8_t)(value_int32 & 0xFF),
+        (uint8_t)((value_int32 >> 8) & 0xFF),
+        (uint8_t)((value_int32 >> 16) & 0xFF),
+        (uint8_t)((value_int32 >> 24) & 0xFF),
+    };
+    if (value < -32768 || value > 32767)
+    {
+        return BinaryProtocol::encode_frame(key_id, ValueType::INT32, bytes, sizeof(bytes), out);
+    }
+    return BinaryProtocol::encode_frame(key_id, ValueType::INT16, bytes, 2, out);
+}
+
+/**
+ * Encodes a floating point state update.
+ * @param key_id Key ID
+ * @param value Value to encode
+ * @param out Buffer of at least max_frame_length bytes
+ * @return Length of the encoded frame
+ */
+uint8_t BinaryProtocol::encode_float(uint8_t key_id, float value, uint8_t *out)
+{
+    // AVR floats are IEEE 754 single precision, stored little endian
+    uint8_t bytes[4];
+    memcpy(bytes, &value, sizeof(bytes));
+    return BinaryProtocol::encode_frame(key_id, ValueType::FLOAT, bytes, sizeof(bytes), out);
+}
+
+/**
+ * Encodes a text state update as STRING.
+ * @param key_id Key ID
+ * @param value Value to encode, in flash
+ * @param out Buffer of at least max_frame_length bytes
+ * @return Length of the encoded frame
+ */
+uint8_t BinaryProtocol::encode_text(uint8_t key_id, const __FlashStringHelper *value, uint8_t *out)
+{
+    uint8_t text[BinaryProtocol::max_string_length];
+    size_t length = strlen_P((const char *)value);
+    if (length > BinaryProtocol::max_string_length)
+    {
+        length = BinaryProtocol::max_string_length;
+    }
+    memcpy_P(text, value, length);
+    return BinaryProtocol::encode_frame(key_id, ValueType::STRING, text, length, out);
+}
+
+/**
+ * Encodes the state update of an enum as ENUM.
+ * @param key_id Key ID
+ * @param index Enum value, i.e. the index of its name in the enum declaration
+ * @param out Buffer of at least max_frame_length bytes
+ * @return Length of the encoded frame
+ */
+uint8_t BinaryProtocol::encode_enum(uint8_t key_id, uint8_t index, uint8_t *out)
+{
+    return BinaryProtocol::encode_frame(key_id, ValueType::ENUM, &index, 1, out);
+}
+
+/**
+ * Encodes a free-text log message.
+ * @param message Message to encode, truncated to max_string_length
+ * @param out Buffer of at least max_frame_length bytes
+ * @return Length of the encoded frame
+ */
+uint8_t BinaryProtocol::encode_log(const char *message, uint8_t *out)
+{
+    size_t length = strlen(message);
+    if (length > BinaryProtocol::max_string_length)
+    {
+        length = BinaryProtocol::max_string_length;
+    }
+    return BinaryProtocol::encode_frame(TelemetryKeys::log_key, ValueType::STRING, (const uint8_t *)message, length, out);
+}
+
+/**
+ * Computes the CRC-8 (polynomial 0x07, initial value 0) of a buffer.
+ * @param data Data to check
+ * @param length Number of bytes
+ * @return CRC of the data
+ */
+uint8_t BinaryProtocol::crc8(const uint8_t *data, uint8_t length)
+{
+    uint8_t crc = 0;
+    for (uint8_t i = 0; i < length; i++)
+    {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/**
+ * Adds the CRC and COBS-encodes a frame.
+ * COBS replaces every 0x00 by the distance to the next one, so 0x00 only
+ * appears as the frame delimiter.
+ * @param key_id Key ID
+ * @param type Value type
+ * @param value Value bytes
+ * @param length Number of value bytes
+ * @param out Buffer of at least max_frame_length bytes
+ * @return Length of the encoded frame incl. delimiter
+ */
+uint8_t BinaryProtocol::encode_frame(uint8_t key_id, ValueType type, const uint8_t *value, uint8_t length, uint8_t *out)
+{
+    uint8_t frame[1 + BinaryProtocol::max_string_length + 1];
+    uint8_t frame_length = 0;
+    frame[frame_length++] = ((static_cast<uint8_t>(type) & 0x03) << 6) | (key_id & 0x3F);
+    memcpy(&frame[frame_length], value, length);
+    frame_length += length;
+    frame[frame_length] = BinaryProtocol::crc8(frame, frame_length);
+    frame_length++;
+
+    // COBS encoding - frames are shorter than 254 bytes, so no extra code blocks are needed
+    uint8_t code_position = 0;
+    uint8_t encoded_length = 1;
+    uint8_t code = 1;
+    for (uint8_t i = 0; i < frame_length; i++)
+    {
+        if (frame[i] == 0)
+        {
+            out[code_position] = code;
+            code_position = encoded_length++;
+            code = 1;
+        }
+        else
+        {
+            out[encoded_length++] = frame[i];
+            code++;
+        }
+    }
+    out[code_position] = code;
+    out[encoded_length++] = 0x00; // Frame delimiter
+    return encoded_length;
+}
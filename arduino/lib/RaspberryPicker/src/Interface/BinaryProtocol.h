@@ -0,0 +1,111 @@
+/**
+ * BinaryProtocol.h
+ *
+ * Compact binary encoding of state updates, used instead of key=value lines
+ * once the host has negotiated it.
+ *
+ * Frame layout before encoding:
+ * - Header byte: value type (upper 2 bits) and key ID (lower 6 bits)
+ * - Value: int16, int32 or float (little endian), enum index byte, or string bytes
+ * - CRC-8 (polynomial 0x07) over header and value
+ * Each frame is COBS-encoded and terminated by a 0x00 byte, so the host can
+ * resynchronize after a corrupted frame and detect it by its CRC.
+ */
+
+#ifndef RASPBERRY_PICKER_INTERFACE_BINARY_PROTOCOL_H
+#define RASPBERRY_PICKER_INTERFACE_BINARY_PROTOCOL_H
+
+#include <Arduino.h>
+
+/**
+ * BinaryProtocol class - encodes state updates as COBS frames for the serial port.
+ */
+class BinaryProtocol
+{
+public:
+    /**
+     * ValueType enum - type of the value in a frame.
+     * INT16: Signed 16 bit integer
+     * FLOAT: 32 bit float
+     * ENUM: Index into the value names of an enum key
+     * STRING: Raw characters
+     * INT32: Signed 32 bit integer, sent with the type bits of INT16 and told apart by its 4 value bytes
+     */
+    enum class ValueType
+    {
+        INT16,
+        FLOAT,
+        ENUM,
+        STRING,
+        INT32,
+    };
+
+    static const uint8_t max_string_length = 48;                      // Maximum number of characters in a STRING frame
+    static const uint8_t max_frame_length = max_string_length + 4;    // Maximum encoded frame length incl. delimiter
+
+    /**
+     * Encodes a numeric state update as INT16, or as INT32 if it does not fit.
+     * @param key_id Key ID
+     * @param value Value to encode
+     * @param out Buffer of at least max_frame_length bytes
+     * @return Length of the encoded frame
+     */
+    static uint8_t encode_number(uint8_t key_id, long value, uint8_t *out);
+
+    /**
+     * Encodes a floating point state update.
+     * @param key_id Key ID
+     * @param value Value to encode
+     * @param out Buffer of at least max_frame_length bytes
+     * @return Length of the encoded frame
+     */
+    static uint8_t encode_float(uint8_t key_id, float value, uint8_t *out);
+
+    /**
+     * Encodes a text state update as STRING.
+     * @param key_id Key ID
+     * @param value Value to encode, in flash
+     * @param out Buffer of at least max_frame_length bytes
+     * @return Length of the encoded frame
+     */
+    static uint8_t encode_text(uint8_t key_id, const __FlashStringHelper *value, uint8_t *out);
+
+    /**
+     * Encodes the state update of an enum as ENUM.
+     * @param key_id Key ID
+     * @param index Enum value, i.e. the index of its name in the enum declaration
+     * @param out Buffer of at least max_frame_length bytes
+     * @return Length of the encoded frame
+     */
+    static uint8_t encode_enum(uint8_t key_id, uint8_t index, uint8_t *out);
+
+    /**
+     * Encodes a free-text log message.
+     * @param message Message to encode, truncated to max_string_length
+     * @param out Buffer of at least max_frame_length bytes
+     * @return Length of the encoded frame
+     */
+    static uint8_t encode_log(const char *message, uint8_t *out);
+
+    /**
+     * Computes the CRC-8 (polynomial 0x07, initial value 0) of a buffer.
+     * @param data Data to check
+     * @param length Number of bytes
+     * @return CRC of the data
+     */
+    static uint8_t crc8(const uint8_t *data, uint8_t length);
+
+private:
+    /**
+     * Adds the CRC and COBS-encodes a frame.
+     * @param key_id Key ID
+     * @param type Value type
+     * @param value Value bytes
+     * @param length Number of value bytes
+     * @param out Buffer of at least max_frame_length bytes
+     * @return Length of the encoded frame incl. delimiter
+     */
+    static uint8_t encode_frame(uint8_t key_id, ValueType type, const uint8_t *value, uint8_t length, uint8_t *out);
+};
+
+#endif
@@ -0,0 +1,172 @@
+/**
+ * CommandParser.cpp
+ *
+ * Incremental parser for key=value commands received via serial.
+ * The command table is sorted by key and stored in flash; keys are found by
+ * binary search, comparing against flash with strcmp_P. The config.* keys are
+ * not in the table, they are looked up by the configuration (see Config.h).
+ */
+
+#include "CommandParser.h"
+
+#include <string.h>
+
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#else
+// Flash and RAM share one address space on other platforms
+#define PROGMEM
+#define strcmp_P strcmp
+#define pgm_read_byte(address) (*(const uint8_t *)(address))
+#endif
+
+/**
+ * CommandKey structure - one entry of the command table.
+ * key: Command key
+ * command: Command for the key
+ */
+struct CommandKey
+{
+    char key[24];
+    CommandParser::Command command;
+};
+
+// Command table - must be sorted by key for the binary search
+static const CommandKey command_keys[] PROGMEM = {
+    {"basket.door.state", CommandParser::Command::BASKET_DOOR_STATE},
+    {"basket.sorting.state", CommandParser::Command::BASKET_SORTING_STATE},
+    {"config.store", CommandParser::Command::CONFIG_STORE},
+    {"controller.program", CommandParser::Command::CONTROLLER_PROGRAM},
+    {"controller.state", CommandParser::Command::CONTROLLER_STATE},
+    {"diag.profile", CommandParser::Command::DIAG_PROFILE},
+    {"gripper.gripper_state", CommandParser::Command::GRIPPER_STATE},
+    {"interface.protocol", CommandParser::Command::INTERFACE_PROTOCOL},
+};
+
+/**
+ * Constructor - creates a parser with an empty line buffer.
+ */
+CommandParser::CommandParser()
+{
+    this->length = 0;
+    this->overflow = false;
+    this->command = Command::UNKNOWN;
+    this->key = this->line;
+    this->value = this->line;
+    this->line[0] = '\0';
+}
+
+/**
+ * Adds a received byte to the line buffer.
+ * Lines end with '\n'; a preceding '\r' is removed with the other trailing whitespace.
+ * @param c Received byte
+ * @return true if the byte completed a key=value line; get_command(), get_key() and get_value() are valid until the next call
+ */
+bool CommandParser::feed(char c)
+{
+    if (c != '\n')
+    {
+        if (this->length < CommandParser::line_buffer_size - 1)
+        {
+            this->line[this->length++] = c;
+        }
+        else
+        {
+            this->overflow = true;
+        }
+        return false;
+    }
+
+    bool complete = !this->overflow && this->parse_line();
+    this->length = 0;
+    this->overflow = false;
+    return complete;
+}
+
+/**
+ * Gets the command of the last completed line.
+ * @return Command of the line
+ */
+CommandParser::Command CommandParser::get_command()
+{
+    return this->command;
+}
+
+/**
+ * Gets the key of the last completed line, without surrounding whitespace.
+ * @return Key of the line
+ */
+const char *CommandParser::get_key()
+{
+    return this->key;
+}
+
+/**
+ * Gets the value of the last completed line, without surrounding whitespace.
+ * @return Value of the line
+ */
+const char *CommandParser::get_value()
+{
+    return this->value;
+}
+
+/**
+ * Looks up a key in the command table.
+ * @param key Key to look up
+ * @return Command for the key, CONFIG for other config.* keys, UNKNOWN if it is no command
+ */
+CommandParser::Command CommandParser::find_command(const char *key)
+{
+    int low = 0;
+    int high = sizeof(command_keys) / sizeof(command_keys[0]) - 1;
+    while (low <= high)
+    {
+        int middle = (low + high) / 2;
+        int order = strcmp_P(key, command_keys[middle].key);
+        if (order == 0)
+        {
+            return static_cast<Command>(pgm_read_byte(&command_keys[middle].command));
+        }
+        if (order < 0)
+        {
+            high = middle - 1;
+        }
+        else
+        {
+            low = middle + 1;
+        }
+    }
+    return strncmp(key, "config.", 7) == 0 ? Command::CONFIG : Command::UNKNOWN;
+}
+
+/**
+ * Splits the completed line at the first '=' and looks up the key.
+ * Surrounding whitespace of the line is ignored, like String::trim() did.
+ * @return true if the line is a key=value pair
+ */
+bool CommandParser::parse_line()
+{
+    uint8_t end = this->length;
+    while (end > 0 && (this->line[end - 1] == '\r' || this->line[end - 1] == ' ' || this->line[end - 1] == '\t'))
+    {
+        end--;
+    }
+    this->line[end] = '\0';
+
+    char *key = this->line;
+    while (*key == ' ' || *key == '\t')
+    {
+        key++;
+    }
+
+    char *delimiter = strchr(key, '=');
+    if (delimiter == nullptr || delimiter == key)
+    {
+        return false;
+    }
+    *delimiter = '\0';
+    this->key = key;
+    this->value = delimiter + 1;
+    this->command = CommandParser::find_command(key);
+    return true;
+}
@@ -0,0 +1,99 @@
+/**
+ * CommandParser.h
+ *
+ * Incremental parser for key=value commands received via serial.
+ * Collects bytes into a fixed line buffer and looks the key up in a sorted
+ * table in flash, so parsing never blocks and does not allocate.
+ * Has no dependencies on the rest of the firmware, so it can be benchmarked on the host.
+ */
+
+#ifndef RASPBERRY_PICKER_INTERFACE_COMMAND_PARSER_H
+#define RASPBERRY_PICKER_INTERFACE_COMMAND_PARSER_H
+
+#include <stdint.h>
+
+/**
+ * CommandParser class - turns a byte stream into commands and their values.
+ */
+class CommandParser
+{
+public:
+    /**
+     * Command enum - keys accepted from the host.
+     * UNKNOWN: Key is not a command
+     * BASKET_DOOR_STATE: basket.door.state
+     * BASKET_SORTING_STATE: basket.sorting.state
+     * CONFIG: config.<name>, any configuration value, see get_key()
+     * CONFIG_STORE: config.store
+     * CONTROLLER_PROGRAM: controller.program
+     * CONTROLLER_STATE: controller.state
+     * DIAG_PROFILE: diag.profile
+     * GRIPPER_STATE: gripper.gripper_state
+     * INTERFACE_PROTOCOL: interface.protocol
+     */
+    enum class Command : uint8_t
+    {
+        UNKNOWN,
+        BASKET_DOOR_STATE,
+        BASKET_SORTING_STATE,
+        CONFIG,
+        CONFIG_STORE,
+        CONTROLLER_PROGRAM,
+        CONTROLLER_STATE,
+        DIAG_PROFILE,
+        GRIPPER_STATE,
+        INTERFACE_PROTOCOL,
+    };
+
+    static const uint8_t line_buffer_size = 48;  // Maximum line length incl. terminator; longer lines are discarded
+
+    /**
+     * Constructor - creates a parser with an empty line buffer.
+     */
+    CommandParser();
+
+    /**
+     * Adds a received byte to the line buffer.
+     * @param c Received byte
+     * @return true if the byte completed a key=value line; get_command(), get_key() and get_value() are valid until the next call
+     */
+    bool feed(char c);
+
+    /**
+     * Gets the command of the last completed line.
+     */
+    Command get_command();
+
+    /**
+     * Gets the key of the last completed line, without surrounding whitespace.
+     */
+    const char *get_key();
+
+    /**
+     * Gets the value of the last completed line, without surrounding whitespace.
+     */
+    const char *get_value();
+
+    /**
+     * Looks up a key in the command table.
+     * @param key Key to look up
+     * @return Command for the key, CONFIG for other config.* keys, UNKNOWN if it is no command
+     */
+    static Command find_command(const char *key);
+
+private:
+    /**
+     * Splits the completed line at the first '=' and looks up the key.
+     * @return true if the line is a key=value pair
+     */
+    bool parse_line();
+
+    char line[line_buffer_size];  // Line being received
+    uint8_t length;               // Number of characters in the line buffer
+    bool overflow;                // Whether the current line is too long and is discarded
+    Command command;              // Command of the last completed line
+    const char *key;              // Key of the last completed line
+    const char *value;            // Value of the last completed line
+};
+
+#endif
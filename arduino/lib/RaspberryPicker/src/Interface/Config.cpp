@@ -0,0 +1,191 @@
+/**
+ * Config.cpp
+ *
+ * Persistent configuration of the tuning constants.
+ * The EEPROM record is the layout version, the values and a CRC-16 over both;
+ * keys, defaults and ranges are generated from RASPBERRY_PICKER_CONFIG into flash.
+ */
+
+#include <EEPROM.h>
+
+#include "Config.h"
+#include "StateJournal.h"
+
+ENUM_REFLECTION_DEFINE(Config::Request, RASPBERRY_PICKER_CONFIG_REQUESTS, config_request_names)
+ENUM_REFLECTION_DEFINE(Config::Status, RASPBERRY_PICKER_CONFIG_STATUSES, config_status_names)
+
+#define CONFIG_KEY(id, member, key, value, min, max) static const char config_key_##id[] PROGMEM = key;
+#define CONFIG_ENTRY(id, member, key, value, min, max) {config_key_##id, min, max},
+#define CONFIG_DEFAULT(id, member, key, value, min, max) value,
+
+/**
+ * FieldInfo structure - key and limits of a configuration value, in flash.
+ * key: Key (in flash)
+ * min: Smallest accepted value
+ * max: Largest accepted value
+ */
+struct FieldInfo
+{
+    const char *key;
+    int16_t min;
+    int16_t max;
+};
+
+RASPBERRY_PICKER_CONFIG(CONFIG_KEY)
+
+// Keys and limits, the position in the table is the field ID
+static const FieldInfo fields[] PROGMEM = {
+    RASPBERRY_PICKER_CONFIG(CONFIG_ENTRY)
+};
+
+// Default values, in the layout of Config::Values
+static const Config::Values defaults PROGMEM = {
+    RASPBERRY_PICKER_CONFIG(CONFIG_DEFAULT)
+};
+
+// Start with the defaults, so the values are valid before load()
+Config::Values Config::values = {
+    RASPBERRY_PICKER_CONFIG(CONFIG_DEFAULT)
+};
+
+#undef CONFIG_KEY
+#undef CONFIG_ENTRY
+#undef CONFIG_DEFAULT
+
+/**
+ * Record structure - layout of the configuration in EEPROM.
+ * version: Layout version, see Config::version
+ * values: Configuration values
+ * crc: CRC-16 of version and values
+ */
+struct Record
+{
+    uint8_t version;
+    Config::Values values;
+    uint16_t crc;
+};
+
+// The journal slots follow the record
+static_assert(sizeof(Record) <= StateJournal::start_address, "configuration record overlaps the StateJournal");
+
+const uint8_t Config::version = 2; // Increase when RASPBERRY_PICKER_CONFIG changes
+const int Config::record_address = 0;
+
+/**
+ * Loads the values from the EEPROM record, or the defaults if the record is invalid.
+ * A new device reads as 0xFF, which fails the version check.
+ * @return LOADED, or DEFAULTS if the record was invalid
+ */
+Config::Status Config::load()
+{
+    Record record;
+    EEPROM.get(Config::record_address, record);
+    if (record.version != Config::version || record.crc != Config::crc(record.version, record.values))
+    {
+        Config::reset();
+        return Status::DEFAULTS;
+    }
+    Config::values = record.values;
+    return Status::LOADED;
+}
+
+/**
+ * Writes the values to the EEPROM record.
+ * EEPROM.put() only writes bytes that changed, so saving one changed value costs
+ * the value and the CRC (about 13 ms and four of the 100 000 write cycles of the cells).
+ * @return SAVED
+ */
+Config::Status Config::save()
+{
+    Record record;
+    record.version = Config::version;
+    record.values = Config::values;
+    record.crc = Config::crc(record.version, record.values);
+    EEPROM.put(Config::record_address, record);
+    return Status::SAVED;
+}
+
+/**
+ * Restores the default values, without writing them to EEPROM.
+ */
+void Config::reset()
+{
+    memcpy_P(&Config::values, &defaults, sizeof(Config::values));
+}
+
+/**
+ * Finds a configuration value by its key.
+ * @param key Key, e.g. "config.basket.door.open_pos"
+ * @param out_field Pointer to store the field
+ * @return true if the key is a configuration value
+ */
+bool Config::find(const char *key, Field *out_field)
+{
+    for (uint8_t i = 0; i < Config::field_count; i++)
+    {
+        if (strcmp_P(key, (const char *)pgm_read_ptr(&fields[i].key)) == 0)
+        {
+            *out_field = static_cast<Field>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Gets the key of a configuration value.
+ * @param field Field
+ * @return Key in flash
+ */
+const __FlashStringHelper *Config::get_key(Field field)
+{
+    return (const __FlashStringHelper *)pgm_read_ptr(&fields[static_cast<uint8_t>(field)].key);
+}
+
+/**
+ * Gets a configuration value.
+ * @param field Field
+ * @return Value
+ */
+int16_t Config::get(Field field)
+{
+    return ((const int16_t *)&Config::values)[static_cast<uint8_t>(field)];
+}
+
+/**
+ * Changes a configuration value in SRAM, if it is within the range of the field.
+ * @param field Field
+ * @param value New value
+ * @return CHANGED, or REJECTED if the value is out of range
+ */
+Config::Status Config::set(Field field, int16_t value)
+{
+    const FieldInfo *info = &fields[static_cast<uint8_t>(field)];
+    if (value < (int16_t)pgm_read_word(&info->min) || value > (int16_t)pgm_read_word(&info->max))
+    {
+        return Status::REJECTED;
+    }
+    ((int16_t *)&Config::values)[static_cast<uint8_t>(field)] = value;
+    return Status::CHANGED;
+}
+
+/**
+ * Calculates the CRC-16 (CCITT, polynomial 0x1021) of the record contents.
+ * @param version Layout version stored in the record
+ * @param values Values stored in the record
+ * @return CRC
+ */
+uint16_t Config::crc(uint8_t version, const Values &values)
+{
+    uint16_t crc = 0xFFFF;
+    const uint8_t *bytes = (const uint8_t *)&values;
+    for (uint8_t i = 0; i <= sizeof(Values); i++)
+    {
+        crc ^= (uint16_t)(i == 0 ? version : bytes[i - 1]) << 8;
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
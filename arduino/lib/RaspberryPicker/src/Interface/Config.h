@@ -0,0 +1,184 @@
+/**
+ * Config.h
+ *
+ * Persistent configuration of the tuning constants (servo positions, plate distances,
+ * stepper speeds, delays and color sensor timing).
+ * The values are kept in one compact struct in SRAM, which is loaded at boot from a
+ * versioned, CRC-checked record in EEPROM and falls back to the defaults below
+ * if the record is missing, from an older firmware or corrupt.
+ *
+ * The host reads and writes single values with config.<name>=? and config.<name>=<value>,
+ * e.g. config.basket.door.open_pos=12; changes take effect at once and are written to
+ * EEPROM with config.store=SAVE. Values are reported as a config.key, config.value pair,
+ * see InterfaceMaster.
+ */
+
+#ifndef RASPBERRY_PICKER_INTERFACE_CONFIG_H
+#define RASPBERRY_PICKER_INTERFACE_CONFIG_H
+
+#include <Arduino.h>
+
+#include "EnumReflection.h"
+
+// Configuration values as X(ID, member, key, default, minimum, maximum).
+// Changing the list changes the record layout - increase Config::version with it
+#define RASPBERRY_PICKER_CONFIG(X) \
+    X(BASKET_SORTING_SMALL_POS, basket_sorting_small_pos, "config.basket.sorting.small_pos", 20, 0, 180) \
+    X(BASKET_SORTING_IDLE_POS, basket_sorting_idle_pos, "config.basket.sorting.idle_pos", 86, 0, 180) \
+    X(BASKET_SORTING_LARGE_POS, basket_sorting_large_pos, "config.basket.sorting.large_pos", 152, 0, 180) \
+    X(BASKET_DOOR_CLOSED_POS, basket_door_closed_pos, "config.basket.door.closed_pos", 170, 0, 180) \
+    X(BASKET_DOOR_OPEN_POS, basket_door_open_pos, "config.basket.door.open_pos", 10, 0, 180) \
+    X(BASKET_DOOR_MAX_FILL, basket_door_max_fill, "config.basket.door.max_fill", 23, 1, 1000) \
+    X(BASKET_DOOR_DELAY_MS, basket_door_delay_ms, "config.basket.door.delay_ms", 10000, 0, 30000) \
+    X(GRIPPER_PLATE_DISTANCE_OPEN, gripper_plate_distance_open, "config.gripper.plate_distance.open", 65, 13, 80) \
+    X(GRIPPER_PLATE_DISTANCE_LARGE, gripper_plate_distance_large, "config.gripper.plate_distance.large", 30, 13, 80) \
+    X(GRIPPER_PLATE_DISTANCE_SMALL, gripper_plate_distance_small, "config.gripper.plate_distance.small", 20, 13, 80) \
+    X(GRIPPER_PLATE_DISTANCE_LIMIT, gripper_plate_distance_limit, "config.gripper.plate_distance.limit", 13, 0, 80) \
+    X(GRIPPER_SPEED, gripper_speed, "config.gripper.speed", 200, 10, 2000) \
+    X(GRIPPER_MAX_SPEED, gripper_max_speed, "config.gripper.max_speed", 1200, 10, 2000) \
+    X(GRIPPER_ACCELERATION, gripper_acceleration, "config.gripper.acceleration", 300, 10, 10000) \
+    X(GRIPPER_BERRY_SIZE_THRESHOLD_MM, gripper_berry_size_threshold_mm, "config.gripper.berry_size_threshold_mm", 21, 13, 65) \
+    X(GRIPPER_PICKING_DELAY_MS, gripper_picking_delay_ms, "config.gripper.picking_delay_ms", 10000, 0, 30000) \
+    X(GRIPPER_HOMING_SEARCH_MM, gripper_homing_search_mm, "config.gripper.homing.search_mm", 10, 1, 80) \
+    X(GRIPPER_HOMING_BACK_OFF_MM, gripper_homing_back_off_mm, "config.gripper.homing.back_off_mm", 2, 1, 20) \
+    X(GRIPPER_HOMING_CREEP_SPEED, gripper_homing_creep_speed, "config.gripper.homing.creep_speed", 60, 10, 2000) \
+    X(COLOR_DELAY_PROBE, color_delay_probe, "config.color.delay_probe", 10, 1, 1000) \
+    X(COLOR_DELAY_COLOR, color_delay_color, "config.color.delay_color", 200, 0, 1000) \
+    X(COLOR_SETTLE_PROBE_MS, color_settle_probe_ms, "config.color.settle_probe_ms", 5, 1, 100) \
+    X(COLOR_SETTLE_THRESHOLD, color_settle_threshold, "config.color.settle_threshold", 1, 0, 100) \
+    X(COLOR_SETTLE_STABLE_COUNT, color_settle_stable_count, "config.color.settle_stable_count", 3, 1, 20)
+
+// Values of Config::Request
+#define RASPBERRY_PICKER_CONFIG_REQUESTS(X) \
+    X(REPORT) \
+    X(SAVE) \
+    X(LOAD) \
+    X(DEFAULTS)
+
+// Values of Config::Status
+#define RASPBERRY_PICKER_CONFIG_STATUSES(X) \
+    X(LOADED) \
+    X(DEFAULTS) \
+    X(SAVED) \
+    X(CHANGED) \
+    X(REJECTED)
+
+#define CONFIG_ID(id, member, key, value, min, max) id,
+#define CONFIG_MEMBER(id, member, key, value, min, max) int16_t member;
+#define CONFIG_COUNT(id, member, key, value, min, max) +1
+
+/**
+ * Config class - configuration values and their EEPROM record.
+ */
+class Config
+{
+public:
+    /**
+     * Field enum - IDs of the configuration values, see RASPBERRY_PICKER_CONFIG.
+     */
+    enum class Field : uint8_t
+    {
+        RASPBERRY_PICKER_CONFIG(CONFIG_ID)
+    };
+
+    /**
+     * Request enum - values of the config.store command.
+     * REPORT: Send all values
+     * SAVE: Write the values to EEPROM
+     * LOAD: Discard unsaved changes, reload the values from EEPROM
+     * DEFAULTS: Restore the compiled-in defaults (not saved until SAVE)
+     */
+    enum class Request
+    {
+        RASPBERRY_PICKER_CONFIG_REQUESTS(ENUM_REFLECTION_VALUE)
+    };
+
+    /**
+     * Status enum - reported as config.status.
+     * LOADED: Values were loaded from a valid EEPROM record
+     * DEFAULTS: Values are the defaults, the EEPROM record was missing or invalid
+     * SAVED: Values were written to EEPROM
+     * CHANGED: A value was changed, but not saved yet
+     * REJECTED: A value was out of range or the key unknown, nothing changed
+     */
+    enum class Status
+    {
+        RASPBERRY_PICKER_CONFIG_STATUSES(ENUM_REFLECTION_VALUE)
+    };
+
+    /**
+     * Values structure - one int16_t per configuration value, named by the member column.
+     */
+    struct Values
+    {
+        RASPBERRY_PICKER_CONFIG(CONFIG_MEMBER)
+    };
+
+    static const uint8_t field_count = 0 RASPBERRY_PICKER_CONFIG(CONFIG_COUNT); // Number of values
+    static const uint8_t version;     // Layout version of the EEPROM record
+    static const int record_address;  // EEPROM address of the record, followed by the StateJournal slots
+
+    static Values values; // Values in use
+
+    /**
+     * Loads the values from the EEPROM record, or the defaults if the record is invalid.
+     * Call once during setup, before the controllers are created.
+     * @return LOADED, or DEFAULTS if the record was invalid
+     */
+    static Status load();
+
+    /**
+     * Writes the values to the EEPROM record. Only bytes that changed are written.
+     * @return SAVED
+     */
+    static Status save();
+
+    /**
+     * Restores the default values, without writing them to EEPROM.
+     */
+    static void reset();
+
+    /**
+     * Finds a configuration value by its key.
+     * @param key Key, e.g. "config.basket.door.open_pos"
+     * @param out_field Pointer to store the field
+     * @return true if the key is a configuration value
+     */
+    static bool find(const char *key, Field *out_field);
+
+    /**
+     * Gets the key of a configuration value.
+     * @param field Field
+     * @return Key in flash
+     */
+    static const __FlashStringHelper *get_key(Field field);
+
+    /**
+     * Gets a configuration value.
+     * @param field Field
+     * @return Value
+     */
+    static int16_t get(Field field);
+
+    /**
+     * Changes a configuration value in SRAM, if it is within the range of the field.
+     * @param field Field
+     * @param value New value
+     * @return CHANGED, or REJECTED if the value is out of range
+     */
+    static Status set(Field field, int16_t value);
+
+private:
+    /**
+     * Calculates the CRC-16 (CCITT) of the record contents.
+     * @param version Layout version stored in the record
+     * @param values Values stored in the record
+     * @return CRC
+     */
+    static uint16_t crc(uint8_t version, const Values &values);
+};
+
+ENUM_REFLECTION_DECLARE(Config::Request)
+ENUM_REFLECTION_DECLARE(Config::Status)
+
+#endif
@@ -0,0 +1,53 @@
+/**
+ * EnumReflection.cpp
+ *
+ * Lookup in the enum name tables generated by ENUM_REFLECTION_DEFINE.
+ * Names are compared by hash first, so a lookup reads one word from flash
+ * per entry and compares only the matching name character by character.
+ */
+
+#include "EnumReflection.h"
+
+#include <string.h>
+
+/**
+ * Gets a name from a name table.
+ * @param entries Name table in flash
+ * @param count Number of entries
+ * @param index Index of the name
+ * @return Name in flash, or nullptr if the index is out of range
+ */
+const __FlashStringHelper *EnumReflection::get_name(const EnumName *entries, uint8_t count, uint8_t index)
+{
+    if (index >= count)
+    {
+        return nullptr;
+    }
+    return (const __FlashStringHelper *)pgm_read_ptr(&entries[index].name);
+}
+
+/**
+ * Finds a name in a name table by its hash.
+ * @param entries Name table in flash
+ * @param count Number of entries
+ * @param name Name to find
+ * @return Index of the name, or -1 if it is not in the table
+ */
+int EnumReflection::find(const EnumName *entries, uint8_t count, const char *name)
+{
+    uint16_t name_hash = 5381;
+    for (const char *c = name; *c != '\0'; c++)
+    {
+        name_hash = (uint16_t)((name_hash * 33) ^ (uint8_t)*c);
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (pgm_read_word(&entries[i].hash) == name_hash &&
+            strcmp_P(name, (const char *)pgm_read_ptr(&entries[i].name)) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,156 @@
+/**
+ * EnumReflection.h
+ *
+ * Compile-time reflection for the enums exchanged with the host.
+ * Each enum is declared once as a list macro of its values, e.g.
+ *
+ *     #define RASPBERRY_PICKER_DOOR_STATES(X) X(OPEN) X(CLOSED)
+ *     enum class DoorState { RASPBERRY_PICKER_DOOR_STATES(ENUM_REFLECTION_VALUE) };
+ *     ENUM_REFLECTION_DECLARE(BasketDoor::DoorState)                          // header
+ *     ENUM_REFLECTION_DEFINE(BasketDoor::DoorState, RASPBERRY_PICKER_DOOR_STATES, door_state_names) // source
+ *
+ * The value names and a table of their hashes are generated from the same list and
+ * stored in flash, so names and values cannot get out of order and cost no SRAM.
+ */
+
+#ifndef RASPBERRY_PICKER_INTERFACE_ENUM_REFLECTION_H
+#define RASPBERRY_PICKER_INTERFACE_ENUM_REFLECTION_H
+
+#include <Arduino.h>
+
+/**
+ * EnumName structure - one entry of an enum name table in flash.
+ * name: Value name (in flash)
+ * hash: Hash of the name, compared before the name itself
+ */
+struct EnumName
+{
+    const char *name;
+    uint16_t hash;
+};
+
+/**
+ * EnumTable template - name table of an enum, specialized by ENUM_REFLECTION_DECLARE.
+ */
+template <typename E>
+struct EnumTable;
+
+/**
+ * IsEnum template - whether a type is an enum, as <type_traits> is not available on AVR.
+ */
+template <typename T>
+struct IsEnum
+{
+    static const bool value = __is_enum(T);
+};
+
+/**
+ * EnableIf template - restricts overloads to enums, together with IsEnum.
+ */
+template <bool condition, typename T = void>
+struct EnableIf
+{
+};
+template <typename T>
+struct EnableIf<true, T>
+{
+    typedef T type;
+};
+
+/**
+ * EnumReflection class - converts reflected enums to and from their names.
+ */
+class EnumReflection
+{
+public:
+    /**
+     * Hashes a name (djb2-xor, 16 bit). Usable at compile time.
+     * @param name Name to hash
+     * @param seed Hash of the preceding characters
+     * @return Hash of the name
+     */
+    static constexpr uint16_t hash(const char *name, uint16_t seed = 5381)
+    {
+        return *name == '\0' ? seed : EnumReflection::hash(name + 1, (uint16_t)((seed * 33) ^ (uint8_t)*name));
+    }
+
+    /**
+     * Gets the name of an enum value.
+     * @param value Enum value
+     * @return Name of the value in flash, or nullptr if the value is invalid
+     */
+    template <typename E>
+    static const __FlashStringHelper *serialize(E value)
+    {
+        return EnumReflection::get_name(EnumTable<E>::entries, EnumTable<E>::count, static_cast<uint8_t>(value));
+    }
+
+    /**
+     * Finds the enum value of a name.
+     * @param name Name of the value
+     * @param out_value Pointer to store the value
+     * @return true if the name matched a value, false otherwise
+     */
+    template <typename E>
+    static bool deserialize(const char *name, E *out_value)
+    {
+        int index = EnumReflection::find(EnumTable<E>::entries, EnumTable<E>::count, name);
+        if (index < 0)
+        {
+            return false;
+        }
+        *out_value = static_cast<E>(index);
+        return true;
+    }
+
+    /**
+     * Gets a name from a name table.
+     * @param entries Name table in flash
+     * @param count Number of entries
+     * @param index Index of the name
+     * @return Name in flash, or nullptr if the index is out of range
+     */
+    static const __FlashStringHelper *get_name(const EnumName *entries, uint8_t count, uint8_t index);
+
+    /**
+     * Finds a name in a name table by its hash.
+     * @param entries Name table in flash
+     * @param count Number of entries
+     * @param name Name to find
+     * @return Index of the name, or -1 if it is not in the table
+     */
+    static int find(const EnumName *entries, uint8_t count, const char *name);
+};
+
+// Expands a list entry to an enumerator
+#define ENUM_REFLECTION_VALUE(value) value,
+// Expands a list entry to its name string in flash
+#define ENUM_REFLECTION_NAME(value) const char value[] PROGMEM = #value;
+// Expands a list entry to its entry in the name table
+#define ENUM_REFLECTION_ENTRY(value) {value, EnumReflection::hash(#value)},
+
+/**
+ * Declares the name table of an enum - place after the enclosing class in the header.
+ */
+#define ENUM_REFLECTION_DECLARE(Type)             \
+    template <>                                   \
+    struct EnumTable<Type>                        \
+    {                                             \
+        static const EnumName *const entries;     \
+        static const uint8_t count;               \
+    };
+
+/**
+ * Defines the name table of an enum from its value list - place in the source file.
+ * names is a namespace for the generated strings, unique per enum.
+ */
+#define ENUM_REFLECTION_DEFINE(Type, VALUES, names)                            \
+    namespace names                                                           \
+    {                                                                         \
+        VALUES(ENUM_REFLECTION_NAME)                                          \
+        const EnumName entries[] PROGMEM = {VALUES(ENUM_REFLECTION_ENTRY)};   \
+    }                                                                         \
+    const EnumName *const EnumTable<Type>::entries = names::entries;          \
+    const uint8_t EnumTable<Type>::count = sizeof(names::entries) / sizeof(names::entries[0]);
+
+#endif
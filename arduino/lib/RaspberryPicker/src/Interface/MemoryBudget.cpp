@@ -0,0 +1,75 @@
+/**
+ * MemoryBudget.cpp
+ *
+ * SRAM usage of the running firmware, based on the heap end and stack pointer of avr-libc.
+ */
+
+#include "MemoryBudget.h"
+
+const uint8_t MemoryBudget::stack_paint = 0xC5;
+
+#ifdef __AVR__
+extern char __heap_start;
+extern char *__brkval;
+
+/**
+ * Gets the end of the heap, which is its start while nothing is allocated.
+ */
+static char *get_heap_end()
+{
+    return __brkval != nullptr ? __brkval : &__heap_start;
+}
+#endif
+
+/**
+ * Paints the unused SRAM between heap and stack.
+ * A few bytes below the current stack frame are kept free for the calls made while painting.
+ */
+void MemoryBudget::paint_stack()
+{
+#ifdef __AVR__
+    char marker;
+    for (char *address = get_heap_end(); address < &marker - 16; address++)
+    {
+        *address = MemoryBudget::stack_paint;
+    }
+#endif
+}
+
+/**
+ * Gets the current distance between the end of the heap and the stack pointer.
+ * @return Free SRAM [bytes]
+ */
+int MemoryBudget::get_free_memory()
+{
+#ifdef __AVR__
+    char marker;
+    return &marker - get_heap_end();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * Gets the part of the painted SRAM that was never touched by heap or stack.
+ * Counts the painted bytes from the end of the heap up to the first byte the stack wrote.
+ * @return Smallest free SRAM since paint_stack() [bytes]
+ */
+int MemoryBudget::get_stack_headroom()
+{
+#ifdef __AVR__
+    char marker;
+    int headroom = 0;
+    for (const char *address = get_heap_end(); address < &marker; address++)
+    {
+        if ((uint8_t)*address != MemoryBudget::stack_paint)
+        {
+            break;
+        }
+        headroom++;
+    }
+    return headroom;
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,43 @@
+/**
+ * MemoryBudget.h
+ *
+ * SRAM usage of the running firmware.
+ * The free space between heap and stack is painted with a known byte at startup,
+ * so the deepest stack use since then can be measured and reported to the host.
+ * The flash and static SRAM use of each module is reported at build time by budget.sh.
+ */
+
+#ifndef RASPBERRY_PICKER_INTERFACE_MEMORY_BUDGET_H
+#define RASPBERRY_PICKER_INTERFACE_MEMORY_BUDGET_H
+
+#include <Arduino.h>
+
+/**
+ * MemoryBudget class - measures free SRAM and stack headroom.
+ * All values are 0 when not running on AVR.
+ */
+class MemoryBudget
+{
+public:
+    static const uint8_t stack_paint; // Byte written to unused SRAM by paint_stack()
+
+    /**
+     * Paints the unused SRAM between heap and stack.
+     * Call this once, first thing in setup().
+     */
+    static void paint_stack();
+
+    /**
+     * Gets the current distance between the end of the heap and the stack pointer.
+     * @return Free SRAM [bytes]
+     */
+    static int get_free_memory();
+
+    /**
+     * Gets the part of the painted SRAM that was never touched by heap or stack.
+     * @return Smallest free SRAM since paint_stack() [bytes]
+     */
+    static int get_stack_headroom();
+};
+
+#endif
@@ -0,0 +1,103 @@
+/**
+ * PhaseProfiler.cpp
+ *
+ * Timing statistics of the phases of the picking cycle.
+ * Recording only compares, adds and shifts, so a phase costs a few microseconds
+ * on top of the two micros() calls; the mean is only divided out when reported.
+ */
+
+#ifdef RASPBERRY_PICKER_PROFILE
+
+#include "PhaseProfiler.h"
+
+ENUM_REFLECTION_DEFINE(PhaseProfiler::Phase, RASPBERRY_PICKER_PROFILE_PHASES, profile_phase_names)
+ENUM_REFLECTION_DEFINE(PhaseProfiler::Request, RASPBERRY_PICKER_PROFILE_REQUESTS, profile_request_names)
+
+const uint8_t PhaseProfiler::bucket_shift = 16; // First bucket up to 65.5 ms
+
+/**
+ * Constructor - creates a profiler without measurements.
+ */
+PhaseProfiler::PhaseProfiler()
+{
+    this->reset();
+}
+
+/**
+ * Adds a measured duration to the statistics of a phase.
+ * Counts saturate instead of wrapping around.
+ * @param phase Measured phase
+ * @param duration_us Duration [us]
+ */
+void PhaseProfiler::record(Phase phase, uint32_t duration_us)
+{
+    Stats *stats = &this->stats[static_cast<uint8_t>(phase)];
+    if (stats->count == UINT16_MAX)
+    {
+        return;
+    }
+    stats->count++;
+    stats->total_us += duration_us;
+    if (duration_us < stats->min_us)
+    {
+        stats->min_us = duration_us;
+    }
+    if (duration_us > stats->max_us)
+    {
+        stats->max_us = duration_us;
+    }
+    stats->histogram[PhaseProfiler::get_bucket(duration_us)]++;
+}
+
+/**
+ * Gets the statistics of a phase.
+ * @param phase Phase
+ * @return Statistics, valid until the next record() or reset()
+ */
+const PhaseProfiler::Stats *PhaseProfiler::get_stats(Phase phase)
+{
+    return &this->stats[static_cast<uint8_t>(phase)];
+}
+
+/**
+ * Gets the mean duration of a phase.
+ * @param phase Phase
+ * @return Mean duration [us], 0 if the phase was never measured
+ */
+uint32_t PhaseProfiler::get_mean_us(Phase phase)
+{
+    const Stats *stats = this->get_stats(phase);
+    return stats->count > 0 ? stats->total_us / stats->count : 0;
+}
+
+/**
+ * Clears the statistics of all phases.
+ */
+void PhaseProfiler::reset()
+{
+    memset(this->stats, 0, sizeof(this->stats));
+    for (uint8_t i = 0; i < PhaseProfiler::phase_count; i++)
+    {
+        this->stats[i].min_us = UINT32_MAX;
+    }
+}
+
+/**
+ * Gets the histogram bucket of a duration: the number of bits of the duration
+ * above the first bucket edge, limited to the last bucket.
+ * @param duration_us Duration [us]
+ * @return Bucket index
+ */
+uint8_t PhaseProfiler::get_bucket(uint32_t duration_us)
+{
+    uint32_t units = duration_us >> PhaseProfiler::bucket_shift;
+    uint8_t bucket = 0;
+    while (units > 0 && bucket < PhaseProfiler::bucket_count - 1)
+    {
+        units >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+#endif
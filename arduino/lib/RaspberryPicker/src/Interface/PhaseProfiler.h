@@ -0,0 +1,151 @@
+/**
+ * PhaseProfiler.h
+ *
+ * Timing statistics of the phases of the picking cycle.
+ * The programs of the Controller mark each phase with PHASE_PROFILER_BEGIN/END,
+ * which measure it with micros() and aggregate it on the device into the count,
+ * minimum, maximum, mean and a histogram, so no timestamps have to be sent.
+ * The host requests the statistics with diag.profile=REPORT; they are sent
+ * phase by phase as diag.profile.* state updates, see InterfaceMaster.
+ *
+ * Only compiled in when RASPBERRY_PICKER_PROFILE is defined - otherwise the
+ * macros expand to nothing and the diag.profile.* keys are not in the dictionary.
+ */
+
+#ifndef RASPBERRY_PICKER_INTERFACE_PHASE_PROFILER_H
+#define RASPBERRY_PICKER_INTERFACE_PHASE_PROFILER_H
+
+#include <Arduino.h>
+
+#include "EnumReflection.h"
+
+// Values of PhaseProfiler::Phase
+#define RASPBERRY_PICKER_PROFILE_PHASES(X) \
+    X(CLOSE_LARGE) \
+    X(CLOSE_SMALL) \
+    X(CLOSE_LIMIT) \
+    X(SENSE_COLOR) \
+    X(SORT) \
+    X(WAIT_FOR_PICK) \
+    X(REOPEN) \
+    X(DOOR_DWELL)
+
+// Expands a list entry to +1, to count the phases
+#define PHASE_PROFILER_COUNT(value) +1
+
+// Values of PhaseProfiler::Request
+#define RASPBERRY_PICKER_PROFILE_REQUESTS(X) \
+    X(REPORT) \
+    X(RESET)
+
+/**
+ * PhaseProfiler class - aggregates the durations of the phases of the picking cycle.
+ * Takes 34 bytes of SRAM per phase.
+ */
+class PhaseProfiler
+{
+public:
+    /**
+     * Phase enum - measured parts of the programs.
+     * CLOSE_LARGE: Closing to the large berry position (not measured since closing is a single pass)
+     * CLOSE_SMALL: Closing to the small berry position (not measured since closing is a single pass)
+     * CLOSE_LIMIT: Closing towards the zero limit switch until the berry or the switch stops the plate
+     * SENSE_COLOR: Measuring the ripeness (overlaps SORT in program 1)
+     * SORT: Commanding the sorting flap
+     * WAIT_FOR_PICK: Waiting for the user to take the berry
+     * REOPEN: Opening the gripper after a berry
+     * DOOR_DWELL: Waiting for the basket to empty
+     */
+    enum class Phase : uint8_t
+    {
+        RASPBERRY_PICKER_PROFILE_PHASES(ENUM_REFLECTION_VALUE)
+    };
+
+    /**
+     * Request enum - values of the diag.profile command.
+     * REPORT: Send the statistics of all phases
+     * RESET: Clear the statistics
+     */
+    enum class Request
+    {
+        RASPBERRY_PICKER_PROFILE_REQUESTS(ENUM_REFLECTION_VALUE)
+    };
+
+    static const uint8_t phase_count = 0 RASPBERRY_PICKER_PROFILE_PHASES(PHASE_PROFILER_COUNT); // Number of phases
+    static const uint8_t bucket_count = 8;  // Number of histogram buckets
+    static const uint8_t bucket_shift;      // log2 of the upper edge of the first bucket [us]
+
+    /**
+     * Stats structure - aggregated durations of one phase.
+     * count: Number of measurements
+     * min_us, max_us: Shortest and longest duration [us]
+     * total_us: Sum of all durations [us]
+     * histogram: Number of measurements per bucket, see get_bucket()
+     */
+    struct Stats
+    {
+        uint16_t count;
+        uint32_t min_us;
+        uint32_t max_us;
+        uint64_t total_us;
+        uint16_t histogram[bucket_count];
+    };
+
+    /**
+     * Constructor - creates a profiler without measurements.
+     */
+    PhaseProfiler();
+
+    /**
+     * Adds a measured duration to the statistics of a phase.
+     * @param phase Measured phase
+     * @param duration_us Duration [us]
+     */
+    void record(Phase phase, uint32_t duration_us);
+
+    /**
+     * Gets the statistics of a phase.
+     * @param phase Phase
+     * @return Statistics, valid until the next record() or reset()
+     */
+    const Stats *get_stats(Phase phase);
+
+    /**
+     * Gets the mean duration of a phase.
+     * @param phase Phase
+     * @return Mean duration [us], 0 if the phase was never measured
+     */
+    uint32_t get_mean_us(Phase phase);
+
+    /**
+     * Clears the statistics of all phases.
+     */
+    void reset();
+
+    /**
+     * Gets the histogram bucket of a duration.
+     * Bucket i holds durations shorter than 2^(bucket_shift + i) us (65.5 ms, 131 ms, ... 4.2 s),
+     * the last bucket all longer ones.
+     * @param duration_us Duration [us]
+     * @return Bucket index
+     */
+    static uint8_t get_bucket(uint32_t duration_us);
+
+private:
+    Stats stats[phase_count]; // Statistics per phase
+};
+
+ENUM_REFLECTION_DECLARE(PhaseProfiler::Phase)
+ENUM_REFLECTION_DECLARE(PhaseProfiler::Request)
+
+#ifdef RASPBERRY_PICKER_PROFILE
+// Starts measuring a phase: declares the local variable span with the start time
+#define PHASE_PROFILER_BEGIN(span) uint32_t span = micros()
+// Ends measuring a phase started with PHASE_PROFILER_BEGIN(span) and records it in profiler
+#define PHASE_PROFILER_END(profiler, span, phase) (profiler).record(PhaseProfiler::Phase::phase, micros() - (span))
+#else
+#define PHASE_PROFILER_BEGIN(span)
+#define PHASE_PROFILER_END(profiler, span, phase)
+#endif
+
+#endif
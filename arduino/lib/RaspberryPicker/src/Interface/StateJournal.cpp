@@ -0,0 +1,149 @@
+/**
+ * StateJournal.cpp
+ *
+ * Wear-levelled journal of the machine state in EEPROM.
+ * An entry is version, sequence number, snapshot, CRC-8 and the at-rest marker;
+ * the marker is not covered by the CRC, so it can be cleared without rewriting the entry.
+ * Sequence numbers increase by one per entry and wrap around at 256; as there are
+ * fewer than 128 slots, the newest entry is the one furthest ahead of any other.
+ */
+
+#include <EEPROM.h>
+
+#include "StateJournal.h"
+#include "BinaryProtocol.h"
+
+ENUM_REFLECTION_DEFINE(StateJournal::Status, RASPBERRY_PICKER_JOURNAL_STATUSES, journal_status_names)
+
+/**
+ * Entry structure - layout of a slot in EEPROM.
+ * version: Layout version, see StateJournal::version (0xFF in erased cells)
+ * sequence: Sequence number, one more than the entry before
+ * snapshot: Journaled state
+ * crc: CRC-8 of version, sequence and snapshot
+ * rest: at_rest_marker if the plate stood still since the entry was written
+ */
+struct Entry
+{
+    uint8_t version;
+    uint8_t sequence;
+    StateJournal::Snapshot snapshot;
+    uint8_t crc;
+    uint8_t rest;
+};
+
+#ifdef __AVR__
+// Without padding, the 960 bytes after the configuration record of a 1 KB EEPROM hold 64 slots
+static_assert(sizeof(Entry) == 15, "StateJournal entry layout changed");
+#endif
+
+static const uint8_t at_rest_marker = 0xA5; // Any other value, e.g. of a torn write, means moving
+
+const uint8_t StateJournal::version = 1; // Increase when Snapshot changes
+
+int16_t StateJournal::newest_slot = -1;
+uint8_t StateJournal::sequence = 0;
+bool StateJournal::at_rest = false;
+StateJournal::Snapshot StateJournal::snapshot;
+
+/**
+ * Finds the newest valid entry.
+ * Entries with a wrong version or CRC, e.g. torn by a power loss while writing, are skipped,
+ * so the entry before it is restored, whose marker was already cleared.
+ * @param out_snapshot Pointer to store the journaled state, written unless COLD
+ * @return COLD without a valid entry, WARM if the plate was at rest, DIRTY otherwise
+ */
+StateJournal::Status StateJournal::restore(Snapshot *out_snapshot)
+{
+    Entry newest = {};
+    StateJournal::newest_slot = -1;
+    for (uint8_t slot = 0; slot < StateJournal::get_slot_count(); slot++)
+    {
+        Entry entry;
+        EEPROM.get(StateJournal::get_slot_address(slot), entry);
+        if (entry.version != StateJournal::version ||
+            entry.crc != BinaryProtocol::crc8((const uint8_t *)&entry, offsetof(Entry, crc)))
+        {
+            continue;
+        }
+        if (StateJournal::newest_slot < 0 || (int8_t)(entry.sequence - newest.sequence) > 0)
+        {
+            newest = entry;
+            StateJournal::newest_slot = slot;
+        }
+    }
+
+    if (StateJournal::newest_slot < 0)
+    {
+        return Status::COLD;
+    }
+    StateJournal::sequence = newest.sequence;
+    StateJournal::snapshot = newest.snapshot;
+    StateJournal::at_rest = newest.rest == at_rest_marker;
+    *out_snapshot = newest.snapshot;
+    return StateJournal::at_rest ? Status::WARM : Status::DIRTY;
+}
+
+/**
+ * Appends an entry if the state differs from the newest one, or if the plate moved since.
+ * The marker is written after the rest of the entry, so a torn write never looks at rest.
+ * @param snapshot Current state
+ */
+void StateJournal::record(const Snapshot &snapshot)
+{
+    if (StateJournal::at_rest && memcmp(&snapshot, &StateJournal::snapshot, sizeof(Snapshot)) == 0)
+    {
+        return;
+    }
+
+    Entry entry;
+    memset(&entry, 0, sizeof(entry)); // Padding on the native build
+    entry.version = StateJournal::version;
+    entry.sequence = StateJournal::sequence + 1;
+    entry.snapshot = snapshot;
+    entry.crc = BinaryProtocol::crc8((const uint8_t *)&entry, offsetof(Entry, crc));
+    entry.rest = 0;
+
+    uint8_t slot = (StateJournal::newest_slot + 1) % StateJournal::get_slot_count();
+    int address = StateJournal::get_slot_address(slot);
+    EEPROM.put(address, entry);
+    EEPROM.update(address + offsetof(Entry, rest), at_rest_marker);
+
+    StateJournal::newest_slot = slot;
+    StateJournal::sequence = entry.sequence;
+    StateJournal::snapshot = snapshot;
+    StateJournal::at_rest = true;
+}
+
+/**
+ * Clears the at-rest marker of the newest entry, if it is set.
+ */
+void StateJournal::mark_moving()
+{
+    if (!StateJournal::at_rest)
+    {
+        return;
+    }
+    EEPROM.update(StateJournal::get_slot_address(StateJournal::newest_slot) + offsetof(Entry, rest), 0);
+    StateJournal::at_rest = false;
+}
+
+/**
+ * Gets the number of slots that fit into the EEPROM.
+ * @return Number of slots, at most 127 so sequence numbers can be compared across the wrap
+ */
+uint8_t StateJournal::get_slot_count()
+{
+    int slots = (EEPROM.length() - StateJournal::start_address) / sizeof(Entry);
+    return slots < 127 ? slots : 127;
+}
+
+/**
+ * Gets the EEPROM address of a slot.
+ * @param slot Slot index
+ * @return EEPROM address
+ */
+int StateJournal::get_slot_address(uint8_t slot)
+{
+    return StateJournal::start_address + slot * sizeof(Entry);
+}
@@ -0,0 +1,105 @@
+/**
+ * StateJournal.h
+ *
+ * Wear-levelled journal of the machine state in EEPROM, for a warm start after a power loss.
+ * Each entry holds the fill counts, the plate stepper position, the gripper, sorter and door
+ * states and an at-rest marker. Entries are appended round-robin to the slots after the
+ * configuration record, so every cell is written only once per round of slots.
+ *
+ * The at-rest marker is written last when an entry is appended while the plate stands still,
+ * and cleared (one byte) before the plate moves again. At boot, the newest valid entry
+ * is restored; only if its marker is set is the plate position trusted and homing skipped.
+ */
+
+#ifndef RASPBERRY_PICKER_INTERFACE_STATE_JOURNAL_H
+#define RASPBERRY_PICKER_INTERFACE_STATE_JOURNAL_H
+
+#include <Arduino.h>
+
+#include "EnumReflection.h"
+
+// Values of StateJournal::Status
+#define RASPBERRY_PICKER_JOURNAL_STATUSES(X) \
+    X(COLD) \
+    X(WARM) \
+    X(DIRTY)
+
+/**
+ * StateJournal class - appends and restores snapshots of the machine state.
+ */
+class StateJournal
+{
+public:
+    /**
+     * Status enum - result of restore(), reported as journal.status.
+     * COLD: No valid entry, the defaults are used
+     * WARM: The state was restored, the plate was at rest - no homing needed
+     * DIRTY: Counts, sorter and door were restored, but the plate was moving - homing needed
+     */
+    enum class Status
+    {
+        RASPBERRY_PICKER_JOURNAL_STATUSES(ENUM_REFLECTION_VALUE)
+    };
+
+    /**
+     * Snapshot structure - journaled machine state.
+     * fill_small: Number of small raspberries in the basket
+     * fill_large: Number of large raspberries in the basket
+     * plate_position: Plate stepper position [steps]
+     * gripper_state: GripperStepper::GripperState
+     * sorting_state: BasketSorter::SortingState
+     * door_state: BasketDoor::DoorState
+     */
+    struct Snapshot
+    {
+        int16_t fill_small;
+        int16_t fill_large;
+        int32_t plate_position;
+        uint8_t gripper_state;
+        uint8_t sorting_state;
+        uint8_t door_state;
+    };
+
+    static const uint8_t version;    // Layout version of the entries
+    static const int start_address = 64; // EEPROM address of the first slot, Config checks that its record fits in front
+
+    /**
+     * Finds the newest valid entry. Call once during setup, before record() or mark_moving().
+     * @param out_snapshot Pointer to store the journaled state, written unless COLD
+     * @return Whether and how much of the state can be trusted
+     */
+    static Status restore(Snapshot *out_snapshot);
+
+    /**
+     * Appends an entry if the state differs from the newest one, or if the plate moved since.
+     * Call only while the plate stands still; blocks while the entry is written (about 50 ms).
+     * @param snapshot Current state, cleared with memset before filling it, as it is compared bytewise
+     */
+    static void record(const Snapshot &snapshot);
+
+    /**
+     * Clears the at-rest marker of the newest entry, if it is set.
+     * Call before the plate starts moving; blocks for one byte write (3.3 ms).
+     */
+    static void mark_moving();
+
+private:
+    /**
+     * Gets the number of slots that fit into the EEPROM.
+     */
+    static uint8_t get_slot_count();
+
+    /**
+     * Gets the EEPROM address of a slot.
+     */
+    static int get_slot_address(uint8_t slot);
+
+    static int16_t newest_slot;   // Slot of the newest entry, -1 if none
+    static uint8_t sequence;      // Sequence number of the newest entry
+    static bool at_rest;          // Whether the marker of the newest entry is set
+    static Snapshot snapshot;     // State in the newest entry
+};
+
+ENUM_REFLECTION_DECLARE(StateJournal::Status)
+
+#endif
@@ -0,0 +1,190 @@
+/**
+ * TelemetryFilter.cpp
+ *
+ * Change-only, rate-limited state updates in front of the TelemetryQueue.
+ * Costs 7 bytes of SRAM per dictionary key on AVR.
+ */
+
+#include "TelemetryFilter.h"
+
+#include <string.h>
+
+/**
+ * Constructor - creates a filter that has not sent anything yet.
+ * @param queue Queue the passed updates are written to
+ */
+TelemetryFilter::TelemetryFilter(TelemetryQueue *queue)
+{
+    this->queue = queue;
+    for (uint8_t i = 0; i < TelemetryKeys::key_count; i++)
+    {
+        this->slots[i].value.type = TelemetryValue::Type::NONE;
+        this->slots[i].sent_ms = 0;
+    }
+    memset(this->pending, 0, sizeof(this->pending));
+    this->pending_count = 0;
+    this->suppressed = 0;
+}
+
+/**
+ * Offers a state update with an already converted value.
+ * The update is queued right away if it differs from the last value (or the key
+ * reports events) and the minimum interval of the key has passed, otherwise it is
+ * held back until flush().
+ * Log messages are never filtered.
+ * @param key Key ID
+ * @param value Value
+ */
+void TelemetryFilter::push_value(TelemetryKey key, const TelemetryValue &value)
+{
+    uint8_t key_id = static_cast<uint8_t>(key);
+    if (key_id == TelemetryKeys::log_key)
+    {
+        this->queue->push_value(TelemetryKeys::get_key_name(key), value);
+        return;
+    }
+
+    Slot *slot = &this->slots[key_id];
+    if (this->is_pending(key_id))
+    {
+        // Replace the held back value, it was never sent
+        slot->value = value;
+        this->suppressed++;
+        return;
+    }
+    if (slot->value.equals(value) && !TelemetryKeys::is_event(key))
+    {
+        this->suppressed++;
+        return;
+    }
+
+    slot->value = value;
+    uint16_t now_ms = millis();
+    if (this->has_interval_passed(key_id, now_ms))
+    {
+        this->send(key_id, now_ms);
+    }
+    else
+    {
+        this->set_pending(key_id, true);
+    }
+}
+
+/**
+ * Checks whether an update of a key would be queued right away.
+ * @param key Key ID
+ * @return true if the minimum interval of the key has passed
+ */
+bool TelemetryFilter::is_due(TelemetryKey key)
+{
+    uint8_t key_id = static_cast<uint8_t>(key);
+    return !this->is_pending(key_id) && this->has_interval_passed(key_id, millis());
+}
+
+/**
+ * Queues held back updates whose interval has passed, as far as the queue has room.
+ * Keys that do not fit stay pending, so the queue never drops a final state.
+ */
+void TelemetryFilter::flush()
+{
+    if (this->pending_count == 0)
+    {
+        return;
+    }
+
+    uint16_t now_ms = millis();
+    for (uint8_t key_id = 0; key_id < TelemetryKeys::key_count && !this->queue->is_full(); key_id++)
+    {
+        if (this->is_pending(key_id) && this->has_interval_passed(key_id, now_ms))
+        {
+            this->set_pending(key_id, false);
+            this->send(key_id, now_ms);
+        }
+    }
+}
+
+/**
+ * Sends the last value of every key again, e.g. after the host (re)connected.
+ * The values are queued by flush(), so they do not overflow the queue.
+ */
+void TelemetryFilter::resend_all()
+{
+    for (uint8_t key_id = 0; key_id < TelemetryKeys::key_count; key_id++)
+    {
+        if (this->slots[key_id].value.type != TelemetryValue::Type::NONE)
+        {
+            this->set_pending(key_id, true);
+        }
+    }
+}
+
+/**
+ * Gets the number of updates that were dropped as repeated or replaced while held back.
+ * @return Number of suppressed updates
+ */
+unsigned long TelemetryFilter::get_suppressed()
+{
+    return this->suppressed;
+}
+
+/**
+ * Checks whether the minimum interval of a key has passed.
+ * Keys that were never sent are always due.
+ * @param key_id Key ID
+ * @param now_ms Lower 16 bits of millis() [ms]
+ * @return true if an update may be queued now
+ */
+bool TelemetryFilter::has_interval_passed(uint8_t key_id, uint16_t now_ms)
+{
+    const Slot *slot = &this->slots[key_id];
+    if (slot->value.type == TelemetryValue::Type::NONE)
+    {
+        return true;
+    }
+    uint16_t elapsed_ms = now_ms - slot->sent_ms;
+    return elapsed_ms >= TelemetryKeys::get_min_interval(static_cast<TelemetryKey>(key_id));
+}
+
+/**
+ * Queues the value of a slot and restarts its interval.
+ * @param key_id Key ID
+ * @param now_ms Lower 16 bits of millis() [ms]
+ */
+void TelemetryFilter::send(uint8_t key_id, uint16_t now_ms)
+{
+    Slot *slot = &this->slots[key_id];
+    this->queue->push_value(TelemetryKeys::get_key_name(static_cast<TelemetryKey>(key_id)), slot->value);
+    slot->sent_ms = now_ms;
+}
+
+/**
+ * Checks whether a key has a held back value.
+ * @param key_id Key ID
+ */
+bool TelemetryFilter::is_pending(uint8_t key_id)
+{
+    return this->pending[key_id / 8] & (1 << (key_id % 8));
+}
+
+/**
+ * Marks a key as having a held back value or not.
+ * @param key_id Key ID
+ * @param pending Whether the key has a held back value
+ */
+void TelemetryFilter::set_pending(uint8_t key_id, bool pending)
+{
+    if (this->is_pending(key_id) == pending)
+    {
+        return;
+    }
+    if (pending)
+    {
+        this->pending[key_id / 8] |= (1 << (key_id % 8));
+        this->pending_count++;
+    }
+    else
+    {
+        this->pending[key_id / 8] &= ~(1 << (key_id % 8));
+        this->pending_count--;
+    }
+}
@@ -0,0 +1,113 @@
+/**
+ * TelemetryFilter.h
+ *
+ * Change-only, rate-limited state updates in front of the TelemetryQueue.
+ * Remembers the last value sent per dictionary key, drops state updates that repeat it,
+ * and holds back updates that come sooner than the minimum interval of their key
+ * (see RASPBERRY_PICKER_TELEMETRY_KEYS). The latest held back value is queued by
+ * flush() once the interval has passed, so the final state always reaches the host.
+ */
+
+#ifndef RASPBERRY_PICKER_INTERFACE_TELEMETRY_FILTER_H
+#define RASPBERRY_PICKER_INTERFACE_TELEMETRY_FILTER_H
+
+#include <Arduino.h>
+
+#include "TelemetryKeys.h"
+#include "TelemetryQueue.h"
+#include "TelemetryValue.h"
+
+/**
+ * TelemetryFilter class - suppresses repeated and too frequent state updates.
+ */
+class TelemetryFilter
+{
+public:
+    /**
+     * Constructor - creates a filter that has not sent anything yet.
+     * @param queue Queue the passed updates are written to
+     */
+    TelemetryFilter(TelemetryQueue *queue);
+
+    /**
+     * Offers a state update of a key from the dictionary.
+     * @param key Key ID
+     * @param value Value (number, float, F() string or reflected enum)
+     */
+    template <typename T>
+    void push(TelemetryKey key, T value)
+    {
+        this->push_value(key, TelemetryValue::from(value));
+    }
+
+    /**
+     * Offers a state update with an already converted value.
+     * Log messages are never filtered.
+     * @param key Key ID
+     * @param value Value
+     */
+    void push_value(TelemetryKey key, const TelemetryValue &value);
+
+    /**
+     * Checks whether an update of a key would be queued right away,
+     * e.g. to skip computing a value that would be held back.
+     * @param key Key ID
+     * @return true if the minimum interval of the key has passed
+     */
+    bool is_due(TelemetryKey key);
+
+    /**
+     * Queues held back updates whose interval has passed, as far as the queue has room.
+     * Call this once per loop tick, before flushing the queue.
+     */
+    void flush();
+
+    /**
+     * Sends the last value of every key again, e.g. after the host (re)connected.
+     */
+    void resend_all();
+
+    /**
+     * Gets the number of updates that were dropped as repeated or replaced while held back.
+     */
+    unsigned long get_suppressed();
+
+private:
+    /**
+     * Slot structure - filter state of one key.
+     * value: Last value queued, or the held back value if the key is pending
+     * sent_ms: Lower 16 bits of millis() when the key was last queued [ms]
+     */
+    struct Slot
+    {
+        TelemetryValue value;
+        uint16_t sent_ms;
+    };
+
+    /**
+     * Checks whether the minimum interval of a key has passed.
+     * Intervals are measured with 16 bit timestamps, so an update more than 65 s
+     * after the previous one may be held back for up to one interval.
+     * @param key_id Key ID
+     * @param now_ms Lower 16 bits of millis() [ms]
+     */
+    bool has_interval_passed(uint8_t key_id, uint16_t now_ms);
+
+    /**
+     * Queues the value of a slot and restarts its interval.
+     * @param key_id Key ID
+     * @param now_ms Lower 16 bits of millis() [ms]
+     */
+    void send(uint8_t key_id, uint16_t now_ms);
+
+    bool is_pending(uint8_t key_id);
+    void set_pending(uint8_t key_id, bool pending);
+
+    TelemetryQueue *queue;                              // Queue the passed updates are written to
+    Slot slots[TelemetryKeys::key_count];               // Filter state per key
+    uint8_t pending[(TelemetryKeys::key_count + 7) / 8]; // Bit set of keys with a held back value
+    uint8_t pending_count;                              // Number of keys with a held back value
+    unsigned long suppressed;                           // Number of suppressed updates
+};
+
+#endif
@@ -0,0 +1,86 @@
+/**
+ * TelemetryKeys.cpp
+ *
+ * Dictionary of the state keys sent to the host.
+ * Names, the table of their addresses, the update intervals and the event flags are stored in flash.
+ * Enum values are sent as the index of their name, see EnumReflection.h.
+ */
+
+#include "TelemetryKeys.h"
+
+#define TELEMETRY_KEYS_NAME(id, name, interval, event) static const char key_name_##id[] PROGMEM = name;
+#define TELEMETRY_KEYS_ENTRY(id, name, interval, event) key_name_##id,
+#define TELEMETRY_KEYS_INTERVAL(id, name, interval, event) interval,
+#define TELEMETRY_KEYS_EVENT(id, name, interval, event) event,
+
+RASPBERRY_PICKER_TELEMETRY_KEYS(TELEMETRY_KEYS_NAME)
+
+// Key names, the position in the table is the key ID
+static const char *const keys[] PROGMEM = {
+    RASPBERRY_PICKER_TELEMETRY_KEYS(TELEMETRY_KEYS_ENTRY)
+};
+
+// Minimum interval between updates per key [ms]
+static const uint16_t intervals[] PROGMEM = {
+    RASPBERRY_PICKER_TELEMETRY_KEYS(TELEMETRY_KEYS_INTERVAL)
+};
+
+// Whether each key reports events
+static const bool events[] PROGMEM = {
+    RASPBERRY_PICKER_TELEMETRY_KEYS(TELEMETRY_KEYS_EVENT)
+};
+
+#undef TELEMETRY_KEYS_NAME
+#undef TELEMETRY_KEYS_ENTRY
+#undef TELEMETRY_KEYS_INTERVAL
+#undef TELEMETRY_KEYS_EVENT
+
+const uint8_t TelemetryKeys::log_key = static_cast<uint8_t>(TelemetryKey::LOG);
+
+/**
+ * Finds the ID of a key name.
+ * Only names taken from the dictionary are found, as names are compared by address.
+ * @param key Key name in flash
+ * @return Key ID, or -1 if the key is not in the dictionary
+ */
+int TelemetryKeys::find_key(const __FlashStringHelper *key)
+{
+    for (uint8_t i = 0; i < TelemetryKeys::key_count; i++)
+    {
+        if (pgm_read_ptr(&keys[i]) == (const void *)key)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Gets the name of a key.
+ * @param key Key ID
+ * @return Key name in flash
+ */
+const __FlashStringHelper *TelemetryKeys::get_key_name(TelemetryKey key)
+{
+    return (const __FlashStringHelper *)pgm_read_ptr(&keys[static_cast<uint8_t>(key)]);
+}
+
+/**
+ * Gets the minimum time between two updates of a key.
+ * @param key Key ID
+ * @return Minimum interval [ms], 0 if every change is sent
+ */
+uint16_t TelemetryKeys::get_min_interval(TelemetryKey key)
+{
+    return pgm_read_word(&intervals[static_cast<uint8_t>(key)]);
+}
+
+/**
+ * Checks whether a key reports events, which are sent even if they repeat the last value.
+ * @param key Key ID
+ * @return true for an event key, false for a state key
+ */
+bool TelemetryKeys::is_event(TelemetryKey key)
+{
+    return pgm_read_byte(&events[static_cast<uint8_t>(key)]);
+}
@@ -0,0 +1,138 @@
+/**
+ * TelemetryKeys.h
+ *
+ * Dictionary of the state keys sent to the host.
+ * Assigns each key a numeric ID, so keys can be sent as single bytes,
+ * and keeps the key names in flash instead of copying them to SRAM at startup.
+ * Must be kept in sync with interface/RaspberryPicker/state/protocol.py.
+ */
+
+#ifndef RASPBERRY_PICKER_INTERFACE_TELEMETRY_KEYS_H
+#define RASPBERRY_PICKER_INTERFACE_TELEMETRY_KEYS_H
+
+#include <Arduino.h>
+
+// State keys as X(ID, name, minimum interval between updates [ms], event),
+// the position in the list is the key ID - only append new keys.
+// Event keys report something that happened (a decision, a motion, a reply) and are sent
+// even if they repeat the last value; the others are states and only sent when they change
+#define RASPBERRY_PICKER_TELEMETRY_KEYS(X) \
+    X(LOG, "log", 0, true) \
+    X(CONTROLLER_PROGRAM, "controller.program", 0, false) \
+    X(CONTROLLER_STATE, "controller.state", 0, false) \
+    X(INTERFACE_PROTOCOL, "interface.protocol", 0, false) \
+    X(BASKET_DOOR_STATE, "basket.door.state", 0, false) \
+    X(BASKET_DOOR_POSITION, "basket.door.position", 0, false) \
+    X(BASKET_SORTING_STATE, "basket.sorting.state", 0, false) \
+    X(BASKET_SORTING_POSITION, "basket.sorting.position", 0, false) \
+    X(BASKET_FILL_COUNT_SMALL, "basket.fill_count.small", 0, false) \
+    X(BASKET_FILL_COUNT_LARGE, "basket.fill_count.large", 0, false) \
+    X(GRIPPER_STATE, "gripper.gripper_state", 0, false) \
+    X(GRIPPER_PLATE_DISTANCE, "gripper.plate_distance", 200, false) \
+    X(GRIPPER_RASPBERRY_SIZE, "gripper.raspberry_size", 0, true) \
+    X(GRIPPER_RASPBERRY_RIPENESS, "gripper.raspberry_ripeness", 0, true) \
+    X(GRIPPER_RASPBERRY_RIPENESS_P_RIPE, "gripper.raspberry_ripeness.p_ripe", 0, true) \
+    X(GRIPPER_RASPBERRY_RIPENESS_P_UNRIPE, "gripper.raspberry_ripeness.p_unripe", 0, true) \
+    X(GRIPPER_RIPENESS_R, "gripper.ripeness.r", 200, false) \
+    X(GRIPPER_RIPENESS_G, "gripper.ripeness.g", 200, false) \
+    X(GRIPPER_RIPENESS_B, "gripper.ripeness.b", 200, false) \
+    X(GRIPPER_RIPENESS_NOISE, "gripper.ripeness.noise", 200, false) \
+    X(GRIPPER_RIPENESS_SAMPLES, "gripper.ripeness.samples", 0, true) \
+    X(GRIPPER_RIPENESS_SETTLE_MS_R, "gripper.ripeness.settle_ms.r", 0, true) \
+    X(GRIPPER_RIPENESS_SETTLE_MS_G, "gripper.ripeness.settle_ms.g", 0, true) \
+    X(GRIPPER_RIPENESS_SETTLE_MS_B, "gripper.ripeness.settle_ms.b", 0, true) \
+    X(GRIPPER_RIPENESS_SETTLE_MS_NOISE, "gripper.ripeness.settle_ms.noise", 0, true) \
+    X(GRIPPER_MOTION_LATENCY_MS, "gripper.motion.latency_ms", 0, true) \
+    X(GRIPPER_MOTION_DURATION_MS, "gripper.motion.duration_ms", 0, true) \
+    X(INTERFACE_TELEMETRY_DROPPED, "interface.telemetry.dropped", 1000, false) \
+    X(DIAG_MEMORY_FREE, "diag.memory.free", 1000, false) \
+    X(DIAG_MEMORY_STACK_HEADROOM, "diag.memory.stack_headroom", 1000, false) \
+    X(DIAG_MEMORY_CONTROLLER, "diag.memory.controller", 0, false) \
+    X(DIAG_MEMORY_INTERFACE, "diag.memory.interface", 0, false) \
+    X(DIAG_MEMORY_BASKET, "diag.memory.basket", 0, false) \
+    X(DIAG_MEMORY_GRIPPER, "diag.memory.gripper", 0, false) \
+    X(CONFIG_STATUS, "config.status", 0, true) \
+    X(CONFIG_KEY, "config.key", 0, true) \
+    X(CONFIG_VALUE, "config.value", 0, true) \
+    X(JOURNAL_STATUS, "journal.status", 0, true) \
+    X(GRIPPER_HOMING_STATUS, "gripper.homing.status", 0, true) \
+    X(GRIPPER_HOMING_DRIFT_STEPS, "gripper.homing.drift_steps", 0, true) \
+    RASPBERRY_PICKER_PROFILE_TELEMETRY_KEYS(X)
+
+// Keys of the phase profiler, only in the dictionary when it is compiled in (see PhaseProfiler.h).
+// The statistics of all phases share these keys, each report starts with diag.profile.phase,
+// so they are events: two phases may well have the same count
+#ifdef RASPBERRY_PICKER_PROFILE
+#define RASPBERRY_PICKER_PROFILE_TELEMETRY_KEYS(X) \
+    X(DIAG_PROFILE_PHASE, "diag.profile.phase", 0, true) \
+    X(DIAG_PROFILE_COUNT, "diag.profile.count", 0, true) \
+    X(DIAG_PROFILE_MIN_US, "diag.profile.min_us", 0, true) \
+    X(DIAG_PROFILE_MEAN_US, "diag.profile.mean_us", 0, true) \
+    X(DIAG_PROFILE_MAX_US, "diag.profile.max_us", 0, true) \
+    X(DIAG_PROFILE_HISTOGRAM_0, "diag.profile.histogram.0", 0, true) \
+    X(DIAG_PROFILE_HISTOGRAM_1, "diag.profile.histogram.1", 0, true) \
+    X(DIAG_PROFILE_HISTOGRAM_2, "diag.profile.histogram.2", 0, true) \
+    X(DIAG_PROFILE_HISTOGRAM_3, "diag.profile.histogram.3", 0, true) \
+    X(DIAG_PROFILE_HISTOGRAM_4, "diag.profile.histogram.4", 0, true) \
+    X(DIAG_PROFILE_HISTOGRAM_5, "diag.profile.histogram.5", 0, true) \
+    X(DIAG_PROFILE_HISTOGRAM_6, "diag.profile.histogram.6", 0, true) \
+    X(DIAG_PROFILE_HISTOGRAM_7, "diag.profile.histogram.7", 0, true)
+#else
+#define RASPBERRY_PICKER_PROFILE_TELEMETRY_KEYS(X)
+#endif
+
+#define TELEMETRY_KEYS_ID(id, name, interval, event) id,
+#define TELEMETRY_KEYS_COUNT(id, name, interval, event) +1
+
+/**
+ * TelemetryKey enum - IDs of the state keys, see RASPBERRY_PICKER_TELEMETRY_KEYS.
+ */
+enum class TelemetryKey : uint8_t
+{
+    RASPBERRY_PICKER_TELEMETRY_KEYS(TELEMETRY_KEYS_ID)
+};
+
+/**
+ * TelemetryKeys class - maps state keys to their IDs, names and update intervals.
+ */
+class TelemetryKeys
+{
+public:
+    static const uint8_t key_count = 0 RASPBERRY_PICKER_TELEMETRY_KEYS(TELEMETRY_KEYS_COUNT); // Number of known keys
+    static const uint8_t log_key;     // ID of the free-text log key
+
+    /**
+     * Finds the ID of a key name.
+     * Only names taken from the dictionary are found, as names are compared by address.
+     * @param key Key name in flash
+     * @return Key ID, or -1 if the key is not in the dictionary
+     */
+    static int find_key(const __FlashStringHelper *key);
+
+    /**
+     * Gets the name of a key.
+     * @param key Key ID
+     * @return Key name in flash
+     */
+    static const __FlashStringHelper *get_key_name(TelemetryKey key);
+
+    /**
+     * Gets the minimum time between two updates of a key.
+     * @param key Key ID
+     * @return Minimum interval [ms], 0 if every change is sent
+     */
+    static uint16_t get_min_interval(TelemetryKey key);
+
+    /**
+     * Checks whether a key reports events, which are sent even if they repeat the last value.
+     * @param key Key ID
+     * @return true for an event key, false for a state key
+     */
+    static bool is_event(TelemetryKey key);
+
+};
+
+// The binary protocol sends the key ID in the lower 6 bits of the frame header (see BinaryProtocol.h)
+static_assert(TelemetryKeys::key_count <= 64, "the telemetry dictionary has more keys than the binary protocol can address");
+
+#endif
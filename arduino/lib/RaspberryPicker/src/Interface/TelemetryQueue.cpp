@@ -0,0 +1,323 @@
+/**
+ * TelemetryQueue.cpp
+ *
+ * Fixed-size queue of outgoing state updates.
+ * Updates are formatted only when they are written, into stack buffers,
+ * so queuing costs a few bytes of static SRAM and no heap allocation.
+ * The transmit interrupt of the serial port is owned by HardwareSerial,
+ * so the queue is drained from the main loop and the gripper motion tick.
+ */
+
+#include "TelemetryQueue.h"
+#include "BinaryProtocol.h"
+
+#include <stdlib.h>
+
+// HardwareSerial keeps one byte of its 64 byte transmit buffer free
+const int TelemetryQueue::tx_buffer_space = 63;
+
+/**
+ * Constructor - creates an empty queue.
+ * @param policy Overflow policy
+ */
+TelemetryQueue::TelemetryQueue(OverflowPolicy policy)
+{
+    this->head = 0;
+    this->count = 0;
+    this->policy = policy;
+    this->dropped = 0;
+    this->reported_dropped = 0;
+}
+
+/**
+ * Queues a state update with an already converted value.
+ * @param key State key name in flash
+ * @param value Value
+ */
+void TelemetryQueue::push_value(const __FlashStringHelper *key, const TelemetryValue &value)
+{
+    this->reserve(key)->value = value;
+}
+
+/**
+ * Checks whether a key reports events, which must not replace each other in the queue.
+ * @param key State key name in flash
+ * @return true for an event key from the dictionary
+ */
+static bool is_event_key(const __FlashStringHelper *key)
+{
+    int key_id = TelemetryKeys::find_key(key);
+    return key_id >= 0 && TelemetryKeys::is_event(static_cast<TelemetryKey>(key_id));
+}
+
+/**
+ * Finds the slot for an update according to the overflow policy.
+ * With COALESCE, a queued update of the same key is overwritten in place, unless it is an event.
+ * Keys are compared by the address of their name, which is unique for dictionary keys.
+ * Otherwise the update is appended, dropping the oldest one if the queue is full.
+ * @param key State key name in flash
+ * @return Entry to store the update in
+ */
+TelemetryQueue::Entry *TelemetryQueue::reserve(const __FlashStringHelper *key)
+{
+    if (this->policy == OverflowPolicy::COALESCE)
+    {
+        for (uint8_t i = 0; i < this->count; i++)
+        {
+            Entry *entry = &this->entries[(this->head + i) % TelemetryQueue::capacity];
+            if (entry->key == key && !is_event_key(key))
+            {
+                this->dropped++;
+                return entry;
+            }
+        }
+    }
+
+    if (this->count == TelemetryQueue::capacity)
+    {
+        // Drop the oldest update
+        this->head = (this->head + 1) % TelemetryQueue::capacity;
+        this->count--;
+        this->dropped++;
+    }
+
+    Entry *entry = &this->entries[(this->head + this->count) % TelemetryQueue::capacity];
+    this->count++;
+    entry->key = key;
+    return entry;
+}
+
+/**
+ * Writes queued updates while they fit into the serial transmit buffer.
+ * Updates longer than the transmit buffer are written once it is empty.
+ * After the queue ran empty, a changed drop counter is queued as interface.telemetry.dropped.
+ * @param binary Whether to encode the updates as binary frames instead of text lines
+ * @return true if the queue is empty
+ */
+bool TelemetryQueue::flush(bool binary)
+{
+    while (true)
+    {
+        if (this->count == 0)
+        {
+            if (this->dropped == this->reported_dropped)
+            {
+                return true;
+            }
+            this->reported_dropped = this->dropped;
+            this->push(TelemetryKey::INTERFACE_TELEMETRY_DROPPED, this->dropped);
+        }
+
+        int space = Serial.availableForWrite();
+        if (space <= 0)
+        {
+            return false;
+        }
+
+        uint8_t buffer[TelemetryQueue::max_line_length];
+        const Entry *entry = &this->entries[this->head];
+        uint8_t length = binary ? this->encode_frame(entry, buffer) : this->format_line(entry, (char *)buffer, true);
+        if (length > space && space < TelemetryQueue::tx_buffer_space)
+        {
+            return false;
+        }
+
+        Serial.write(buffer, length);
+        this->head = (this->head + 1) % TelemetryQueue::capacity;
+        this->count--;
+    }
+}
+
+/**
+ * Writes a key=value text line right away, bypassing the queue.
+ * Waits for the queue to run empty, so the line follows everything queued before it.
+ * @param key Key ID
+ * @param value Value
+ * @return true if the line was written, false to try again later
+ */
+bool TelemetryQueue::write_text(TelemetryKey key, const TelemetryValue &value)
+{
+    if (this->count != 0)
+    {
+        return false;
+    }
+    Entry entry = {TelemetryKeys::get_key_name(key), value};
+    char line[TelemetryQueue::max_line_length];
+    uint8_t length = this->format_line(&entry, line, true);
+    return this->write_now((const uint8_t *)line, length);
+}
+
+/**
+ * Writes a log message built at runtime right away.
+ * The queue only holds text in flash, so the message is dropped if the
+ * transmit buffer has no room for it instead of waiting for the serial port.
+ * @param message Message to send
+ * @param binary Whether to encode the message as a binary frame instead of a text line
+ */
+void TelemetryQueue::write_log(const char *message, bool binary)
+{
+    uint8_t buffer[TelemetryQueue::max_line_length];
+    uint8_t length = 0;
+    if (binary)
+    {
+        length = BinaryProtocol::encode_log(message, buffer);
+    }
+    else
+    {
+        for (; message[length] != '\0' && length < TelemetryQueue::max_line_length - 2; length++)
+        {
+            buffer[length] = message[length];
+        }
+        buffer[length++] = '\r';
+        buffer[length++] = '\n';
+    }
+    if (!this->write_now(buffer, length))
+    {
+        this->dropped++;
+    }
+}
+
+/**
+ * Writes a formatted line or frame if it fits into the serial transmit buffer.
+ * @param data Line or frame
+ * @param length Number of bytes
+ * @return true if it was written
+ */
+bool TelemetryQueue::write_now(const uint8_t *data, uint8_t length)
+{
+    if (Serial.availableForWrite() < length)
+    {
+        return false;
+    }
+    Serial.write(data, length);
+    return true;
+}
+
+/**
+ * Checks whether updates are waiting to be sent.
+ * @return true if the queue is empty
+ */
+bool TelemetryQueue::is_empty()
+{
+    return this->count == 0;
+}
+
+/**
+ * Checks whether the next update would drop or replace a queued one.
+ * @return true if all entries are in use
+ */
+bool TelemetryQueue::is_full()
+{
+    return this->count == TelemetryQueue::capacity;
+}
+
+/**
+ * Gets the number of updates that were dropped or replaced before being sent.
+ * @return Number of dropped updates
+ */
+unsigned long TelemetryQueue::get_dropped()
+{
+    return this->dropped;
+}
+
+/**
+ * Formats an update as a key=value line, like String() would format the value.
+ * Log messages are formatted as the bare message, as the host expects them in text mode.
+ * Lines longer than the buffer are truncated.
+ * @param entry Update to format
+ * @param out Buffer of at least max_line_length characters
+ * @param line_break Whether to terminate the line with \r\n
+ * @return Length of the line
+ */
+uint8_t TelemetryQueue::format_line(const Entry *entry, char *out, bool line_break)
+{
+    char value[16];
+    const char *value_text = value;
+    bool value_in_flash = false;
+    value[0] = '\0';
+    switch (entry->value.type)
+    {
+    case TelemetryValue::Type::NONE:
+        break;
+    case TelemetryValue::Type::NUMBER:
+        ltoa(entry->value.data.number, value, 10);
+        break;
+    case TelemetryValue::Type::FLOAT:
+        dtostrf(entry->value.data.decimal, 1, 2, value);
+        break;
+    case TelemetryValue::Type::TEXT:
+        value_text = (const char *)entry->value.data.text;
+        value_in_flash = true;
+        break;
+    case TelemetryValue::Type::ENUM:
+        // Invalid values are sent with an empty name
+        value_text = (const char *)EnumReflection::get_name(entry->value.data.enumeration.entries,
+                                                            entry->value.data.enumeration.count,
+                                                            entry->value.data.enumeration.index);
+        value_in_flash = value_text != nullptr;
+        if (!value_in_flash)
+        {
+            value_text = value;
+        }
+        break;
+    }
+
+    // Leave room for "=", the line break and the terminator
+    uint8_t limit = TelemetryQueue::max_line_length - 4;
+    uint8_t length = 0;
+    if (entry->key != TelemetryKeys::get_key_name(TelemetryKey::LOG))
+    {
+        const char *key = (const char *)entry->key;
+        for (char c = pgm_read_byte(key); c != '\0' && length < limit; c = pgm_read_byte(++key))
+        {
+            out[length++] = c;
+        }
+        out[length++] = '=';
+    }
+    for (char c = value_in_flash ? pgm_read_byte(value_text) : *value_text;
+         c != '\0' && length < limit + 1;
+         c = value_in_flash ? pgm_read_byte(++value_text) : *++value_text)
+    {
+        out[length++] = c;
+    }
+    if (line_break)
+    {
+        out[length++] = '\r';
+        out[length++] = '\n';
+    }
+    out[length] = '\0';
+    return length;
+}
+
+/**
+ * Encodes an update as a binary frame. Keys without an ID are sent as log frames.
+ * @param entry Update to encode
+ * @param out Buffer of at least max_line_length bytes
+ * @return Length of the frame
+ */
+uint8_t TelemetryQueue::encode_frame(const Entry *entry, uint8_t *out)
+{
+    int key_id = TelemetryKeys::find_key(entry->key);
+    if (key_id < 0)
+    {
+        // Unknown key - send "key=value" as a log message to keep it visible on the host
+        char line[TelemetryQueue::max_line_length];
+        this->format_line(entry, line, false);
+        return BinaryProtocol::encode_log(line, out);
+    }
+
+    switch (entry->value.type)
+    {
+    case TelemetryValue::Type::NONE:
+        break;
+    case TelemetryValue::Type::NUMBER:
+        return BinaryProtocol::encode_number(key_id, entry->value.data.number, out);
+    case TelemetryValue::Type::FLOAT:
+        return BinaryProtocol::encode_float(key_id, entry->value.data.decimal, out);
+    case TelemetryValue::Type::TEXT:
+        return BinaryProtocol::encode_text(key_id, entry->value.data.text, out);
+    case TelemetryValue::Type::ENUM:
+        return BinaryProtocol::encode_enum(key_id, entry->value.data.enumeration.index, out);
+    }
+    return 0;
+}
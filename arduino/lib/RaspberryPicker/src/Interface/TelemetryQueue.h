@@ -0,0 +1,168 @@
+/**
+ * TelemetryQueue.h
+ *
+ * Fixed-size queue of outgoing state updates.
+ * send_state() only stores the address of the key name in flash and the raw value,
+ * without heap allocation;
+ * flush() formats the queued updates as text lines or binary frames and writes
+ * as many of them as fit into the serial transmit buffer, so it never blocks.
+ */
+
+#ifndef RASPBERRY_PICKER_INTERFACE_TELEMETRY_QUEUE_H
+#define RASPBERRY_PICKER_INTERFACE_TELEMETRY_QUEUE_H
+
+#include <Arduino.h>
+
+#include "TelemetryKeys.h"
+#include "TelemetryValue.h"
+
+/**
+ * TelemetryQueue class - ring buffer of state updates waiting for the serial port.
+ */
+class TelemetryQueue
+{
+public:
+    /**
+     * OverflowPolicy enum - what happens to updates that cannot be sent in time.
+     * DROP_OLDEST: Every update is queued, the oldest is dropped when the queue is full
+     * COALESCE: An update replaces the queued value of the same key, unless the key
+     *           reports events; the oldest update is dropped when the queue is full
+     */
+    enum class OverflowPolicy
+    {
+        DROP_OLDEST,
+        COALESCE,
+    };
+
+    static const uint8_t capacity = 16;         // Number of updates the queue can hold
+    static const uint8_t max_line_length = 64;  // Maximum length of a text line incl. line break
+    static const int tx_buffer_space;           // Free space of an empty serial transmit buffer [bytes]
+
+    /**
+     * Constructor - creates an empty queue.
+     * @param policy Overflow policy
+     */
+    TelemetryQueue(OverflowPolicy policy);
+
+    /**
+     * Queues a state update.
+     * @param key State key name in flash, e.g. F("gripper.plate_distance")
+     * @param value Value (number, float, F() string or reflected enum)
+     */
+    template <typename T>
+    void push(const __FlashStringHelper *key, T value)
+    {
+        this->push_value(key, TelemetryValue::from(value));
+    }
+
+    /**
+     * Queues a state update of a key from the dictionary.
+     * @param key Key ID
+     * @param value Value (number, float, F() string or reflected enum)
+     */
+    template <typename T>
+    void push(TelemetryKey key, T value)
+    {
+        this->push_value(TelemetryKeys::get_key_name(key), TelemetryValue::from(value));
+    }
+
+    /**
+     * Queues a state update with an already converted value.
+     * @param key State key name in flash
+     * @param value Value
+     */
+    void push_value(const __FlashStringHelper *key, const TelemetryValue &value);
+
+    /**
+     * Writes queued updates while they fit into the serial transmit buffer.
+     * @param binary Whether to encode the updates as binary frames instead of text lines
+     * @return true if the queue is empty
+     */
+    bool flush(bool binary);
+
+    /**
+     * Writes a key=value text line right away, bypassing the queue,
+     * once the queue is empty and the line fits into the serial transmit buffer.
+     * @param key Key ID
+     * @param value Value
+     * @return true if the line was written, false to try again later
+     */
+    bool write_text(TelemetryKey key, const TelemetryValue &value);
+
+    /**
+     * Writes a log message built at runtime right away if it fits into the serial
+     * transmit buffer, otherwise drops it and counts it as dropped.
+     * Messages in flash are queued with the log key instead.
+     * @param message Message to send, truncated to BinaryProtocol::max_string_length in binary mode
+     * @param binary Whether to encode the message as a binary frame instead of a text line
+     */
+    void write_log(const char *message, bool binary);
+
+    /**
+     * Checks whether updates are waiting to be sent.
+     */
+    bool is_empty();
+
+    /**
+     * Checks whether the next update would drop or replace a queued one.
+     */
+    bool is_full();
+
+    /**
+     * Gets the number of updates that were dropped or replaced before being sent.
+     */
+    unsigned long get_dropped();
+
+private:
+    /**
+     * Entry structure - one queued update.
+     * key: State key name in flash
+     * value: The value
+     */
+    struct Entry
+    {
+        const __FlashStringHelper *key;
+        TelemetryValue value;
+    };
+
+    /**
+     * Finds the slot for an update according to the overflow policy.
+     * @param key State key name in flash
+     * @return Entry to store the update in
+     */
+    Entry *reserve(const __FlashStringHelper *key);
+
+    /**
+     * Writes a formatted line or frame if it fits into the serial transmit buffer.
+     * @param data Line or frame
+     * @param length Number of bytes
+     * @return true if it was written
+     */
+    bool write_now(const uint8_t *data, uint8_t length);
+
+    /**
+     * Formats an update as a key=value line, or a log message as the bare message.
+     * @param entry Update to format
+     * @param out Buffer of at least max_line_length characters
+     * @param line_break Whether to terminate the line with \r\n
+     * @return Length of the line
+     */
+    uint8_t format_line(const Entry *entry, char *out, bool line_break);
+
+    /**
+     * Encodes an update as a binary frame. Keys without an ID are sent as log frames.
+     * @param entry Update to encode
+     * @param out Buffer of at least max_line_length bytes
+     * @return Length of the frame
+     */
+    uint8_t encode_frame(const Entry *entry, uint8_t *out);
+
+    Entry entries[capacity];        // Ring buffer of updates
+    uint8_t head;                   // Index of the oldest update
+    uint8_t count;                  // Number of queued updates
+    OverflowPolicy policy;          // Overflow policy
+    unsigned long dropped;          // Number of dropped or replaced updates
+    unsigned long reported_dropped; // Number of dropped updates last sent to the host
+};
+
+#endif
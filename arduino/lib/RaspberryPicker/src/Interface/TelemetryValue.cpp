@@ -0,0 +1,93 @@
+/**
+ * TelemetryValue.cpp
+ *
+ * Construction and comparison of state update values.
+ */
+
+#include "TelemetryValue.h"
+
+/**
+ * Creates a text value.
+ * @param value String in flash
+ * @return Tagged value
+ */
+TelemetryValue TelemetryValue::from(const __FlashStringHelper *value)
+{
+    TelemetryValue result;
+    result.type = Type::TEXT;
+    result.data.text = value;
+    return result;
+}
+
+/**
+ * Creates an integer value.
+ * @param value Value
+ * @return Tagged value
+ */
+TelemetryValue TelemetryValue::from_number(long value)
+{
+    TelemetryValue result;
+    result.type = Type::NUMBER;
+    result.data.number = value;
+    return result;
+}
+
+/**
+ * Creates a floating point value.
+ * @param value Value
+ * @return Tagged value
+ */
+TelemetryValue TelemetryValue::from_float(float value)
+{
+    TelemetryValue result;
+    result.type = Type::FLOAT;
+    result.data.decimal = value;
+    return result;
+}
+
+/**
+ * Creates the value of a reflected enum.
+ * @param entries Name table of the enum
+ * @param count Number of values of the enum
+ * @param index Value
+ * @return Tagged value
+ */
+TelemetryValue TelemetryValue::from_enum(const EnumName *entries, uint8_t count, uint8_t index)
+{
+    TelemetryValue result;
+    result.type = Type::ENUM;
+    result.data.enumeration.entries = entries;
+    result.data.enumeration.count = count;
+    result.data.enumeration.index = index;
+    return result;
+}
+
+/**
+ * Compares two values, e.g. to suppress repeated updates.
+ * Texts are compared by address.
+ * @param other Value to compare with
+ * @return true if type and value are equal
+ */
+bool TelemetryValue::equals(const TelemetryValue &other) const
+{
+    if (this->type != other.type)
+    {
+        return false;
+    }
+
+    switch (this->type)
+    {
+    case Type::NONE:
+        return true;
+    case Type::NUMBER:
+        return this->data.number == other.data.number;
+    case Type::FLOAT:
+        return this->data.decimal == other.data.decimal;
+    case Type::TEXT:
+        return this->data.text == other.data.text;
+    case Type::ENUM:
+        return this->data.enumeration.entries == other.data.enumeration.entries &&
+               this->data.enumeration.index == other.data.enumeration.index;
+    }
+    return false;
+}
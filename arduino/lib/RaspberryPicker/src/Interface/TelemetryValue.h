@@ -0,0 +1,85 @@
+/**
+ * TelemetryValue.h
+ *
+ * Raw value of a state update, kept until it is formatted for the serial port.
+ * Holds numbers, floats, flash strings and reflected enums in 5 bytes.
+ */
+
+#ifndef RASPBERRY_PICKER_INTERFACE_TELEMETRY_VALUE_H
+#define RASPBERRY_PICKER_INTERFACE_TELEMETRY_VALUE_H
+
+#include <Arduino.h>
+
+#include "EnumReflection.h"
+
+/**
+ * TelemetryValue structure - tagged value of a state update.
+ * type: Which member of data is valid
+ * data: The value, interpreted according to type
+ */
+struct TelemetryValue
+{
+    /**
+     * Type enum - type of the value.
+     * NONE: No value (e.g. nothing sent yet)
+     * NUMBER: Integer
+     * FLOAT: Floating point number
+     * TEXT: String in flash
+     * ENUM: Value of a reflected enum
+     */
+    enum class Type : uint8_t
+    {
+        NONE,
+        NUMBER,
+        FLOAT,
+        TEXT,
+        ENUM,
+    };
+
+    Type type;
+    union
+    {
+        long number;
+        float decimal;
+        const __FlashStringHelper *text;
+        struct
+        {
+            const EnumName *entries;
+            uint8_t count;
+            uint8_t index;
+        } enumeration;
+    } data;
+
+    /**
+     * Creates a value of the matching type.
+     * @param value Number, float, F() string or reflected enum
+     * @return Tagged value
+     */
+    static TelemetryValue from(int value) { return TelemetryValue::from_number(value); }
+    static TelemetryValue from(unsigned int value) { return TelemetryValue::from_number(value); }
+    static TelemetryValue from(long value) { return TelemetryValue::from_number(value); }
+    static TelemetryValue from(unsigned long value) { return TelemetryValue::from_number((long)value); }
+    static TelemetryValue from(float value) { return TelemetryValue::from_float(value); }
+    static TelemetryValue from(double value) { return TelemetryValue::from_float(value); }
+    static TelemetryValue from(const __FlashStringHelper *value);
+
+    template <typename E>
+    static typename EnableIf<IsEnum<E>::value, TelemetryValue>::type from(E value)
+    {
+        return TelemetryValue::from_enum(EnumTable<E>::entries, EnumTable<E>::count, static_cast<uint8_t>(value));
+    }
+
+    /**
+     * Compares two values, e.g. to suppress repeated updates.
+     * @param other Value to compare with
+     * @return true if type and value are equal
+     */
+    bool equals(const TelemetryValue &other) const;
+
+private:
+    static TelemetryValue from_number(long value);
+    static TelemetryValue from_float(float value);
+    static TelemetryValue from_enum(const EnumName *entries, uint8_t count, uint8_t index);
+};
+
+#endif
@@ -17,22 +17,36 @@
 #include "Gripper/Gripper.h"
 #include "Gripper/GripperStepper.h"
 #include "InterfaceMaster.h"
+#include "Interface/MemoryBudget.h"
 
-#include <SoftwareSerial.h>
 #include <Arduino.h>
 
+ENUM_REFLECTION_DEFINE(InterfaceMaster::Protocol, RASPBERRY_PICKER_PROTOCOLS, protocol_names)
+
 /**
  * Constructor - initializes interface with null controller references.
  * Controllers must be added via add_controllers() before use.
+ * Queued updates of the same key are coalesced, as only the latest state matters to the host;
+ * events are queued one by one.
  */
 InterfaceMaster::InterfaceMaster()
+    : telemetry(TelemetryQueue::OverflowPolicy::COALESCE), telemetry_filter(&this->telemetry)
 {
     this->basket_controller = nullptr;
     this->gripper_controller = nullptr;
+    this->protocol = Protocol::TEXT;
+    this->requested_protocol = Protocol::TEXT;
+    this->protocol_pending = false;
+    this->config_field = Config::field_count;
+    this->config_field_end = Config::field_count;
+#ifdef RASPBERRY_PICKER_PROFILE
+    this->profile_phase = PhaseProfiler::phase_count;
+#endif
 };
 
 /**
  * Listens for and processes state change requests from serial interface.
+ * Reads only the bytes already received, so it never waits for the rest of a line.
  * 
  * Expects commands in format: key=value
  * Supported keys:
@@ -41,74 +55,221 @@ InterfaceMaster::InterfaceMaster()
  * - gripper.gripper_state: Control gripper (OPEN/CLOSED_SMALL/CLOSED_LARGE/CLOSED_LIMIT)
  * - controller.program: Set program to execute
  * - controller.state: Set controller state (IDLE/MANUAL/PROGRAM)
+ * - interface.protocol: Set protocol for data sent to the host (TEXT/BINARY)
+ * - diag.profile: Send or clear the phase profile (REPORT/RESET), if compiled in
+ * - config.<name>: Read (?) or change a configuration value, see Interface/Config.h
+ * - config.store: Send, save, reload or reset the configuration (REPORT/SAVE/LOAD/DEFAULTS)
  * 
  * Most commands automatically switch controller to MANUAL mode.
+ * Configuration commands do not, so values can be tuned while programs run.
  */
 void InterfaceMaster::listen_state_change_requests()
 {
     while (Serial.available() > 0)
     {
-        // Read line from serial (newline-terminated)
-        String line = Serial.readStringUntil('\n');
-        line.trim();  // Remove whitespace and carriage return
-        
-        // Parse key=value format
-        int delimiterPos = line.indexOf('=');
-        if (delimiterPos > 0)
+        if (this->parser.feed(Serial.read()))
         {
-            String key = line.substring(0, delimiterPos);
-            String value = line.substring(delimiterPos + 1);
-            
-            // Route command to appropriate controller based on key
-            if (key == "basket.door.state")
-            {
-                BasketDoor::DoorState new_door_state;
-                this->controller->set_state(Controller::State::MANUAL);
-                if (this->basket_controller && BasketDoor::deserialize_door_state(value, &new_door_state))
-                {
-                    this->basket_controller->set_door(new_door_state);
-                }
-            }
-            else if (key == "basket.sorting.state")
-            {
-                BasketSorter::SortingState new_sorting_state;
-                this->controller->set_state(Controller::State::MANUAL);
-                if (this->basket_controller && BasketSorter::deserialize_sorting_state(value, &new_sorting_state))
-                {
-                    this->basket_controller->set_sorting(new_sorting_state);
-                }
-            }
-            else if (key == "gripper.gripper_state")
+            CommandParser::Command command = this->parser.get_command();
+            if (command == CommandParser::Command::CONFIG)
             {
-                GripperStepper::GripperState new_gripper_state;
-                this->controller->set_state(Controller::State::MANUAL);
-                if (this->gripper_controller && GripperStepper::deserialize_gripper_state(value, &new_gripper_state))
-                {
-                    this->gripper_controller->set_gripper(new_gripper_state);
-                }
+                this->handle_config(this->parser.get_key(), this->parser.get_value());
             }
-            else if (key == "controller.program")
+            else
             {
-                Controller::Program program;
-                if (this->controller && this->controller->deserialize_program(value, &program))
-                {
-                    this->controller->set_program(program);
-                }
+                this->handle_command(command, this->parser.get_value());
             }
-            else if (key == "controller.state")
+        }
+    }
+}
+
+/**
+ * Routes a received command to the appropriate controller.
+ * @param command Command to execute
+ * @param value Value of the command
+ */
+void InterfaceMaster::handle_command(CommandParser::Command command, const char *value)
+{
+    switch (command)
+    {
+    case CommandParser::Command::BASKET_DOOR_STATE:
+    {
+        BasketDoor::DoorState new_door_state;
+        this->controller->set_state(Controller::State::MANUAL);
+        if (this->basket_controller && EnumReflection::deserialize(value, &new_door_state))
+        {
+            this->basket_controller->set_door(new_door_state);
+        }
+        break;
+    }
+    case CommandParser::Command::BASKET_SORTING_STATE:
+    {
+        BasketSorter::SortingState new_sorting_state;
+        this->controller->set_state(Controller::State::MANUAL);
+        if (this->basket_controller && EnumReflection::deserialize(value, &new_sorting_state))
+        {
+            this->basket_controller->set_sorting(new_sorting_state);
+        }
+        break;
+    }
+    case CommandParser::Command::GRIPPER_STATE:
+    {
+        GripperStepper::GripperState new_gripper_state;
+        this->controller->set_state(Controller::State::MANUAL);
+        if (this->gripper_controller && EnumReflection::deserialize(value, &new_gripper_state))
+        {
+            // Start the motion without blocking, the main loop advances it
+            this->gripper_controller->start_gripper(new_gripper_state, nullptr);
+        }
+        break;
+    }
+    case CommandParser::Command::CONTROLLER_PROGRAM:
+    {
+        Controller::Program program;
+        if (this->controller && EnumReflection::deserialize(value, &program))
+        {
+            this->controller->set_program(program);
+        }
+        break;
+    }
+    case CommandParser::Command::CONTROLLER_STATE:
+    {
+        Controller::State state;
+        if (this->controller && EnumReflection::deserialize(value, &state))
+        {
+            this->controller->set_state(state);
+        }
+        break;
+    }
+    case CommandParser::Command::INTERFACE_PROTOCOL:
+    {
+        Protocol protocol;
+        if (EnumReflection::deserialize(value, &protocol))
+        {
+            this->set_protocol(protocol);
+        }
+        break;
+    }
+    case CommandParser::Command::DIAG_PROFILE:
+    {
+#ifdef RASPBERRY_PICKER_PROFILE
+        PhaseProfiler::Request request;
+        if (this->controller && EnumReflection::deserialize(value, &request))
+        {
+            if (request == PhaseProfiler::Request::RESET)
             {
-                Controller::State state;
-                if (this->controller && this->controller->deserialize_state(value, &state))
-                {
-                    this->controller->set_state(state);
-                }
+                this->controller->profiler.reset();
             }
             else
             {
-                // Unknown or read-only key - ignore
+                this->send_profile();
             }
         }
+#endif
+        break;
+    }
+    case CommandParser::Command::CONFIG_STORE:
+    {
+        Config::Request request;
+        if (EnumReflection::deserialize(value, &request))
+        {
+            this->handle_config_store(request);
+        }
+        break;
+    }
+    case CommandParser::Command::CONFIG:
+        // Needs the key, handled by handle_config()
+    case CommandParser::Command::UNKNOWN:
+        // Unknown or read-only key - ignore
+        break;
+    }
+}
+
+/**
+ * Reads or changes a configuration value.
+ * A new value takes effect at once, but is only kept over a restart after config.store=SAVE.
+ * The value is sent back in both cases, after the status (CHANGED or REJECTED when writing).
+ * @param key Key of the value, e.g. config.basket.door.open_pos
+ * @param value "?" to read, or the new value as a decimal number
+ */
+void InterfaceMaster::handle_config(const char *key, const char *value)
+{
+    Config::Field field;
+    if (!Config::find(key, &field))
+    {
+        this->telemetry.push(TelemetryKey::CONFIG_STATUS, Config::Status::REJECTED);
+        return;
+    }
+    if (strcmp(value, "?") != 0)
+    {
+        char *end;
+        long number = strtol(value, &end, 10);
+        Config::Status status = Config::Status::REJECTED;
+        if (end != value && *end == '\0' && number >= INT16_MIN && number <= INT16_MAX)
+        {
+            status = Config::set(field, (int16_t)number);
+        }
+        if (status == Config::Status::CHANGED && this->gripper_controller)
+        {
+            this->gripper_controller->apply_config();
+        }
+        this->telemetry.push(TelemetryKey::CONFIG_STATUS, status);
     }
+    this->config_field = static_cast<uint8_t>(field);
+    this->config_field_end = this->config_field + 1;
+}
+
+/**
+ * Executes a config.store request and reports the resulting status.
+ * SAVE blocks while the changed bytes are written to EEPROM (3.3 ms per byte).
+ * @param request Requested action
+ */
+void InterfaceMaster::handle_config_store(Config::Request request)
+{
+    switch (request)
+    {
+    case Config::Request::REPORT:
+        this->config_field = 0;
+        this->config_field_end = Config::field_count;
+        return;
+    case Config::Request::SAVE:
+        this->telemetry.push(TelemetryKey::CONFIG_STATUS, Config::save());
+        return;
+    case Config::Request::LOAD:
+        this->send_config(Config::load());
+        break;
+    case Config::Request::DEFAULTS:
+        Config::reset();
+        this->send_config(Config::Status::DEFAULTS);
+        break;
+    }
+    if (this->gripper_controller)
+    {
+        this->gripper_controller->apply_config();
+    }
+}
+
+/**
+ * Sends the status of the configuration and starts sending all its values.
+ * A report that is still running starts over.
+ * @param status Status to report
+ */
+void InterfaceMaster::send_config(Config::Status status)
+{
+    this->telemetry.push(TelemetryKey::CONFIG_STATUS, status);
+    this->config_field = 0;
+    this->config_field_end = Config::field_count;
+}
+
+/**
+ * Queues a configuration value as config.key, config.value pair.
+ * The pair bypasses the telemetry filter, so the value is sent even if it equals
+ * the previous one, and the host can always assign it to its key.
+ * @param field Field to send
+ */
+void InterfaceMaster::send_config_field(Config::Field field)
+{
+    this->telemetry.push(TelemetryKey::CONFIG_KEY, Config::get_key(field));
+    this->telemetry.push(TelemetryKey::CONFIG_VALUE, Config::get(field));
 }
 
 /**
@@ -122,3 +283,136 @@ void InterfaceMaster::add_controllers(BasketController *basket_controller, Gripp
     this->basket_controller = basket_controller;
     this->gripper_controller = gripper_controller;
 }
+
+/**
+ * Sends a free-text log message built at runtime to the host.
+ * The queue only holds text in flash, so the message is written right away,
+ * or dropped and counted in interface.telemetry.dropped if the transmit buffer is full.
+ * In binary mode, the message is sent as a log frame so it does not corrupt the frame stream.
+ * @param message Message to send
+ */
+void InterfaceMaster::log(const String &message)
+{
+    this->telemetry.write_log(message.c_str(), this->protocol == Protocol::BINARY);
+}
+
+/**
+ * Sends a free-text log message from flash to the host.
+ * The message is queued with the log key and written by flush(), as a bare text
+ * line or as a log frame in binary mode.
+ * @param message Message to send, e.g. F("text")
+ */
+void InterfaceMaster::log(const __FlashStringHelper *message)
+{
+    this->telemetry.push(TelemetryKey::LOG, message);
+}
+
+/**
+ * Sends the SRAM budget: free memory, stack headroom and the heap size of each module.
+ * Module sizes include the objects a controller allocates for its parts.
+ */
+void InterfaceMaster::send_memory_budget()
+{
+    this->send_state(TelemetryKey::DIAG_MEMORY_FREE, MemoryBudget::get_free_memory());
+    this->send_state(TelemetryKey::DIAG_MEMORY_STACK_HEADROOM, MemoryBudget::get_stack_headroom());
+    this->send_state(TelemetryKey::DIAG_MEMORY_CONTROLLER, sizeof(Controller));
+    this->send_state(TelemetryKey::DIAG_MEMORY_INTERFACE, sizeof(InterfaceMaster));
+    this->send_state(TelemetryKey::DIAG_MEMORY_BASKET, sizeof(BasketController));
+    this->send_state(TelemetryKey::DIAG_MEMORY_GRIPPER,
+                     sizeof(GripperController) + sizeof(ColorSensor) + 2 * sizeof(LimitSwitch) + sizeof(PlateStepper));
+}
+
+#ifdef RASPBERRY_PICKER_PROFILE
+/**
+ * Starts sending the phase profile of the controller.
+ * A report that is still running starts over.
+ */
+void InterfaceMaster::send_profile()
+{
+    this->profile_phase = 0;
+}
+
+/**
+ * Queues the statistics of one phase, starting with the phase itself,
+ * so the host can assign the following diag.profile.* updates to it.
+ * The diag.profile.* keys are events, so values equal to those of the previous phase are sent as well.
+ * @param phase Phase to send
+ */
+void InterfaceMaster::send_profile_phase(PhaseProfiler::Phase phase)
+{
+    PhaseProfiler *profiler = &this->controller->profiler;
+    const PhaseProfiler::Stats *stats = profiler->get_stats(phase);
+    this->send_state(TelemetryKey::DIAG_PROFILE_PHASE, phase);
+    this->send_state(TelemetryKey::DIAG_PROFILE_COUNT, stats->count);
+    this->send_state(TelemetryKey::DIAG_PROFILE_MIN_US, stats->count > 0 ? stats->min_us : 0);
+    this->send_state(TelemetryKey::DIAG_PROFILE_MEAN_US, profiler->get_mean_us(phase));
+    this->send_state(TelemetryKey::DIAG_PROFILE_MAX_US, stats->max_us);
+    for (uint8_t i = 0; i < PhaseProfiler::bucket_count; i++)
+    {
+        TelemetryKey key = static_cast<TelemetryKey>(static_cast<uint8_t>(TelemetryKey::DIAG_PROFILE_HISTOGRAM_0) + i);
+        this->send_state(key, stats->histogram[i]);
+    }
+}
+#endif
+
+/**
+ * Checks whether an update of a state variable would be sent right away.
+ * @param key State variable identifier from the dictionary
+ * @return true if the minimum interval of the key has passed
+ */
+bool InterfaceMaster::is_state_due(TelemetryKey key)
+{
+    return this->telemetry_filter.is_due(key);
+}
+
+/**
+ * Writes queued state updates as far as the serial transmit buffer allows.
+ * Held back updates whose interval has passed are queued first.
+ * Never blocks - must be called regularly, e.g. from the main loop.
+ */
+void InterfaceMaster::flush()
+{
+    if (this->protocol_pending)
+    {
+        // Send what was queued in the old protocol, then acknowledge the switch in text,
+        // so the host knows where the binary stream starts
+        if (this->telemetry.flush(this->protocol == Protocol::BINARY) &&
+            this->telemetry.write_text(TelemetryKey::INTERFACE_PROTOCOL, TelemetryValue::from(this->requested_protocol)))
+        {
+            this->protocol = this->requested_protocol;
+            this->protocol_pending = false;
+            // The host (re)connected and has not seen the current state yet
+            this->telemetry_filter.resend_all();
+        }
+        return;
+    }
+
+#ifdef RASPBERRY_PICKER_PROFILE
+    // All phases share the diag.profile.* keys, so the next phase waits until the last one is sent
+    if (this->profile_phase < PhaseProfiler::phase_count && this->telemetry.is_empty())
+    {
+        this->send_profile_phase(static_cast<PhaseProfiler::Phase>(this->profile_phase++));
+    }
+#endif
+    // All values share the config.key and config.value keys, so the next one waits as well
+    if (this->config_field < this->config_field_end && this->telemetry.is_empty())
+    {
+        this->send_config_field(static_cast<Config::Field>(this->config_field++));
+    }
+    this->telemetry_filter.flush();
+    this->telemetry.flush(this->protocol == Protocol::BINARY);
+}
+
+/**
+ * Requests a protocol switch without waiting for the serial port.
+ * flush() sends the updates queued so far in the old protocol, then the acknowledgement
+ * as a text line, and switches. Until then, held back updates, config and profile
+ * reports wait, so the queue drains.
+ * @param protocol Requested protocol
+ */
+void InterfaceMaster::set_protocol(Protocol protocol)
+{
+    this->requested_protocol = protocol;
+    this->protocol_pending = true;
+}
+
@@ -7,15 +7,30 @@
  * - Sends state updates and sensor data back via serial
  * - Parses key=value pairs for state changes
  * - Routes commands to appropriate controllers
+ * State updates are sent as key=value lines, or as binary frames once the host
+ * requested interface.protocol=BINARY.
+ * State updates are queued and written by flush() without blocking.
  */
 
 #ifndef RASPBERRY_PICKER_INTERFACE_MASTER_H
 #define RASPBERRY_PICKER_INTERFACE_MASTER_H
 
-#include <SoftwareSerial.h>
 #include <Arduino.h>
 
 #include "Controller.h"
+#include "Interface/BinaryProtocol.h"
+#include "Interface/CommandParser.h"
+#include "Interface/Config.h"
+#include "Interface/PhaseProfiler.h"
+#include "Interface/TelemetryFilter.h"
+#include "Interface/TelemetryQueue.h"
+#include "Interface/EnumReflection.h"
+#include "Interface/TelemetryKeys.h"
+
+// Values of InterfaceMaster::Protocol
+#define RASPBERRY_PICKER_PROTOCOLS(X) \
+    X(TEXT) \
+    X(BINARY)
 
 class BasketController;
 class GripperController;
@@ -32,26 +47,95 @@ public:
      */
     InterfaceMaster();
     
+    /**
+     * Protocol enum - encoding of the data sent to the host.
+     * TEXT: key=value lines
+     * BINARY: COBS frames with key IDs and typed values, see BinaryProtocol
+     */
+    enum class Protocol
+    {
+        RASPBERRY_PICKER_PROTOCOLS(ENUM_REFLECTION_VALUE)
+    };
+
     /**
      * Template method to send state updates via serial interface.
-     * Formats data as key=value pairs for transmission.
-     * @param key State variable identifier
-     * @param value Current value of the state variable
+     * Queues the update; it is formatted as a key=value pair, or as a binary frame
+     * in binary mode, when flush() writes it.
+     * Unchanged values are not sent again, and a key is sent at most once per
+     * minimum interval - the latest value is sent when the interval has passed.
+     * @param key State variable identifier from the dictionary, see TelemetryKeys.h
+     * @param value Current value of the state variable (number, enum or F() string)
+     */
+    template <typename T>
+    void send_state(TelemetryKey key, T value)
+    {
+        this->telemetry_filter.push(key, value);
+    };
+
+    /**
+     * Checks whether an update of a state variable would be sent right away,
+     * e.g. to skip computing a value that would be held back.
+     * @param key State variable identifier from the dictionary
+     * @return true if the minimum interval of the key has passed
+     */
+    bool is_state_due(TelemetryKey key);
+
+    /**
+     * Template method to send updates of state variables outside the dictionary.
+     * They are sent as log messages in binary mode.
+     * @param key State variable identifier in flash, e.g. F("debug.value")
+     * @param value Current value of the state variable (number, enum or F() string)
      */
     template <typename T>
-    void send_state(const char *key, T value)
+    void send_state(const __FlashStringHelper *key, T value)
     {
-        String str_value = String(value); // Convert value to String internally
-        String data_buffer;
-        data_buffer.concat(key);
-        data_buffer.concat("=");
-        data_buffer.concat(str_value);
-        Serial.println(data_buffer);
-        // this->controller = new Controller(Controller::State::IDLE);
+        this->telemetry.push(key, value);
     };
 
+    /**
+     * Writes queued state updates as far as the serial transmit buffer allows,
+     * after queuing held back updates whose interval has passed.
+     * Never blocks - must be called regularly, e.g. from the main loop.
+     */
+    void flush();
+
+    /**
+     * Sends a free-text log message built at runtime to the host.
+     * Never blocks - the message is dropped if the serial transmit buffer has no room for it.
+     * @param message Message to send
+     */
+    void log(const String &message);
+
+    /**
+     * Sends a free-text log message from flash to the host.
+     * The message is queued and written by flush().
+     * @param message Message to send, e.g. F("text")
+     */
+    void log(const __FlashStringHelper *message);
+
+    /**
+     * Sends the SRAM budget of the firmware as diag.memory.* state updates.
+     */
+    void send_memory_budget();
+
+    /**
+     * Sends the status of the configuration and starts sending all its values
+     * as config.key, config.value pairs, from flush().
+     * @param status Status to report, e.g. the result of Config::load()
+     */
+    void send_config(Config::Status status);
+
+#ifdef RASPBERRY_PICKER_PROFILE
+    /**
+     * Starts sending the phase profile of the controller as diag.profile.* state updates.
+     * The phases are sent one by one from flush().
+     */
+    void send_profile();
+#endif
+
     /**
      * Listens for and processes state change requests from serial interface.
+     * Never blocks - partial lines are kept until the rest arrives.
      * Expects commands in format: key=value
      * Routes commands to appropriate controllers.
      */
@@ -66,9 +150,62 @@ public:
     Controller *controller;  // Pointer to main controller
 
 private:
-    // SoftwareSerial* Serial;
+    /**
+     * Routes a received command to the appropriate controller.
+     * @param command Command to execute
+     * @param value Value of the command
+     */
+    void handle_command(CommandParser::Command command, const char *value);
+
+    /**
+     * Requests a protocol switch, which flush() acknowledges in text form and carries out
+     * once the queued updates are sent.
+     * @param protocol Requested protocol
+     */
+    void set_protocol(Protocol protocol);
+
+    /**
+     * Reads or changes a configuration value (config.<name>=? or config.<name>=<value>).
+     * @param key Key of the value
+     * @param value Received value
+     */
+    void handle_config(const char *key, const char *value);
+
+    /**
+     * Executes a config.store request.
+     * @param request Requested action
+     */
+    void handle_config_store(Config::Request request);
+
+    /**
+     * Queues a configuration value as config.key, config.value pair.
+     * @param field Field to send
+     */
+    void send_config_field(Config::Field field);
+
+#ifdef RASPBERRY_PICKER_PROFILE
+    /**
+     * Queues the statistics of one phase.
+     * @param phase Phase to send
+     */
+    void send_profile_phase(PhaseProfiler::Phase phase);
+#endif
+
     BasketController *basket_controller;      // Pointer to basket controller
     GripperController *gripper_controller;    // Pointer to gripper controller
+    Protocol protocol;                        // Encoding of the data sent to the host
+    Protocol requested_protocol;              // Protocol to switch to once the queue has drained
+    bool protocol_pending;                    // Whether a protocol switch waits to be acknowledged
+    TelemetryQueue telemetry;                 // State updates waiting to be sent
+    TelemetryFilter telemetry_filter;         // Suppresses repeated and too frequent updates
+    CommandParser parser;                     // Parser for received commands
+    uint8_t config_field;                     // Next configuration value to send, field_count if none
+    uint8_t config_field_end;                 // Configuration value after the last one to send
+#ifdef RASPBERRY_PICKER_PROFILE
+    uint8_t profile_phase;                    // Next phase of the profile to send, phase_count if none
+#endif
 };
 
+ENUM_REFLECTION_DECLARE(InterfaceMaster::Protocol)
+
 #endif
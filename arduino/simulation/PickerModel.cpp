@@ -0,0 +1,325 @@
+/**
+ * PickerModel.cpp
+ *
+ * Physical model of the Raspberry Picker for the native build.
+ */
+
+#include <NativeHardware.h>
+#include <Gripper/GripperStepper.h>
+#include <Interface/Config.h>
+
+#include "PickerModel.h"
+
+const PickerModel::Config PickerModel::default_config = {
+    .zero_switch_mm = (float)::Config::values.gripper_plate_distance_limit,
+    .plate_offset_mm = 0,
+    .servo_deg_per_s = 600,  // SG90: 0.1 s per 60 degrees
+    .ldr_tau_ms = 20,
+    .ldr_noise = 0.6,
+    .ambient = 353,
+    .empty = {520, 470, 430},
+    .seed = 1,
+};
+const BerryColor PickerModel::ripe_color = {700, 300, 380};
+const BerryColor PickerModel::unripe_color = {600, 620, 450};
+
+/**
+ * Constructor - creates the model of the robot with the given wiring.
+ * @param gripper_pinout Pins of the gripper
+ * @param basket_pinout Pins of the basket servos
+ * @param config Physical parameters
+ */
+PickerModel::PickerModel(const GripperPinout *gripper_pinout, const BasketPinout *basket_pinout, Config config)
+{
+    this->gripper_pinout = *gripper_pinout;
+    this->basket_pinout = *basket_pinout;
+    this->config = config;
+    this->plate_stepper = nullptr;
+    this->mm_per_step = GripperStepper::transmission_ratio / GripperStepper::steps_per_revolution;
+    this->plate_position = 0;
+    this->output_changes = 0;
+
+    this->holding = false;
+    this->gripped = false;
+    this->grip_us = 0;
+    this->outcome = Outcome::NONE;
+
+    this->lit_channel = -1;
+    this->ldr_start = config.ambient;
+    this->ldr_change_us = 0;
+    this->noise_state = config.seed != 0 ? config.seed : 1;
+
+    this->servo_angles[0] = ::Config::values.basket_sorting_idle_pos;
+    this->servo_angles[1] = ::Config::values.basket_door_closed_pos;
+    this->servos_moving = true;
+    this->servo_update_us = 0;
+    this->sorting_late_count = 0;
+}
+
+/**
+ * Connects the model to the simulated board and the plate stepper.
+ * @param plate_stepper Stepper moving the gripper plates
+ */
+void PickerModel::attach(PlateStepper *plate_stepper)
+{
+    this->plate_stepper = plate_stepper;
+    this->servo_update_us = NativeHardware::get_time_us();
+    NativeHardware::set_tick_handler(PickerModel::handle_tick, this);
+    NativeHardware::set_analog_source(PickerModel::handle_analog, this);
+    this->update_plates(this->servo_update_us);
+    this->update(this->servo_update_us);
+}
+
+/**
+ * Places a berry between the plates, replacing any held one.
+ * @param berry Berry to place
+ */
+void PickerModel::load_berry(const Berry &berry)
+{
+    this->berry = berry;
+    this->holding = true;
+    this->gripped = false;
+    this->outcome = Outcome::NONE;
+    this->update_plates(NativeHardware::get_time_us());
+}
+
+/**
+ * Gets what happened to the last berry and clears it.
+ * @return Outcome since the berry was loaded
+ */
+PickerModel::Outcome PickerModel::take_outcome()
+{
+    Outcome outcome = this->outcome;
+    this->outcome = Outcome::NONE;
+    return outcome;
+}
+
+/**
+ * Gets the physical distance between the plates.
+ * @return Plate distance [mm]
+ */
+float PickerModel::get_plate_distance_mm()
+{
+    return this->plate_position * this->mm_per_step + this->config.plate_offset_mm;
+}
+
+/**
+ * Gets the physical angle of a servo.
+ * @param pin Servo pin
+ * @return Angle [degrees]
+ */
+float PickerModel::get_servo_angle(uint8_t pin)
+{
+    return this->servo_angles[pin == this->basket_pinout.door_pin ? 1 : 0];
+}
+
+/**
+ * Checks whether a servo has reached its commanded angle.
+ * @param pin Servo pin
+ * @return true if the servo is not moving
+ */
+bool PickerModel::is_servo_settled(uint8_t pin)
+{
+    return this->get_servo_angle(pin) == NativeHardware::get_servo_angle(pin);
+}
+
+/**
+ * Gets the number of berries taken while the sorting flap was still moving.
+ * @return Number of late sorting moves
+ */
+unsigned long PickerModel::get_sorting_late_count()
+{
+    return this->sorting_late_count;
+}
+
+/**
+ * Advances the model to the current time.
+ * Only the parts whose inputs changed are updated, as this runs on every clock advance.
+ * @param now_us Current virtual time [us]
+ */
+void PickerModel::update(uint64_t now_us)
+{
+    unsigned long output_changes = NativeHardware::get_output_changes();
+    bool outputs_changed = output_changes != this->output_changes;
+    this->output_changes = output_changes;
+
+    if (outputs_changed || this->servos_moving)
+    {
+        this->update_servos(now_us);
+    }
+    else
+    {
+        this->servo_update_us = now_us;
+    }
+
+#ifdef RASPBERRY_PICKER_TABLE_STEPPER
+    // Unlike the AccelStepper mock, TableStepper cannot request wakeups itself
+    int32_t step_in_us = this->plate_stepper->get_next_step_us() - (uint32_t)now_us;
+    if (this->plate_stepper->isRunning() && step_in_us > 0)
+    {
+        NativeHardware::request_wakeup(now_us + step_in_us);
+    }
+#endif
+
+    bool waiting_for_pick = this->holding && this->gripped && this->berry.pick_after_ms > 0;
+    if (this->plate_stepper->currentPosition() != this->plate_position || waiting_for_pick)
+    {
+        this->update_plates(now_us);
+    }
+
+    // The LDR starts settling towards a new level whenever another LED is lit
+    int channel = outputs_changed ? this->get_lit_channel() : this->lit_channel;
+    if (channel != this->lit_channel)
+    {
+        float target = this->get_ldr_target();
+        float elapsed_ms = (now_us - this->ldr_change_us) / 1000.0f;
+        this->ldr_start = target + (this->ldr_start - target) * expf(-elapsed_ms / this->config.ldr_tau_ms);
+        this->ldr_change_us = now_us;
+        this->lit_channel = channel;
+    }
+}
+
+/**
+ * Moves the servos towards their command at constant speed.
+ * @param now_us Current virtual time [us]
+ */
+void PickerModel::update_servos(uint64_t now_us)
+{
+    int servo_pins[2] = {this->basket_pinout.sorting_pin, this->basket_pinout.door_pin};
+    float travel = this->config.servo_deg_per_s * (now_us - this->servo_update_us) / 1e6f;
+    this->servo_update_us = now_us;
+    this->servos_moving = false;
+    for (int i = 0; i < 2; i++)
+    {
+        int command = NativeHardware::get_servo_angle(servo_pins[i]);
+        if (command < 0)
+        {
+            continue;
+        }
+        float error = command - this->servo_angles[i];
+        this->servo_angles[i] = fabsf(error) <= travel ? command : this->servo_angles[i] + (error > 0 ? travel : -travel);
+        this->servos_moving |= this->servo_angles[i] != command;
+    }
+}
+
+/**
+ * Tracks the held berry and sets the switch inputs from the plate distance.
+ * The berry is touched when the plates reach its width, and gone when taken or released.
+ * @param now_us Current virtual time [us]
+ */
+void PickerModel::update_plates(uint64_t now_us)
+{
+    this->plate_position = this->plate_stepper != nullptr ? this->plate_stepper->currentPosition() : 0;
+    float distance = this->get_plate_distance_mm();
+    if (this->holding)
+    {
+        if (!this->gripped && distance <= this->berry.width_mm)
+        {
+            this->gripped = true;
+            this->grip_us = now_us;
+        }
+        if (this->gripped && this->berry.pick_after_ms > 0 && now_us - this->grip_us >= this->berry.pick_after_ms * 1000ULL)
+        {
+            this->holding = false;
+            this->outcome = Outcome::PICKED;
+            if (!this->is_servo_settled(this->basket_pinout.sorting_pin))
+            {
+                this->sorting_late_count++;
+            }
+        }
+        else if (this->gripped && distance > this->berry.width_mm)
+        {
+            this->holding = false;
+            this->outcome = Outcome::RELEASED;
+        }
+    }
+
+    bool pressure = this->holding && distance <= this->berry.width_mm;
+    NativeHardware::set_input(this->gripper_pinout.limit_switch_pressure_pin, pressure ? HIGH : LOW);
+    NativeHardware::set_input(this->gripper_pinout.limit_switch_zero_pin, distance <= this->config.zero_switch_mm ? HIGH : LOW);
+}
+
+/**
+ * Gets an LDR reading at the current time.
+ * @param now_us Current virtual time [us]
+ * @return ADC reading (0-1023)
+ */
+int PickerModel::read_ldr(uint64_t now_us)
+{
+    this->update(now_us);
+    float target = this->get_ldr_target();
+    float elapsed_ms = (now_us - this->ldr_change_us) / 1000.0f;
+    float reading = target + (this->ldr_start - target) * expf(-elapsed_ms / this->config.ldr_tau_ms);
+    reading += this->config.ldr_noise * this->next_noise();
+    return constrain((int)lroundf(reading), 0, 1023);
+}
+
+void PickerModel::handle_tick(uint64_t now_us, void *context)
+{
+    static_cast<PickerModel *>(context)->update(now_us);
+}
+
+int PickerModel::handle_analog(uint8_t pin, uint64_t now_us, void *context)
+{
+    PickerModel *model = static_cast<PickerModel *>(context);
+    return pin == model->gripper_pinout.color_sensor_pinout.ldr ? model->read_ldr(now_us) : 0;
+}
+
+/**
+ * Gets the settled LDR reading for the lit channel and the berry in front of the sensor.
+ * @return Reading [ADC counts]
+ */
+float PickerModel::get_ldr_target()
+{
+    const BerryColor &color = this->holding ? this->berry.color : this->config.empty;
+    switch (this->lit_channel)
+    {
+    case 0:
+        return color.r;
+    case 1:
+        return color.g;
+    case 2:
+        return color.b;
+    default:
+        return this->config.ambient;
+    }
+}
+
+/**
+ * Gets the channel of the LED that is on.
+ * @return 0-2 for red, green and blue, -1 if all LEDs are off
+ */
+int PickerModel::get_lit_channel()
+{
+    const ColorSensor::Pinout &pinout = this->gripper_pinout.color_sensor_pinout;
+    if (NativeHardware::get_output(pinout.led_r) == HIGH)
+    {
+        return 0;
+    }
+    if (NativeHardware::get_output(pinout.led_g) == HIGH)
+    {
+        return 1;
+    }
+    if (NativeHardware::get_output(pinout.led_b) == HIGH)
+    {
+        return 2;
+    }
+    return -1;
+}
+
+/**
+ * Draws normally distributed noise (Box-Muller on a xorshift generator).
+ * @return Sample with zero mean and unit variance
+ */
+float PickerModel::next_noise()
+{
+    float u[2];
+    for (int i = 0; i < 2; i++)
+    {
+        this->noise_state ^= this->noise_state << 13;
+        this->noise_state ^= this->noise_state >> 17;
+        this->noise_state ^= this->noise_state << 5;
+        u[i] = (this->noise_state + 1.0f) / 4294967297.0f;
+    }
+    return sqrtf(-2 * logf(u[0])) * cosf(2 * (float)PI * u[1]);
+}
@@ -0,0 +1,183 @@
+/**
+ * PickerModel.h
+ *
+ * Physical model of the Raspberry Picker for the native build.
+ * Drives the simulated inputs of NativeHardware from the actuator outputs:
+ * - plate distance from the plate stepper position (GripperStepper constants)
+ * - pressure switch closed while the plates touch a held berry, zero switch at the limit distance
+ * - LDR reading per lit LED and berry colour, settling with a first-order response plus noise
+ * - servo angles travelling towards their command at a fixed speed
+ * The model is advanced by the NativeHardware tick handler, so it follows the virtual clock.
+ */
+
+#ifndef RASPBERRY_PICKER_SIMULATION_PICKER_MODEL_H
+#define RASPBERRY_PICKER_SIMULATION_PICKER_MODEL_H
+
+#include <Arduino.h>
+#include <AccelStepper.h>
+
+#include <Basket/Basket.h>
+#include <Gripper/Gripper.h>
+
+/**
+ * BerryColor structure - settled LDR readings [ADC counts] with each LED on.
+ */
+struct BerryColor
+{
+    float r;
+    float g;
+    float b;
+};
+
+/**
+ * Berry structure - a raspberry placed between the plates.
+ * width_mm: Width of the berry [mm]
+ * color: LDR readings with the berry in front of the sensor
+ * pick_after_ms: Time after contact until the user takes the berry (0: never)
+ */
+struct Berry
+{
+    float width_mm;
+    BerryColor color;
+    unsigned long pick_after_ms;
+};
+
+/**
+ * PickerModel class - simulated mechanics and sensors of the robot.
+ */
+class PickerModel
+{
+public:
+    /**
+     * Outcome enum - what happened to the last berry.
+     * - NONE: No berry or still held
+     * - PICKED: The user took the berry from the closed gripper
+     * - RELEASED: The gripper opened while holding the berry
+     */
+    enum class Outcome
+    {
+        NONE,
+        PICKED,
+        RELEASED
+    };
+
+    /**
+     * Config structure - physical parameters of the model.
+     */
+    struct Config
+    {
+        float zero_switch_mm;     // Plate distance at which the zero switch closes [mm]
+        float plate_offset_mm;    // Physical minus counted plate distance (calibration error) [mm]
+        float servo_deg_per_s;    // Servo travel speed [degrees/s]
+        float ldr_tau_ms;         // Time constant of the LDR response [ms]
+        float ldr_noise;          // Standard deviation of LDR readings [ADC counts]
+        float ambient;            // LDR reading with all LEDs off [ADC counts]
+        BerryColor empty;         // LDR readings without a berry [ADC counts]
+        uint32_t seed;            // Seed of the noise generator
+    };
+
+    static const Config default_config;   // Parameters of the built robot
+    static const BerryColor ripe_color;   // Typical readings of a ripe berry
+    static const BerryColor unripe_color; // Typical readings of an unripe berry
+
+    /**
+     * Constructor - creates the model of the robot with the given wiring.
+     * @param gripper_pinout Pins of the gripper
+     * @param basket_pinout Pins of the basket servos
+     * @param config Physical parameters
+     */
+    PickerModel(const GripperPinout *gripper_pinout, const BasketPinout *basket_pinout, Config config);
+
+    /**
+     * Connects the model to the simulated board and the plate stepper.
+     * @param plate_stepper Stepper moving the gripper plates
+     */
+    void attach(PlateStepper *plate_stepper);
+
+    /**
+     * Places a berry between the plates, replacing any held one.
+     * @param berry Berry to place
+     */
+    void load_berry(const Berry &berry);
+
+    /**
+     * Gets what happened to the last berry and clears it.
+     * @return Outcome since the berry was loaded
+     */
+    Outcome take_outcome();
+
+    /**
+     * Gets the physical distance between the plates.
+     * @return Plate distance [mm]
+     */
+    float get_plate_distance_mm();
+
+    /**
+     * Gets the physical angle of a servo.
+     * @param pin Servo pin
+     * @return Angle [degrees]
+     */
+    float get_servo_angle(uint8_t pin);
+
+    /**
+     * Checks whether a servo has reached its commanded angle.
+     * @param pin Servo pin
+     * @return true if the servo is not moving
+     */
+    bool is_servo_settled(uint8_t pin);
+
+    /**
+     * Gets the number of berries taken while the sorting flap was still moving.
+     * @return Number of late sorting moves
+     */
+    unsigned long get_sorting_late_count();
+
+    /**
+     * Advances the model to the current time.
+     * @param now_us Current virtual time [us]
+     */
+    void update(uint64_t now_us);
+
+    /**
+     * Gets an LDR reading at the current time.
+     * @param now_us Current virtual time [us]
+     * @return ADC reading (0-1023)
+     */
+    int read_ldr(uint64_t now_us);
+
+private:
+    static void handle_tick(uint64_t now_us, void *context);
+    static int handle_analog(uint8_t pin, uint64_t now_us, void *context);
+
+    void update_servos(uint64_t now_us);
+    void update_plates(uint64_t now_us);
+    float get_ldr_target();
+    int get_lit_channel();
+    float next_noise();
+
+    GripperPinout gripper_pinout;  // Pins of the gripper
+    BasketPinout basket_pinout;    // Pins of the basket servos
+    Config config;                 // Physical parameters
+    PlateStepper *plate_stepper;   // Stepper moving the plates
+    float mm_per_step;             // Plate travel per step [mm]
+    long plate_position;           // Plate stepper position at the last update [steps]
+    unsigned long output_changes;  // Output writes seen at the last update
+
+    Berry berry;                   // Berry between the plates
+    bool holding;                  // Whether a berry is between the plates
+    bool gripped;                  // Whether the plates touch the held berry
+    uint64_t grip_us;              // Time of the first contact with the held berry [us]
+    Outcome outcome;               // What happened to the last berry
+
+    int lit_channel;               // Channel lit at the last update (-1: none)
+    float ldr_start;               // LDR reading when the lit channel changed
+    uint64_t ldr_change_us;        // Time the lit channel changed [us]
+    uint32_t noise_state;          // State of the noise generator
+
+    float servo_angles[2];         // Physical angles of the sorting and door servo [degrees]
+    bool servos_moving;            // Whether a servo has not reached its command yet
+    uint64_t servo_update_us;      // Time of the last servo update [us]
+    unsigned long sorting_late_count; // Berries taken while the sorting flap was moving
+};
+
+#endif
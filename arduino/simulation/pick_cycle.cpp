@@ -0,0 +1,207 @@
+/**
+ * pick_cycle.cpp
+ *
+ * Discrete-event simulation of the picking cycle on the virtual clock.
+ * Runs the unmodified firmware (Controller::run_reset, run_pgm1 for every berry and
+ * run_pgm2 whenever the basket is full) against PickerModel, with random berry widths,
+ * colours and picking times, and prints the distribution of the cycle times.
+ * Waits such as picking_delay_ms or basket.door.delay_ms only cost simulation steps,
+ * so thousands of cycles run per second.
+ * The state is journaled after every program, as by the main loop, and the wear of the busiest EEPROM cell is printed.
+ * Built with RASPBERRY_PICKER_PROFILE, it also prints the phase profile collected by the firmware.
+ * Build and run with pick_cycle.sh [cycles] [seed].
+ */
+
+#include <Arduino.h>
+#include <NativeHardware.h>
+#include <EEPROM.h>
+
+#include <Controller.h>
+#include <InterfaceMaster.h>
+#include <Basket/Basket.h>
+#include <Gripper/Gripper.h>
+#include <Interface/Config.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "PickerModel.h"
+
+// Same wiring as raspberry_picker.ino
+static BasketPinout basket_pinout{
+    .sorting_pin = 13,
+    .door_pin = 12,
+};
+static GripperPinout gripper_pinout{
+    .color_sensor_pinout = ColorSensor::Pinout{7, 6, 5, A5},
+    .stepper_motor_pins = {8, 9, 10, 11},
+    .limit_switch_zero_pin = 4,
+    .limit_switch_pressure_pin = 3,
+};
+
+// Berry population
+static const float min_width_mm = 15;        // Smallest berry [mm]
+static const float max_width_mm = 30;        // Largest berry [mm]
+static const float ripe_fraction = 0.8;      // Share of ripe berries
+static const float never_picked_fraction = 0.05; // Share of ripe berries the user does not take
+static const float color_spread = 25;        // Standard deviation of the berry colour [ADC counts]
+static const unsigned long min_pick_ms = 500;  // Fastest user [ms]
+static const unsigned long max_pick_ms = 4000; // Slowest user [ms]
+
+/**
+ * Prints the distribution of a list of durations.
+ * @param name Name of the program
+ * @param durations_us Durations [us], sorted in place
+ */
+static void print_distribution(const char *name, std::vector<uint64_t> &durations_us)
+{
+    if (durations_us.empty())
+    {
+        printf("%-6s %7d\n", name, 0);
+        return;
+    }
+    std::sort(durations_us.begin(), durations_us.end());
+    double sum = 0;
+    for (uint64_t duration : durations_us)
+    {
+        sum += duration;
+    }
+    size_t n = durations_us.size();
+    printf("%-6s %7zu %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f\n", name, n,
+           sum / n / 1000, durations_us[0] / 1000.0, durations_us[n / 2] / 1000.0,
+           durations_us[n * 9 / 10] / 1000.0, durations_us[n * 99 / 100] / 1000.0, durations_us[n - 1] / 1000.0);
+}
+
+#ifdef RASPBERRY_PICKER_PROFILE
+/**
+ * Prints the phase profile collected by the controller.
+ * @param profiler Profiler of the controller
+ */
+static void print_profile(PhaseProfiler *profiler)
+{
+    printf("phase            count   mean_ms    min_ms    max_ms  histogram\n");
+    for (uint8_t i = 0; i < PhaseProfiler::phase_count; i++)
+    {
+        PhaseProfiler::Phase phase = static_cast<PhaseProfiler::Phase>(i);
+        const PhaseProfiler::Stats *stats = profiler->get_stats(phase);
+        printf("%-14s %7u %9.1f %9.1f %9.1f ", (const char *)EnumReflection::serialize(phase), stats->count,
+               profiler->get_mean_us(phase) / 1000.0, stats->count > 0 ? stats->min_us / 1000.0 : 0, stats->max_us / 1000.0);
+        for (uint8_t bucket = 0; bucket < PhaseProfiler::bucket_count; bucket++)
+        {
+            printf(" %u", stats->histogram[bucket]);
+        }
+        printf("\n");
+    }
+}
+#endif
+
+/**
+ * Runs one program and measures it on the virtual clock.
+ * @param controller Main controller
+ * @param interface Interface to flush afterwards, like the main loop does
+ * @param program Program to run
+ * @return Virtual duration [us]
+ */
+static uint64_t run_program(Controller *controller, InterfaceMaster *interface, void (Controller::*program)())
+{
+    uint64_t start_us = NativeHardware::get_time_us();
+    (controller->*program)();
+    controller->save_state(); // As the main loop does once the plate stands still
+    interface->flush();
+    return NativeHardware::get_time_us() - start_us;
+}
+
+int main(int argc, char **argv)
+{
+    long cycles = argc > 1 ? atol(argv[1]) : 1000;
+    unsigned long seed = argc > 2 ? strtoul(argv[2], nullptr, 10) : 1;
+
+    NativeHardware::reset();
+    NativeHardware::set_fast_forward(true);
+    Serial.set_tx_handler(nullptr, nullptr); // Only count the telemetry
+    Serial.begin(9600);
+
+    Config::load(); // Erased EEPROM, the defaults
+    InterfaceMaster *interface = new InterfaceMaster();
+    Controller *controller = new Controller(Controller::State::IDLE, interface);
+    BasketController *basket = new BasketController(&basket_pinout, interface);
+    GripperController *gripper = new GripperController(&gripper_pinout, interface);
+    interface->add_controllers(basket, gripper);
+    interface->controller = controller;
+    controller->add_controllers(basket, gripper);
+    controller->add_interface(interface);
+    controller->resume(); // Erased EEPROM, a cold start
+
+    PickerModel::Config config = PickerModel::default_config;
+    config.seed = seed;
+    PickerModel model(&gripper_pinout, &basket_pinout, config);
+    model.attach(gripper->plate_stepper);
+
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> uniform(0, 1);
+    std::normal_distribution<float> spread(0, color_spread);
+
+    std::vector<uint64_t> reset_us, pick_us, empty_us;
+    unsigned long misclassified = 0;
+    unsigned long berries_in_basket = 0;
+    auto wall_start = std::chrono::steady_clock::now();
+
+    reset_us.push_back(run_program(controller, interface, &Controller::run_reset));
+    for (long cycle = 0; cycle < cycles; cycle++)
+    {
+        bool ripe = uniform(random) < ripe_fraction;
+        BerryColor color = ripe ? PickerModel::ripe_color : PickerModel::unripe_color;
+        color.r += spread(random);
+        color.g += spread(random);
+        color.b += spread(random);
+        Berry berry{
+            .width_mm = min_width_mm + (max_width_mm - min_width_mm) * uniform(random),
+            .color = color,
+            .pick_after_ms = uniform(random) < never_picked_fraction
+                                 ? 0
+                                 : (unsigned long)(min_pick_ms + (max_pick_ms - min_pick_ms) * uniform(random)),
+        };
+        model.load_berry(berry);
+
+        pick_us.push_back(run_program(controller, interface, &Controller::run_pgm1));
+
+        // Ripe berries should be taken (or time out), unripe ones released right away
+        PickerModel::Outcome outcome = model.take_outcome();
+        bool kept = outcome == PickerModel::Outcome::PICKED || (berry.pick_after_ms == 0 && ripe);
+        if (kept != ripe)
+        {
+            misclassified++;
+        }
+        if (outcome == PickerModel::Outcome::PICKED && ++berries_in_basket >= (unsigned long)Config::values.basket_door_max_fill)
+        {
+            empty_us.push_back(run_program(controller, interface, &Controller::run_pgm2));
+            berries_in_basket = 0;
+        }
+    }
+
+    double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    double virtual_s = NativeHardware::get_time_us() / 1e6;
+
+    printf("program  count   mean_ms    min_ms    p50_ms    p90_ms    p99_ms    max_ms\n");
+    print_distribution("reset", reset_us);
+    print_distribution("pgm1", pick_us);
+    print_distribution("pgm2", empty_us);
+#ifdef RASPBERRY_PICKER_PROFILE
+    print_profile(&controller->profiler);
+#endif
+    printf("misclassified berries: %lu of %ld\n", misclassified, cycles);
+    printf("berries taken while the sorting flap moved: %lu\n", model.get_sorting_late_count());
+    printf("serial bytes sent: %lu\n", Serial.get_tx_count());
+    unsigned long max_cell_writes = 0;
+    for (int address = StateJournal::start_address; address < EEPROM.length(); address++)
+    {
+        max_cell_writes = std::max(max_cell_writes, EEPROM.get_write_count(address));
+    }
+    printf("state journal: at most %lu writes to one EEPROM cell\n", max_cell_writes);
+    printf("simulated %.1f s in %.3f s wall time (%.0f pick cycles/s, %.0fx real time)\n",
+           virtual_s, wall_s, cycles / wall_s, virtual_s / wall_s);
+    return 0;
+}
@@ -0,0 +1,3 @@
+dir=$(dirname "$0")
+g++ -O2 -std=gnu++11 -DARDUINO_NATIVE_NO_MAIN -DRASPBERRY_PICKER_PROFILE -include Arduino.h -I"$dir/../lib/ArduinoNative/src" -I"$dir/../lib/RaspberryPicker/src" \
+    "$dir/pick_cycle.cpp" "$dir/PickerModel.cpp" $(find "$dir/../lib/ArduinoNative/src" "$dir/../lib/RaspberryPicker/src" -name '*.cpp') -o "$dir/pick_cycle" && "$dir/pick_cycle" "$@"
@@ -20,6 +20,9 @@
 
 #include <Gripper/ColorSensor.h>
 
+#include <Interface/Config.h>
+#include <Interface/MemoryBudget.h>
+
 // Pin configuration for the basket system
 // sorting_pin controls the servo that directs raspberries to small/large compartments
 // door_pin controls the servo that opens/closes the basket door for emptying
@@ -50,41 +53,57 @@ Controller *controller;                 // Main controller coordinating all oper
  * Initialization function called once at startup.
  * Sets up serial communication and initializes all controller objects.
  * Establishes connections between controllers for coordinated operation.
+ * Log strings are kept in flash with F() to save SRAM.
  */
 void setup()
 {
+  // Mark the free SRAM, so the deepest stack use can be reported
+  MemoryBudget::paint_stack();
+
   // Initialize serial communication at 9600 baud for debugging and interface
   Serial.begin(9600);
   while (!Serial)
   {
   };
 
-  Serial.println("initialising");
+  Serial.println(F("initialising"));
+
+  // Load the tuning constants from EEPROM before the controllers use them
+  Config::Status config_status = Config::load();
 
   // Create interface master for serial communication
   interface_master = new InterfaceMaster();
-  Serial.println("interface ready");
+  Serial.println(F("interface ready"));
 
   // Create main controller in IDLE state
   controller = new Controller(Controller::State::IDLE, interface_master);
-  Serial.println("controller created");
+  Serial.println(F("controller created"));
 
   // Initialize basket controller with pin configuration
   basket_controller = new BasketController(&basket_pinout, interface_master);
-  Serial.println("basket controller ready");
+  Serial.println(F("basket controller ready"));
   
   // Initialize gripper controller with pin configuration and sensors
   gripper_controller = new GripperController(&gripper_pinout, interface_master);
-  Serial.println("gripper controller ready");
+  Serial.println(F("gripper controller ready"));
 
   // Connect all controllers to enable coordinated operation
   interface_master->add_controllers(basket_controller, gripper_controller);
   interface_master->controller = controller;
-  Serial.println("controller connected to interface");
+  Serial.println(F("controller connected to interface"));
   controller->add_controllers(basket_controller, gripper_controller);
-  Serial.println("controllers connected to main controller");
+  Serial.println(F("controllers connected to main controller"));
   controller->add_interface(interface_master);
-  Serial.println("interface connected to main controller");
+  Serial.println(F("interface connected to main controller"));
+
+  // Resume from the state journaled before the last power loss
+  interface_master->send_state(TelemetryKey::JOURNAL_STATUS, controller->resume());
+
+  // Report the SRAM left after initialisation
+  interface_master->send_memory_budget();
+
+  // Report where the configuration came from and its values
+  interface_master->send_config(config_status);
 }
 
 /**
@@ -95,9 +114,14 @@ void setup()
  * - PROGRAM: Executing automated programs based on selected program type
  * 
  * After completing a program, the system returns to IDLE state.
+ * Gripper motions started from the interface are advanced on every iteration.
  */
 void loop()
 {
+  // Advance any non-blocking gripper motion and send queued telemetry
+  gripper_controller->tick();
+  interface_master->flush();
+
   switch (controller->get_state())
   {
   case Controller::State::IDLE:
@@ -144,7 +168,14 @@ void loop()
     }
     // Return to IDLE state after program execution
     controller->set_state(Controller::State::IDLE);
+    // Report the stack use of the program
+    interface_master->send_memory_budget();
     break;
   }
-  delay(100); // Small delay for system stability
+  if (!gripper_controller->is_moving())
+  {
+    // Journal counts and positions while the plate stands still
+    controller->save_state();
+    delay(100); // Small delay for system stability
+  }
 }
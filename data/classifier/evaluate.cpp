@@ -0,0 +1,697 @@
+/**
+ * evaluate.cpp
+ *
+ * Model selection harness for the ripeness decision of GripperController::is_ripe.
+ * Runs stratified k-fold cross-validation on every labeled dataset, for every
+ * model family (logistic regression, principal component, decision tree) and
+ * feature subset (colour channels, with and without ambient, with and without
+ * width), on all cores. Reports per configuration the accuracy, the area under
+ * the ROC curve, a sweep of the decision threshold on the ripe probability and
+ * the estimated cost of one inference on the Arduino, and picks the cheapest
+ * configuration reaching an accuracy target. Build and run with evaluate.sh.
+ *
+ * The models are trained as export.py does for the firmware: the logistic
+ * regression to its optimum (Newton steps), the principal component of the raw
+ * features with a logistic calibration of the projection, the decision tree
+ * with CART, with the channels minus ambient as extra inputs.
+ */
+
+#include "logistic_regression/logistic_regression.h"
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+/**
+ * Family enum - model families of data/classifier.
+ */
+enum class Family
+{
+    LOGISTIC_REGRESSION,
+    PRINCIPAL_COMPONENT,
+    DECISION_TREE,
+};
+static const char *family_names[] = {"logistic", "pca", "tree"};
+static const Family families[] = {Family::LOGISTIC_REGRESSION, Family::PRINCIPAL_COMPONENT, Family::DECISION_TREE};
+
+/**
+ * Options structure - command line arguments.
+ * folds: Number of cross-validation folds
+ * target: Accuracy the chosen model has to reach
+ * max_depth: Depth of the decision trees
+ * fp_penalty, fn_penalty: Cost of picking an unripe berry and of dropping a ripe one,
+ *                         as in decision_tree/color_clasification.ipynb
+ * sweep: Whether to print the accuracy at every threshold
+ */
+struct Options
+{
+    std::vector<const char *> datasets;
+    int folds = 5;
+    double target = 0.95;
+    int max_depth = 4;
+    double fp_penalty = 35;
+    double fn_penalty = 15;
+    unsigned long seed = 0;
+    unsigned threads = 0;
+    bool sweep = false;
+};
+
+/**
+ * Configuration structure - one model family on one feature subset of one dataset.
+ * scores: Out-of-fold ripe probability per row of the dataset
+ * fold_accuracies: Accuracy of every fold at threshold 0.5
+ * cycles: Estimated CPU cycles per inference on the Arduino (mean over the folds)
+ */
+struct Configuration
+{
+    size_t dataset;
+    std::vector<size_t> columns;
+    std::string features;
+    Family family;
+    std::vector<double> scores;
+    std::vector<double> fold_accuracies;
+    std::vector<double> fold_cycles;
+};
+
+// Estimated AVR cycles of the operations of the fixed-point models (RipenessModels.cpp),
+// measure the real ones with pio run -e uno_ripeness
+static const double call_cycles = 60;        // Call, prologue and loop overhead
+static const double mac_cycles = 45;         // Weight from flash, 16x16 bit multiply, 32 bit add
+static const double division_cycles = 650;   // 32 bit division of the soft sigmoid
+static const double compare_cycles = 10;     // 32 bit comparison with the threshold
+static const double input_cycles = 12;       // Copying or denoising one tree input
+static const double tree_level_cycles = 30;  // Node from flash, comparison and step
+
+/**
+ * Tree structure - decision tree in the node format of RipenessModels::TreeNode.
+ * Split nodes have a feature, a threshold and the offset of the right child,
+ * leaves have feature -1 and the ripe share p.
+ */
+struct TreeNode
+{
+    int feature;
+    double threshold;
+    size_t right;
+    double p;
+};
+
+/**
+ * Model structure - a trained model of any family.
+ */
+struct Model
+{
+    Family family;
+    std::vector<double> mean, std, w; // Logistic regression and principal component
+    double b = 0;
+    std::vector<double> theta;      // Principal component
+    std::vector<TreeNode> nodes;    // Decision tree
+    std::vector<size_t> tree_inputs; // Columns minus the ambient column, appended as inputs
+};
+
+/**
+ * Returns the column with the given name, or -1.
+ */
+static long find_column(const Dataset &dataset, const char *name)
+{
+    for (size_t j = 0; j < dataset.dimensions(); j++)
+    {
+        if (dataset.feature_names[j] == name)
+        {
+            return j;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Calculates the inputs of the decision tree for a row: the features and, if
+ * there is an ambient column, the colour channels minus ambient, clipped at 0.
+ */
+static void get_tree_inputs(const Dataset &dataset, const Model &model, size_t row, std::vector<double> &inputs)
+{
+    inputs.resize(dataset.dimensions() + model.tree_inputs.size());
+    for (size_t j = 0; j < dataset.dimensions(); j++)
+    {
+        inputs[j] = dataset.column(j)[row];
+    }
+    long ambient = find_column(dataset, "ambient");
+    for (size_t k = 0; k < model.tree_inputs.size(); k++)
+    {
+        double denoised = dataset.column(model.tree_inputs[k])[row] - dataset.column(ambient)[row];
+        inputs[dataset.dimensions() + k] = denoised > 0 ? denoised : 0;
+    }
+}
+
+/**
+ * Fits a decision tree with CART (Gini impurity), as fit_tree in export.py.
+ * @param inputs Tree inputs per row
+ * @param ripe Label per row
+ * @param rows Rows of the subtree
+ * @param depth Depth of the subtree
+ * @param max_depth Maximum depth
+ * @param nodes Nodes in preorder
+ */
+static void grow_tree(const std::vector<std::vector<double>> &inputs, const std::vector<bool> &ripe,
+                      std::vector<size_t> rows, int depth, int max_depth, std::vector<TreeNode> &nodes)
+{
+    static const size_t min_leaf = 5;
+    auto gini = [](double ripe_count, double total)
+    { return total == 0 ? 0 : 2 * ripe_count * (1 - ripe_count / total); };
+
+    size_t index = nodes.size();
+    nodes.push_back(TreeNode{-1, 0, 0, 0});
+    size_t ripe_count = 0;
+    for (size_t row : rows)
+    {
+        ripe_count += ripe[row];
+    }
+
+    double best_impurity = gini(ripe_count, rows.size()) - 1e-9;
+    int best_feature = -1;
+    double best_threshold = 0;
+    if (depth < max_depth && ripe_count > 0 && ripe_count < rows.size())
+    {
+        for (size_t feature = 0; feature < inputs[rows[0]].size(); feature++)
+        {
+            std::sort(rows.begin(), rows.end(), [&](size_t a, size_t b)
+                      { return inputs[a][feature] < inputs[b][feature]; });
+            size_t left_ripe = 0;
+            for (size_t i = 0; i + 1 < rows.size(); i++)
+            {
+                left_ripe += ripe[rows[i]];
+                double a = inputs[rows[i]][feature], b = inputs[rows[i + 1]][feature];
+                size_t left = i + 1;
+                if (a == b || left < min_leaf || rows.size() - left < min_leaf)
+                {
+                    continue;
+                }
+                double impurity = gini(left_ripe, left) + gini(ripe_count - left_ripe, rows.size() - left);
+                if (impurity < best_impurity)
+                {
+                    best_impurity = impurity;
+                    best_feature = feature;
+                    best_threshold = (a + b) / 2;
+                }
+            }
+        }
+    }
+    if (best_feature < 0)
+    {
+        nodes[index].p = (double)ripe_count / rows.size();
+        return;
+    }
+
+    std::vector<size_t> left_rows, right_rows;
+    for (size_t row : rows)
+    {
+        (inputs[row][best_feature] <= best_threshold ? left_rows : right_rows).push_back(row);
+    }
+    grow_tree(inputs, ripe, left_rows, depth + 1, max_depth, nodes);
+    size_t right = nodes.size();
+    grow_tree(inputs, ripe, right_rows, depth + 1, max_depth, nodes);
+    nodes[index] = TreeNode{best_feature, best_threshold, right - index, 0};
+}
+
+/**
+ * Trains a model on the training rows.
+ * @param train Training set, labels 1 for ripe
+ * @param family Model family
+ * @param options Command line arguments
+ * @return Trained model
+ */
+static Model fit(const Dataset &train, Family family, const Options &options)
+{
+    Model model;
+    model.family = family;
+    TrainingOptions training;
+    training.newton = true;
+    training.loss_freq = 0;
+    training.patience = 3;
+    training.min_delta = 1e-10;
+    training.max_iters = 100;
+    training.seed = options.seed;
+
+    if (family == Family::LOGISTIC_REGRESSION)
+    {
+        Dataset normalized = train;
+        standardization(train, model.mean, model.std);
+        normalize(normalized, model.mean, model.std);
+        train_logistic_regression(normalized, training, model.w, model.b);
+    }
+    else if (family == Family::PRINCIPAL_COMPONENT)
+    {
+        // Eigenvector of X.T @ X with the largest eigenvalue, as PCA/main.py
+        size_t d = train.dimensions();
+        model.theta.assign(d, 1);
+        for (int iteration = 0; iteration < 200; iteration++)
+        {
+            std::vector<double> next(d, 0);
+            for (size_t j = 0; j < d; j++)
+            {
+                for (size_t k = 0; k < d; k++)
+                {
+                    double product = 0;
+                    for (size_t i = 0; i < train.count; i++)
+                    {
+                        product += train.column(j)[i] * train.column(k)[i];
+                    }
+                    next[j] += product * model.theta[k];
+                }
+            }
+            double norm = 0;
+            for (double x : next)
+            {
+                norm += x * x;
+            }
+            for (size_t j = 0; j < d; j++)
+            {
+                model.theta[j] = next[j] / sqrt(norm);
+            }
+        }
+
+        // Logistic calibration of the projection, its threshold on the device
+        Dataset projected;
+        projected.feature_names = {"projection"};
+        projected.label_names = train.label_names;
+        projected.count = train.count;
+        projected.labels = train.labels;
+        projected.features.assign(train.count, 0);
+        for (size_t j = 0; j < d; j++)
+        {
+            for (size_t i = 0; i < train.count; i++)
+            {
+                projected.features[i] += model.theta[j] * train.column(j)[i];
+            }
+        }
+        standardization(projected, model.mean, model.std);
+        normalize(projected, model.mean, model.std);
+        train_logistic_regression(projected, training, model.w, model.b);
+    }
+    else
+    {
+        long ambient = find_column(train, "ambient");
+        for (size_t j = 0; ambient >= 0 && j < train.dimensions(); j++)
+        {
+            if (j != (size_t)ambient && train.feature_names[j] != "width")
+            {
+                model.tree_inputs.push_back(j);
+            }
+        }
+        std::vector<std::vector<double>> inputs(train.count);
+        std::vector<bool> ripe(train.count);
+        std::vector<size_t> rows(train.count);
+        for (size_t i = 0; i < train.count; i++)
+        {
+            get_tree_inputs(train, model, i, inputs[i]);
+            ripe[i] = train.labels[i] == 1;
+            rows[i] = i;
+        }
+        grow_tree(inputs, ripe, rows, 0, options.max_depth, model.nodes);
+    }
+    return model;
+}
+
+/**
+ * Calculates the ripe probability of a row and the estimated Arduino cycles to do so.
+ * @param model Trained model
+ * @param dataset Dataset with the features of the model
+ * @param row Row
+ * @param cycles Estimated cycles of the fixed-point inference
+ * @return Probability that the berry is ripe
+ */
+static double predict(const Model &model, const Dataset &dataset, size_t row, double &cycles)
+{
+    size_t d = dataset.dimensions();
+    double z = model.b;
+    if (model.family == Family::LOGISTIC_REGRESSION)
+    {
+        for (size_t j = 0; j < d; j++)
+        {
+            z += model.w[j] * (dataset.column(j)[row] - model.mean[j]) / model.std[j];
+        }
+        cycles = call_cycles + d * mac_cycles + division_cycles;
+        return 1.0 / (1.0 + exp(-z));
+    }
+    if (model.family == Family::PRINCIPAL_COMPONENT)
+    {
+        double projection = 0;
+        for (size_t j = 0; j < d; j++)
+        {
+            projection += model.theta[j] * dataset.column(j)[row];
+        }
+        z += model.w[0] * (projection - model.mean[0]) / model.std[0];
+        cycles = call_cycles + d * mac_cycles + compare_cycles;
+        return 1.0 / (1.0 + exp(-z));
+    }
+
+    std::vector<double> inputs;
+    get_tree_inputs(dataset, model, row, inputs);
+    size_t node = 0;
+    int levels = 0;
+    while (model.nodes[node].feature >= 0)
+    {
+        const TreeNode &split = model.nodes[node];
+        node += inputs[split.feature] <= split.threshold ? 1 : split.right;
+        levels++;
+    }
+    cycles = call_cycles + inputs.size() * input_cycles + (levels + 1) * tree_level_cycles;
+    return model.nodes[node].p;
+}
+
+/**
+ * Splits the rows into stratified folds: both labels are shuffled and dealt round robin.
+ * @return Fold of every row
+ */
+static std::vector<int> stratified_folds(const Dataset &dataset, int folds, unsigned long seed)
+{
+    std::vector<int> fold(dataset.count);
+    std::mt19937_64 random(seed);
+    int next = 0;
+    for (double label = 0; label <= 1; label++)
+    {
+        std::vector<size_t> rows;
+        for (size_t i = 0; i < dataset.count; i++)
+        {
+            if (dataset.labels[i] == label)
+            {
+                rows.push_back(i);
+            }
+        }
+        std::shuffle(rows.begin(), rows.end(), random);
+        for (size_t row : rows)
+        {
+            fold[row] = next;
+            next = (next + 1) % folds;
+        }
+    }
+    return fold;
+}
+
+/**
+ * Calculates the area under the ROC curve, the probability that a ripe berry
+ * scores higher than an unripe one (ties count half).
+ */
+static double roc_auc(const std::vector<double> &scores, const std::vector<double> &ripe)
+{
+    std::vector<size_t> order(scores.size());
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b)
+              { return scores[a] < scores[b]; });
+    double rank_sum = 0;
+    double ripe_count = 0;
+    for (size_t i = 0; i < order.size();)
+    {
+        size_t end = i;
+        while (end < order.size() && scores[order[end]] == scores[order[i]])
+        {
+            end++;
+        }
+        double rank = (i + end + 1) / 2.0; // Mean 1-based rank of the ties
+        for (size_t k = i; k < end; k++)
+        {
+            if (ripe[order[k]] == 1)
+            {
+                rank_sum += rank;
+                ripe_count++;
+            }
+        }
+        i = end;
+    }
+    double unripe_count = scores.size() - ripe_count;
+    return (rank_sum - ripe_count * (ripe_count + 1) / 2) / (ripe_count * unripe_count);
+}
+
+/**
+ * Reads the command line arguments.
+ * @return Whether the arguments are valid
+ */
+static bool parse_options(int argc, char **argv, Options &options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        auto is = [arg](const char *short_name, const char *long_name)
+        { return strcmp(arg, short_name) == 0 || strcmp(arg, long_name) == 0; };
+
+        if (is("-s", "--sweep"))
+        {
+            options.sweep = true;
+        }
+        else if (arg[0] != '-')
+        {
+            options.datasets.push_back(arg);
+        }
+        else if (i + 1 >= argc)
+        {
+            return false;
+        }
+        else if (is("-k", "--folds"))
+        {
+            options.folds = atoi(argv[++i]);
+        }
+        else if (is("-t", "--target"))
+        {
+            options.target = atof(argv[++i]);
+        }
+        else if (is("-d", "--max_depth"))
+        {
+            options.max_depth = atoi(argv[++i]);
+        }
+        else if (is("-p", "--fp_penalty"))
+        {
+            options.fp_penalty = atof(argv[++i]);
+        }
+        else if (is("-n", "--fn_penalty"))
+        {
+            options.fn_penalty = atof(argv[++i]);
+        }
+        else if (is("-j", "--threads"))
+        {
+            options.threads = atoi(argv[++i]);
+        }
+        else if (is("-r", "--seed"))
+        {
+            options.seed = strtoul(argv[++i], nullptr, 10);
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return !options.datasets.empty() && options.folds >= 2;
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parse_options(argc, argv, options))
+    {
+        fprintf(stderr, "usage: %s dataset... [-k folds] [-t target] [-d max_depth] [-p fp_penalty] [-n fn_penalty]\n"
+                        "       [-j threads] [-r seed] [-s|--sweep]\n",
+                argv[0]);
+        return 2;
+    }
+
+    // Datasets with the labels recoded to 1 for ripe, and their folds
+    std::vector<Dataset> datasets;
+    std::vector<const char *> names;
+    std::vector<std::vector<int>> folds;
+    for (const char *path : options.datasets)
+    {
+        Dataset dataset;
+        if (!read_dataset(path, dataset))
+        {
+            fprintf(stderr, "%s: skipped\n", path);
+            continue;
+        }
+        double ripe_code = dataset.label_names[0] == "ripe" ? 0 : 1;
+        for (double &label : dataset.labels)
+        {
+            label = label == ripe_code;
+        }
+        folds.push_back(stratified_folds(dataset, options.folds, options.seed));
+        datasets.push_back(dataset);
+        names.push_back(path);
+    }
+
+    // Every family on the colour channels, with and without ambient and width
+    std::vector<Configuration> configurations;
+    for (size_t k = 0; k < datasets.size(); k++)
+    {
+        const Dataset &dataset = datasets[k];
+        std::vector<size_t> channels;
+        for (size_t j = 0; j < dataset.dimensions(); j++)
+        {
+            if (dataset.feature_names[j] != "ambient" && dataset.feature_names[j] != "width")
+            {
+                channels.push_back(j);
+            }
+        }
+        long extras[2] = {find_column(dataset, "ambient"), find_column(dataset, "width")};
+        for (int subset = 0; subset < 4; subset++)
+        {
+            std::vector<size_t> columns = channels;
+            std::string features = "rgb";
+            bool available = true;
+            for (int e = 0; e < 2; e++)
+            {
+                if (subset & (1 << e))
+                {
+                    available &= extras[e] >= 0;
+                    columns.push_back(extras[e]);
+                    features += e == 0 ? "+ambient" : "+width";
+                }
+            }
+            for (Family family : families)
+            {
+                if (available)
+                {
+                    configurations.push_back(Configuration{k, columns, features, family, {}, {}, {}});
+                }
+            }
+        }
+    }
+    for (Configuration &configuration : configurations)
+    {
+        configuration.scores.resize(datasets[configuration.dataset].count);
+        configuration.fold_accuracies.resize(options.folds);
+        configuration.fold_cycles.resize(options.folds);
+    }
+
+    // One job per configuration and fold, the folds write disjoint rows of the scores
+    std::atomic<size_t> next_job(0);
+    size_t job_count = configurations.size() * options.folds;
+    auto worker = [&]()
+    {
+        for (size_t job; (job = next_job++) < job_count;)
+        {
+            Configuration &configuration = configurations[job / options.folds];
+            int fold = job % options.folds;
+            const Dataset &dataset = datasets[configuration.dataset];
+            const std::vector<int> &row_folds = folds[configuration.dataset];
+            std::vector<size_t> train_rows, test_rows;
+            for (size_t i = 0; i < dataset.count; i++)
+            {
+                (row_folds[i] == fold ? test_rows : train_rows).push_back(i);
+            }
+            Dataset train = select(dataset, train_rows, configuration.columns);
+            Dataset test = select(dataset, test_rows, configuration.columns);
+
+            Model model = fit(train, configuration.family, options);
+            size_t correct = 0;
+            double cycles_sum = 0;
+            for (size_t i = 0; i < test.count; i++)
+            {
+                double cycles;
+                double p = predict(model, test, i, cycles);
+                configuration.scores[test_rows[i]] = p;
+                correct += (p > 0.5) == (test.labels[i] == 1);
+                cycles_sum += cycles;
+            }
+            configuration.fold_accuracies[fold] = (double)correct / test.count;
+            configuration.fold_cycles[fold] = cycles_sum / test.count;
+        }
+    };
+    unsigned thread_count = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < thread_count; t++)
+    {
+        threads.emplace_back(worker);
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Report, the thresholds are chosen on the pooled out-of-fold scores
+    printf("%d-fold stratified cross-validation of %zu configurations on %u threads in %.2f s\n",
+           options.folds, configurations.size(), thread_count, seconds);
+    printf("acc@0.5: mean and standard deviation over the folds; best: threshold on p(ripe) with the highest accuracy;\n"
+           "penalty: lowest mean penalty per berry (%g per unripe picked, %g per ripe dropped) and its threshold;\n"
+           "cycles: estimated AVR cycles per fixed-point inference\n",
+           options.fp_penalty, options.fn_penalty);
+    const Configuration *cheapest = nullptr;
+    double cheapest_accuracy = 0, cheapest_threshold = 0, cheapest_cycles = 0;
+    size_t last_dataset = (size_t)-1;
+    for (const Configuration &configuration : configurations)
+    {
+        const Dataset &dataset = datasets[configuration.dataset];
+        if (configuration.dataset != last_dataset)
+        {
+            printf("\n%s (%zu rows)\n", names[configuration.dataset], dataset.count);
+            printf("%-20s %-9s %15s %7s %16s %16s %7s\n", "features", "model", "acc@0.5", "auc", "best", "penalty", "cycles");
+            last_dataset = configuration.dataset;
+        }
+
+        double mean = 0, variance = 0, cycles = 0;
+        for (int fold = 0; fold < options.folds; fold++)
+        {
+            mean += configuration.fold_accuracies[fold] / options.folds;
+            cycles += configuration.fold_cycles[fold] / options.folds;
+        }
+        for (int fold = 0; fold < options.folds; fold++)
+        {
+            variance += pow(configuration.fold_accuracies[fold] - mean, 2) / options.folds;
+        }
+
+        double best_accuracy = 0, best_threshold = 0.5, best_penalty = INFINITY, penalty_threshold = 0.5;
+        for (int step = 1; step < 20; step++)
+        {
+            double threshold = step / 20.0;
+            size_t correct = 0, false_positives = 0, false_negatives = 0;
+            for (size_t i = 0; i < dataset.count; i++)
+            {
+                bool ripe = dataset.labels[i] == 1;
+                bool picked = configuration.scores[i] > threshold;
+                correct += picked == ripe;
+                false_positives += picked && !ripe;
+                false_negatives += !picked && ripe;
+            }
+            double accuracy = (double)correct / dataset.count;
+            double penalty = (options.fp_penalty * false_positives + options.fn_penalty * false_negatives) / dataset.count;
+            if (options.sweep)
+            {
+                printf("    %s %s p > %.2f: accuracy %6.2f%%, %3zu unripe picked, %3zu ripe dropped, penalty %.3f\n",
+                       configuration.features.c_str(), family_names[(int)configuration.family], threshold,
+                       100 * accuracy, false_positives, false_negatives, penalty);
+            }
+            if (accuracy > best_accuracy)
+            {
+                best_accuracy = accuracy;
+                best_threshold = threshold;
+            }
+            if (penalty < best_penalty)
+            {
+                best_penalty = penalty;
+                penalty_threshold = threshold;
+            }
+        }
+
+        printf("%-20s %-9s %7.2f%% ±%5.2f %7.4f %7.2f%% > %.2f %7.3f > %.2f %7.0f\n", configuration.features.c_str(),
+               family_names[(int)configuration.family], 100 * mean, 100 * sqrt(variance),
+               roc_auc(configuration.scores, dataset.labels), 100 * best_accuracy, best_threshold,
+               best_penalty, penalty_threshold, cycles);
+        if (best_accuracy >= options.target && (cheapest == nullptr || cycles < cheapest_cycles))
+        {
+            cheapest = &configuration;
+            cheapest_accuracy = best_accuracy;
+            cheapest_threshold = best_threshold;
+            cheapest_cycles = cycles;
+        }
+    }
+
+    if (cheapest == nullptr)
+    {
+        printf("\nno configuration reaches %.2f%% accuracy\n", 100 * options.target);
+        return 1;
+    }
+    printf("\ncheapest configuration reaching %.2f%%: %s %s on %s, %.2f%% at p(ripe) > %.2f, ~%.0f cycles\n",
+           100 * options.target, family_names[(int)cheapest->family], cheapest->features.c_str(),
+           names[cheapest->dataset], 100 * cheapest_accuracy, cheapest_threshold, cheapest_cycles);
+    return 0;
+}
@@ -0,0 +1,5 @@
+dir=$(dirname "$0")
+if [ $# -eq 0 ]; then
+    set -- "$dir/data.csv" "$dir/data_labeled.csv" "$dir/data_labeled_ambient.csv" "$dir/data_labeled_ambient_width.csv"
+fi
+g++ -O3 -march=native -ffast-math -std=c++17 -pthread "$dir/evaluate.cpp" -o "$dir/evaluate" && "$dir/evaluate" "$@"
@@ -0,0 +1,477 @@
+"""Exports the ripeness models to the firmware.
+
+Reads the logistic regression trained by logistic_regression/main.py or train.cpp (model.json),
+fits the PCA projection and the decision trees on the rows it was trained on, and writes
+arduino/lib/RaspberryPicker/src/Gripper/RipenessModelData.h with
+
+- the logistic regression with its feature normalization, in float and in fixed point
+  (see logistic_regression/quantize.py), and the fixed-point partial models of the sequential decision
+- the first principal component of the features with the threshold separating ripe berries
+- the decision tree and a small random forest as flat node arrays over the integer inputs
+- self-check vectors: inputs and the expected output of every model
+
+The firmware selects one of the models with the template parameter of
+ColorSensor::get_ripeness_p_q; arduino/benchmark/ripeness.sh runs the self-check.
+
+Only uses the standard library. Run from data/classifier after training, e.g.
+via train_data_labeled_ambient_width.sh:
+
+    python export.py data_labeled_ambient_width.csv
+"""
+
+import argparse
+import csv
+import json
+import os
+import random
+import sys
+from typing import Dict, List, Sequence, Tuple
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "logistic_regression"))
+import quantize  # noqa: E402
+
+FEATURES = ["red", "green", "blue", "ambient", "width"]
+SEQUENTIAL_ORDER = [1, 0, 3, 2]  # Channels in the order the sequential decision measures them
+VAR_SHIFT = 16                   # Fraction bits of the variances of the sequential decision
+NOISE_SHIFT = 20                 # Fraction bits of the squared channel weights of the sequential decision
+PCA_SHIFT = 14                   # Fraction bits of the PCA projection vector
+TREE_FEATURES = ["red", "green", "blue", "ambient", "width", "red - ambient", "green - ambient", "blue - ambient"]
+TREE_LEAF = 0xFF                 # Feature index marking a leaf of the decision trees
+CHECK_COUNT = 8                  # Number of self-check vectors
+
+HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                      "..", "..", "arduino", "lib", "RaspberryPicker", "src", "Gripper", "RipenessModelData.h")
+
+
+def read_rows(path: str) -> List[Dict]:
+    """Reads the dataset with the features as floats and the inputs of the firmware.
+
+    Returns:
+        List of rows with the keys features (averages and width), sums (ADC sums
+        of SAMPLE_COUNT samples), width and ripe
+    """
+    rows = []
+    with open(path) as f:
+        reader = csv.DictReader(f)
+        missing = [k for k in FEATURES + ["label"] if k not in reader.fieldnames]
+        if missing:
+            raise SystemExit(f"dataset lacks the columns {missing}, the firmware models need {FEATURES}")
+        for row in reader:
+            features = [float(row[k]) for k in FEATURES]
+            sums = [round(x * quantize.SAMPLE_COUNT) for x in features[:4]]
+            rows.append({"features": features, "sums": sums, "width": int(row["width"]), "ripe": row["label"] == "ripe"})
+    return rows
+
+
+def split(rows: List[Dict], model: Dict) -> Tuple[List[Dict], List[Dict]]:
+    """Splits the rows into the training and the test set of the logistic regression.
+
+    The other models are fitted on the same training set, so all of them are
+    compared on rows none of them was trained on.
+    """
+    if "test_rows" not in model:
+        raise SystemExit("the model has no test_rows, retrain it with logistic_regression/train.sh or main.py")
+    test_rows = set(model["test_rows"])
+    if max(test_rows) >= len(rows):
+        raise SystemExit("the test_rows of the model do not match the dataset")
+    return ([row for i, row in enumerate(rows) if i not in test_rows],
+            [row for i, row in enumerate(rows) if i in test_rows])
+
+
+def solve(a: List[List[float]], b: List[List[float]]) -> List[List[float]]:
+    """Solves a @ x = b with Gauss-Jordan elimination (the matrices are at most 5x5)."""
+    n = len(a)
+    m = [a[i][:] + b[i][:] for i in range(n)]
+    for c in range(n):
+        p = max(range(c, n), key=lambda r: abs(m[r][c]))
+        m[c], m[p] = m[p], m[c]
+        for r in range(n):
+            if r != c:
+                f = m[r][c] / m[c][c]
+                m[r] = [m[r][k] - f * m[c][k] for k in range(len(m[r]))]
+    return [[m[i][k] / m[i][i] for k in range(n, len(m[i]))] for i in range(n)]
+
+
+def sequential_models(model: Dict, rows: List[Dict]) -> Tuple[List[List[float]], List[float], List[float]]:
+    """Derives the partial models of the sequential decision from the logistic regression.
+
+    After each channel of SEQUENTIAL_ORDER (and the width, which is always known),
+    the normalized features that are not measured yet are replaced by their
+    expectation given the measured ones, using the feature covariance of the dataset.
+
+    Returns:
+        w: Weights per step of shape (4, 5), 0 for the features not measured yet
+        b: Bias per step of shape (4, )
+        var: Variance of z caused by the features not measured yet per step of shape (4, )
+    """
+    w, b, mean, std = model["w"], model["b"], model["mean"], model["std"]
+    x = [[(row["features"][i] - mean[i]) / std[i] for i in range(5)] for row in rows]
+    mu = [sum(v[i] for v in x) / len(x) for i in range(5)]
+    cov = [[sum((v[i] - mu[i]) * (v[j] - mu[j]) for v in x) / len(x) for j in range(5)] for i in range(5)]
+
+    steps_w, steps_b, steps_var = [], [], []
+    for step in range(4):
+        measured = sorted(SEQUENTIAL_ORDER[:step + 1] + [4])
+        unknown = [i for i in range(5) if i not in measured]
+        step_w = [w[i] if i in measured else 0.0 for i in range(5)]
+        step_b = b
+        var = 0.0
+        if unknown:
+            k = solve([[cov[i][j] for j in measured] for i in measured],
+                      [[cov[i][u] for u in unknown] for i in measured])
+            for a, i in enumerate(measured):
+                step_w[i] += sum(k[a][c] * w[u] for c, u in enumerate(unknown))
+            for c, u in enumerate(unknown):
+                step_b += w[u] * (mu[u] - sum(k[a][c] * mu[i] for a, i in enumerate(measured)))
+            residual = [[cov[u][v] - sum(k[a][cu] * cov[i][v] for a, i in enumerate(measured)) for v in unknown]
+                        for cu, u in enumerate(unknown)]
+            var = sum(w[u] * residual[cu][cv] * w[v] for cu, u in enumerate(unknown) for cv, v in enumerate(unknown))
+        steps_w.append(step_w)
+        steps_b.append(step_b)
+        steps_var.append(var)
+    return steps_w, steps_b, steps_var
+
+
+def quantize_sequential(model: Dict, sequential) -> Tuple[List[List[int]], List[int], List[int], List[List[int]]]:
+    """Converts the partial models of the sequential decision to fixed point.
+
+    The normalization is folded into the weights like for the full model, with
+    int32 weights since the partial models weigh the width much more.
+
+    Returns:
+        q_w: Weights per input and step [2^-Z_SHIFT], int32
+        q_b: Bias per step [2^-Z_SHIFT], int32
+        q_var: Variance of z caused by the features not measured yet per step [2^-VAR_SHIFT], uint32
+        noise_w: Squared weight of a channel per ADC count and step [2^-NOISE_SHIFT], uint16
+    """
+    seq_w, seq_b, seq_var = sequential
+    q_w, q_b, noise_w = [], [], []
+    for step_w, step_b in zip(seq_w, seq_b):
+        step_q_w, step_q_b = quantize.quantize(step_w, step_b, model["mean"], model["std"], weight_bits=32)
+        q_w.append(step_q_w)
+        q_b.append(step_q_b)
+        noise_w.append([round((step_w[c] / model["std"][c]) ** 2 * (1 << NOISE_SHIFT)) for c in range(4)])
+    if max(max(w) for w in noise_w) > 0xFFFF:
+        raise SystemExit("the squared channel weights do not fit uint16, reduce NOISE_SHIFT")
+    q_var = [round(var * (1 << VAR_SHIFT)) for var in seq_var]
+    return q_w, q_b, q_var, noise_w
+
+
+def pca_inputs(row: Dict) -> List[int]:
+    """Inputs of the fixed-point PCA projection: the channel sums and the width times SAMPLE_COUNT."""
+    return row["sums"] + [row["width"] * quantize.SAMPLE_COUNT]
+
+
+def fit_pca(rows: List[Dict]) -> Tuple[List[int], int, bool]:
+    """Fits the first principal component of the features, as PCA/main.py, and a threshold on it.
+
+    The component is the eigenvector of X.T @ X with the largest eigenvalue, found by
+    power iteration. The threshold on the projection is the one with the best accuracy.
+
+    Returns:
+        theta: Projection vector [2^-PCA_SHIFT] on the inputs of pca_inputs()
+        threshold: Projection separating the classes
+        ripe_above: Whether projections above the threshold are ripe
+    """
+    c = [[sum(row["features"][i] * row["features"][j] for row in rows) for j in range(5)] for i in range(5)]
+    v = [1.0] * 5
+    for _ in range(200):
+        v = [sum(c[i][j] * v[j] for j in range(5)) for i in range(5)]
+        norm = sum(x * x for x in v) ** 0.5
+        v = [x / norm for x in v]
+    theta = [round(x * (1 << PCA_SHIFT)) for x in v]
+
+    projected = sorted((pca_project(theta, pca_inputs(row)), row["ripe"]) for row in rows)
+    ripe_total = sum(1 for _, ripe in projected if ripe)
+    best = (-1, 0, False)
+    ripe_below = 0
+    for i, (a, ripe) in enumerate(projected):
+        ripe_below += ripe
+        if i + 1 < len(projected) and projected[i + 1][0] == a:
+            continue
+        below = i + 1
+        # Correct if ripe above the threshold, or if ripe below it
+        correct_above = (below - ripe_below) + (ripe_total - ripe_below)
+        correct_below = ripe_below + (len(projected) - below - (ripe_total - ripe_below))
+        for correct, ripe_above in ((correct_above, True), (correct_below, False)):
+            if correct > best[0]:
+                best = (correct, a, ripe_above)
+    return theta, best[1], best[2]
+
+
+def pca_project(theta: Sequence[int], inputs: Sequence[int]) -> int:
+    """Projection as computed by RipenessModels::PrincipalComponent."""
+    return sum(theta[i] * inputs[i] for i in range(5))
+
+
+def pca_p(theta: Sequence[int], threshold: int, ripe_above: bool, row: Dict) -> int:
+    """Ripeness probability [2^-P_SHIFT] of the PCA model, 0 or 1."""
+    above = pca_project(theta, pca_inputs(row)) > threshold
+    return (1 << quantize.P_SHIFT) if above == ripe_above else 0
+
+
+def tree_inputs(row: Dict) -> List[int]:
+    """Inputs of the decision tree, see TREE_FEATURES."""
+    s = row["sums"]
+    return s + [row["width"]] + [max(s[i] - s[3], 0) for i in range(3)]
+
+
+def gini(ripe: int, total: int) -> float:
+    """Gini impurity times the number of samples."""
+    if total == 0:
+        return 0.0
+    p = ripe / total
+    return total * 2 * p * (1 - p)
+
+
+def fit_tree(rows: List[Dict], max_depth: int = 3, min_leaf: int = 5,
+             max_features: int = 0, rng: random.Random = None) -> List[Dict]:
+    """Fits a decision tree with the CART algorithm (Gini impurity).
+
+    Thresholds are integers on the inputs of tree_inputs(); a sample goes left if
+    its input is <= threshold.
+
+    Args:
+        max_features: Number of random features considered per split, 0 for all (forest trees)
+        rng: Random generator choosing the features
+
+    Returns:
+        Nodes in preorder, so the left child of a node directly follows it. Split nodes
+        have feature, threshold and right (offset of the right child from the node),
+        leaves have p.
+    """
+    samples = [(tree_inputs(row), row["ripe"]) for row in rows]
+    nodes = []
+
+    def grow(subset, depth):
+        ripe = sum(1 for _, r in subset if r)
+        index = len(nodes)
+        nodes.append(None)
+        best = None
+        features = range(len(TREE_FEATURES))
+        if max_features:
+            features = sorted(rng.sample(features, max_features))
+        if depth < max_depth and 0 < ripe < len(subset):
+            for feature in features:
+                ordered = sorted(subset, key=lambda s: s[0][feature])
+                left_ripe = 0
+                for i in range(len(ordered) - 1):
+                    left_ripe += ordered[i][1]
+                    a, b = ordered[i][0][feature], ordered[i + 1][0][feature]
+                    left = i + 1
+                    if a == b or left < min_leaf or len(ordered) - left < min_leaf:
+                        continue
+                    impurity = gini(left_ripe, left) + gini(ripe - left_ripe, len(ordered) - left)
+                    if best is None or impurity < best[0] - 1e-9:
+                        best = (impurity, feature, (a + b) // 2)
+        if best is None or best[0] >= gini(ripe, len(subset)) - 1e-9:
+            nodes[index] = {"p": round(ripe / len(subset) * (1 << quantize.P_SHIFT))}
+            return
+        _, feature, threshold = best
+        grow([s for s in subset if s[0][feature] <= threshold], depth + 1)
+        right = len(nodes)
+        grow([s for s in subset if s[0][feature] > threshold], depth + 1)
+        nodes[index] = {"feature": feature, "threshold": threshold, "right": right - index}
+
+    grow(samples, 0)
+    return nodes
+
+
+def fit_forest(rows: List[Dict], tree_count: int, max_depth: int, seed: int = 0) -> List[List[Dict]]:
+    """Fits a random forest: each tree on a bootstrap sample, with random features per split.
+
+    Returns:
+        Trees as returned by fit_tree()
+    """
+    rng = random.Random(seed)
+    max_features = max(1, round(len(TREE_FEATURES) ** 0.5))
+    trees = []
+    for _ in range(tree_count):
+        bootstrap = [rows[rng.randrange(len(rows))] for _ in rows]
+        trees.append(fit_tree(bootstrap, max_depth=max_depth, max_features=max_features, rng=rng))
+    return trees
+
+
+def tree_p(nodes: List[Dict], row: Dict, root: int = 0) -> int:
+    """Ripeness probability [2^-P_SHIFT] as computed by RipenessModels::DecisionTree."""
+    inputs = tree_inputs(row)
+    i = root
+    while "p" not in nodes[i]:
+        i += 1 if inputs[nodes[i]["feature"]] <= nodes[i]["threshold"] else nodes[i]["right"]
+    return nodes[i]["p"]
+
+
+def forest_p(trees: List[List[Dict]], row: Dict) -> int:
+    """Ripeness probability [2^-P_SHIFT] as computed by RipenessModels::DecisionForest, the mean of the trees."""
+    return sum(tree_p(nodes, row) for nodes in trees) // len(trees)
+
+
+def accuracy(rows: List[Dict], p) -> float:
+    """Share of rows classified correctly by a function returning the probability [2^-P_SHIFT]."""
+    half = 1 << (quantize.P_SHIFT - 1)
+    return sum(1 for row in rows if (p(row) > half) == row["ripe"]) / len(rows)
+
+
+def c_array(values: Sequence, fmt: str = "{}") -> str:
+    """Formats values as a C++ initializer list."""
+    return "{" + ", ".join(fmt.format(v) for v in values) + "}"
+
+
+def c_nodes(nodes: List[Dict]) -> List[str]:
+    """Formats tree nodes as RipenessModels::TreeNode initializers, a leaf stores its probability as threshold."""
+    return [f"    {{{n.get('feature', TREE_LEAF)}, {n.get('right', 0)}, {n['threshold'] if 'threshold' in n else n['p']}}},"
+            for n in nodes]
+
+
+def write_header(path: str, dataset: str, model: Dict, sequential, q_w, q_b, pca, nodes, forest, checks):
+    """Writes the generated C++ header."""
+    seq_q_w, seq_q_b, seq_q_var, seq_noise_w = sequential
+    theta, threshold, ripe_above = pca
+    lines = [
+        "/**",
+        " * RipenessModelData.h",
+        " *",
+        f" * Generated by data/classifier/export.py from {os.path.basename(dataset)} - do not edit.",
+        " * Retrain and regenerate with data/classifier/train_data_labeled_ambient_width.sh.",
+        " * Coefficients of the ripeness models evaluated by ColorSensor and RipenessModels.h,",
+        " * with the expected outputs of every model for a few inputs to check the firmware against.",
+        " */",
+        "",
+        "#ifndef RASPBERRY_PICKER_GRIPPER_RIPENESS_MODEL_DATA_H",
+        "#define RASPBERRY_PICKER_GRIPPER_RIPENESS_MODEL_DATA_H",
+        "",
+        "#include <Arduino.h>",
+        "",
+        "#include \"RipenessModels.h\"",
+        "",
+        "namespace ripeness_model_data",
+        "{",
+        f"constexpr uint8_t sample_count = {quantize.SAMPLE_COUNT}; // Samples per channel sum the fixed-point models are made for",
+        f"constexpr uint8_t p_shift = {quantize.P_SHIFT};      // Fraction bits of the probabilities",
+        "",
+        "// Logistic regression on the normalized features (red, green, blue, ambient, width)",
+        f"constexpr float logistic_regression_w[5] PROGMEM = {c_array(model['w'], '{:.8f}')};",
+        f"constexpr float logistic_regression_b PROGMEM = {float(model['b']):.16f};",
+        f"constexpr float logistic_regression_mean[5] PROGMEM = {c_array(model['mean'], '{:.8f}')};",
+        f"constexpr float logistic_regression_std[5] PROGMEM = {c_array(model['std'], '{:.8f}')};",
+        "",
+        "// Fixed-point version: z = b + sum(w[i] * x[i]), where x are the channel sums and the width",
+        "// times sample_count, with the normalization folded into w and b",
+        f"constexpr uint8_t logistic_regression_q_shift = {quantize.Z_SHIFT}; // Fraction bits of w, b and z",
+        f"constexpr uint8_t logistic_regression_sigmoid_shift = {quantize.SIGMOID_SHIFT}; // Fraction bits of z in the sigmoid",
+        f"constexpr int16_t logistic_regression_q_w[5] PROGMEM = {c_array(q_w)};",
+        f"constexpr int32_t logistic_regression_q_b PROGMEM = {q_b};",
+        "",
+        "// Partial models of the sequential decision, one per number of measured channels (in sequential_order),",
+        "// in the fixed-point format above with int32 weights. The normalized features not measured yet are",
+        "// conditioned on the measured ones using the feature covariance of the dataset; var is the variance of z",
+        "// caused by them, noise_w the squared weight of a channel per ADC count, which turns the variance of the",
+        "// channel mean into variance of z",
+        f"constexpr uint8_t sequential_var_shift = {VAR_SHIFT};   // Fraction bits of var and the variances of z",
+        f"constexpr uint8_t sequential_noise_shift = {NOISE_SHIFT}; // Fraction bits of noise_w",
+        f"constexpr uint8_t sequential_order[4] PROGMEM = {c_array(SEQUENTIAL_ORDER)};",
+        "constexpr int32_t sequential_q_w[4][5] PROGMEM = {",
+    ]
+    lines += [f"    {c_array(w)}," for w in seq_q_w]
+    lines += [
+        "};",
+        f"constexpr int32_t sequential_q_b[4] PROGMEM = {c_array(seq_q_b)};",
+        f"constexpr uint32_t sequential_q_var[4] PROGMEM = {c_array(seq_q_var)};",
+        "constexpr uint16_t sequential_noise_w[4][4] PROGMEM = {",
+    ]
+    lines += [f"    {c_array(w)}," for w in seq_noise_w]
+    lines += [
+        "};",
+        "",
+        "// First principal component of the features: the berry is ripe if theta . x is "
+        + ("above" if ripe_above else "at or below") + " the threshold,",
+        "// with x the channel sums and the width times sample_count",
+        f"constexpr uint8_t pca_shift = {PCA_SHIFT}; // Fraction bits of theta",
+        f"constexpr int16_t pca_theta[5] PROGMEM = {c_array(theta)};",
+        f"constexpr int32_t pca_threshold = {threshold};",
+        f"constexpr bool pca_ripe_above = {'true' if ripe_above else 'false'};",
+        "",
+        "// Decision trees in preorder: a node continues with the next node if input <= threshold,",
+        "// otherwise with the node right entries further. Inputs: "
+        + ", ".join(f"{i}={name}" for i, name in enumerate(TREE_FEATURES)),
+        "// (channel sums, width [mm])",
+        f"constexpr uint8_t decision_tree_leaf = 0x{TREE_LEAF:02X}; // Feature of a leaf, whose threshold is its probability",
+        f"constexpr RipenessModels::TreeNode decision_tree_nodes[{len(nodes)}] PROGMEM = {{",
+    ]
+    lines += c_nodes(nodes)
+    roots = [sum(len(tree) for tree in forest[:i]) for i in range(len(forest))]
+    lines += [
+        "};",
+        "",
+        "// Random forest: the trees are stored one after the other, the probability is their mean",
+        f"constexpr uint8_t decision_forest_tree_count = {len(forest)};",
+        f"constexpr uint8_t decision_forest_roots[{len(forest)}] PROGMEM = {c_array(roots)};",
+        f"constexpr RipenessModels::TreeNode decision_forest_nodes[{sum(len(tree) for tree in forest)}] PROGMEM = {{",
+    ]
+    lines += c_nodes([node for tree in forest for node in tree])
+    lines += [
+        "};",
+        "",
+        "// Self-check: channel sums and width of rows of the dataset and the expected probabilities [2^-p_shift]",
+        f"constexpr uint8_t check_count = {len(checks)};",
+        f"constexpr int16_t check_inputs[{len(checks)}][5] = {{",
+    ]
+    lines += [f"    {c_array(c['row']['sums'] + [c['row']['width']])}," for c in checks]
+    lines += [
+        "};",
+        f"constexpr uint16_t logistic_regression_check_p[{len(checks)}] = {c_array([c['logistic_regression'] for c in checks])};",
+        f"constexpr uint16_t pca_check_p[{len(checks)}] = {c_array([c['pca'] for c in checks])};",
+        f"constexpr uint16_t decision_tree_check_p[{len(checks)}] = {c_array([c['decision_tree'] for c in checks])};",
+        f"constexpr uint16_t decision_forest_check_p[{len(checks)}] = {c_array([c['decision_forest'] for c in checks])};",
+        "} // namespace ripeness_model_data",
+        "",
+        "#endif",
+    ]
+    with open(path, "w") as f:
+        f.write("\n".join(lines) + "\n")
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(prog="export", description="Exports the ripeness models to the firmware")
+    parser.add_argument("dataset")
+    parser.add_argument("-m", "--model", default=quantize.MODEL_PATH,
+                        help="logistic regression written by logistic_regression/main.py")
+    parser.add_argument("-o", "--output", default=HEADER, help="generated header")
+    parser.add_argument("--max_depth", default=4, type=int, help="depth of the decision tree")
+    parser.add_argument("--forest_size", default=8, type=int, help="number of trees of the random forest")
+    parser.add_argument("--forest_depth", default=4, type=int, help="depth of the trees of the random forest")
+    args = parser.parse_args()
+
+    with open(args.model) as f:
+        model = json.load(f)
+    if len(model["w"]) != len(FEATURES):
+        raise SystemExit(f"{args.model} has {len(model['w'])} features, the firmware model needs {FEATURES}")
+    rows = read_rows(args.dataset)
+    train, test = split(rows, model)
+
+    q_w, q_b = quantize.quantize(model["w"], model["b"], model["mean"], model["std"])
+    sequential = quantize_sequential(model, sequential_models(model, rows))
+    pca = fit_pca(train)
+    nodes = fit_tree(train, max_depth=args.max_depth)
+    forest = fit_forest(train, args.forest_size, args.forest_depth)
+    if sum(len(tree) for tree in forest[:-1]) > 0xFF or max(len(nodes), *(len(tree) for tree in forest)) > 0xFF:
+        raise SystemExit("the trees are too large for the uint8 node offsets, reduce the depth or the forest size")
+
+    models = {
+        "logistic_regression": lambda row: quantize.infer_p(quantize.infer_z(q_w, q_b, row["sums"], row["width"])),
+        "pca": lambda row: pca_p(*pca, row),
+        "decision_tree": lambda row: tree_p(nodes, row),
+        "decision_forest": lambda row: forest_p(forest, row),
+    }
+    checks = []
+    for k in range(CHECK_COUNT):
+        row = rows[round(k * (len(rows) - 1) / (CHECK_COUNT - 1))]
+        check = {name: p(row) for name, p in models.items()}
+        check["row"] = row
+        checks.append(check)
+
+    write_header(args.output, args.dataset, model, sequential, q_w, q_b, pca, nodes, forest, checks)
+    print(f"wrote {os.path.relpath(args.output)}")
+    for name, p in models.items():
+        print(f"{name:20s} accuracy {100 * accuracy(rows, p):.2f}% on all rows, "
+              f"{100 * accuracy(test, p):.2f}% on the {len(test)} test rows of the logistic regression")
@@ -0,0 +1,521 @@
+/**
+ * logistic_regression.h
+ *
+ * Logistic regression of implementation.py in C++, for the native trainer
+ * (train.cpp) and the model selection harness (../evaluate.cpp).
+ *
+ * The dataset is stored column-major, so every pass over a feature runs over
+ * contiguous doubles and vectorizes. One fused pass per iteration computes the
+ * loss and the gradient at the same weights, as bce_loss and bce_gradient do.
+ * With TrainingOptions::newton, damped Newton steps on the same loss replace the
+ * gradient steps and reach the optimum the gradient descent approaches in a few
+ * dozen iterations.
+ */
+
+#ifndef RASPBERRY_PICKER_CLASSIFIER_LOGISTIC_REGRESSION_H
+#define RASPBERRY_PICKER_CLASSIFIER_LOGISTIC_REGRESSION_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * Dataset structure - features and labels of a labeled csv file.
+ * features: Column-major, feature j of row i at features[j * count + i]
+ * labels: Label codes, the index of the label in label_names
+ * label_names: Sorted label names, as the category codes of pandas
+ */
+struct Dataset
+{
+    std::vector<std::string> feature_names;
+    std::vector<std::string> label_names;
+    size_t count = 0;
+    std::vector<double> features;
+    std::vector<double> labels;
+
+    size_t dimensions() const { return this->feature_names.size(); }
+    const double *column(size_t j) const { return &this->features[j * this->count]; }
+    double *column(size_t j) { return &this->features[j * this->count]; }
+};
+
+/**
+ * TrainingOptions structure - parameters of train_logistic_regression, with the defaults of main.py.
+ * max_iters: Maximum number of iterations, 0 for no limit
+ * loss_freq: Prints the loss every loss_freq iterations, 0 for never
+ * seed: Seed of the initial weights
+ * newton: Whether to take Newton steps instead of gradient steps
+ */
+struct TrainingOptions
+{
+    long max_iters = 0;
+    double alpha = 0.5;
+    long loss_freq = 50000;
+    double patience = std::numeric_limits<double>::infinity();
+    double min_delta = 0.00001;
+    unsigned long seed = 0;
+    bool newton = false;
+};
+
+const double epsilon = 1e-9; // Keeps the logarithms of the loss finite, as in bce_loss
+
+/**
+ * Reads a labeled csv file: numeric feature columns and a label column.
+ * @param path Path of the file
+ * @param dataset Read dataset
+ * @return Whether the file could be read
+ */
+inline bool read_dataset(const char *path, Dataset &dataset)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        perror(path);
+        return false;
+    }
+    std::string line;
+    std::getline(file, line);
+    std::vector<std::string> header;
+    std::stringstream header_stream(line);
+    std::string cell;
+    while (std::getline(header_stream, cell, ','))
+    {
+        header.push_back(cell);
+    }
+    auto label_column = std::find(header.begin(), header.end(), "label") - header.begin();
+    if (label_column == (long)header.size())
+    {
+        fprintf(stderr, "%s: no label column\n", path);
+        return false;
+    }
+
+    std::vector<std::vector<double>> rows;
+    std::vector<std::string> labels;
+    while (std::getline(file, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        if (line.empty())
+        {
+            continue;
+        }
+        std::vector<double> row;
+        std::stringstream line_stream(line);
+        for (long column = 0; std::getline(line_stream, cell, ','); column++)
+        {
+            if (column == label_column)
+            {
+                labels.push_back(cell);
+            }
+            else
+            {
+                row.push_back(strtod(cell.c_str(), nullptr));
+            }
+        }
+        if (row.size() != header.size() - 1 || labels.size() != rows.size() + 1)
+        {
+            fprintf(stderr, "%s: malformed row %zu\n", path, rows.size() + 2);
+            return false;
+        }
+        rows.push_back(row);
+    }
+
+    for (long column = 0; column < (long)header.size(); column++)
+    {
+        if (column != label_column)
+        {
+            dataset.feature_names.push_back(header[column]);
+        }
+    }
+    dataset.label_names = labels;
+    std::sort(dataset.label_names.begin(), dataset.label_names.end());
+    dataset.label_names.erase(std::unique(dataset.label_names.begin(), dataset.label_names.end()), dataset.label_names.end());
+    if (dataset.label_names.size() != 2)
+    {
+        fprintf(stderr, "%s: %zu labels, logistic regression needs 2\n", path, dataset.label_names.size());
+        return false;
+    }
+
+    dataset.count = rows.size();
+    dataset.features.resize(dataset.dimensions() * dataset.count);
+    dataset.labels.resize(dataset.count);
+    for (size_t i = 0; i < dataset.count; i++)
+    {
+        for (size_t j = 0; j < dataset.dimensions(); j++)
+        {
+            dataset.column(j)[i] = rows[i][j];
+        }
+        dataset.labels[i] = labels[i] == dataset.label_names[1];
+    }
+    return true;
+}
+
+/**
+ * Copies rows and columns of a dataset.
+ * @param dataset Dataset
+ * @param rows Indices of the copied rows
+ * @param columns Indices of the copied features
+ * @return Dataset of the copied rows and features
+ */
+inline Dataset select(const Dataset &dataset, const std::vector<size_t> &rows, const std::vector<size_t> &columns)
+{
+    Dataset part;
+    part.label_names = dataset.label_names;
+    for (size_t j : columns)
+    {
+        part.feature_names.push_back(dataset.feature_names[j]);
+    }
+    part.count = rows.size();
+    part.features.resize(part.dimensions() * part.count);
+    part.labels.resize(part.count);
+    for (size_t i = 0; i < part.count; i++)
+    {
+        for (size_t j = 0; j < columns.size(); j++)
+        {
+            part.column(j)[i] = dataset.column(columns[j])[rows[i]];
+        }
+        part.labels[i] = dataset.labels[rows[i]];
+    }
+    return part;
+}
+
+/**
+ * Shuffles the rows and splits them into a training and a test set, as preprocess_data.
+ * @param dataset All rows
+ * @param train_size Share of the rows used for training
+ * @param seed Seed of the shuffle
+ * @param train Training set
+ * @param test Test set
+ * @param test_rows Optional pointer to store the indices of the test rows in the dataset, ascending
+ */
+inline void split(const Dataset &dataset, double train_size, unsigned long seed, Dataset &train, Dataset &test,
+                  std::vector<size_t> *test_rows = nullptr)
+{
+    std::vector<size_t> order(dataset.count);
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        order[i] = i;
+    }
+    std::mt19937_64 random(seed);
+    std::shuffle(order.begin(), order.end(), random);
+
+    size_t train_count = (size_t)(dataset.count * train_size);
+    std::vector<size_t> columns(dataset.dimensions());
+    for (size_t j = 0; j < columns.size(); j++)
+    {
+        columns[j] = j;
+    }
+    train = select(dataset, std::vector<size_t>(order.begin(), order.begin() + train_count), columns);
+    test = select(dataset, std::vector<size_t>(order.begin() + train_count, order.end()), columns);
+    if (test_rows != nullptr)
+    {
+        test_rows->assign(order.begin() + train_count, order.end());
+        std::sort(test_rows->begin(), test_rows->end());
+    }
+}
+
+/**
+ * Calculates the population mean and standard deviation of the features, as numpy.
+ * @param dataset Dataset
+ * @param mean Feature means
+ * @param std Feature standard deviations
+ */
+inline void standardization(const Dataset &dataset, std::vector<double> &mean, std::vector<double> &std)
+{
+    mean.assign(dataset.dimensions(), 0);
+    std.assign(dataset.dimensions(), 0);
+    for (size_t j = 0; j < dataset.dimensions(); j++)
+    {
+        const double *x = dataset.column(j);
+        double sum = 0;
+        for (size_t i = 0; i < dataset.count; i++)
+        {
+            sum += x[i];
+        }
+        mean[j] = sum / dataset.count;
+        double squares = 0;
+        for (size_t i = 0; i < dataset.count; i++)
+        {
+            squares += (x[i] - mean[j]) * (x[i] - mean[j]);
+        }
+        std[j] = sqrt(squares / dataset.count);
+    }
+}
+
+/**
+ * Normalizes the features in place, as normalize.
+ * @param dataset Dataset
+ * @param mean Feature means
+ * @param std Feature standard deviations
+ */
+inline void normalize(Dataset &dataset, const std::vector<double> &mean, const std::vector<double> &std)
+{
+    for (size_t j = 0; j < dataset.dimensions(); j++)
+    {
+        double *x = dataset.column(j);
+        for (size_t i = 0; i < dataset.count; i++)
+        {
+            x[i] = (x[i] - mean[j]) / std[j];
+        }
+    }
+}
+
+/**
+ * Calculates the model output z = X @ w + b, one feature column at a time.
+ * @param dataset Normalized dataset
+ * @param w Weights
+ * @param b Bias
+ * @param z Model output per row
+ */
+inline void logistic_z(const Dataset &dataset, const std::vector<double> &w, double b, std::vector<double> &z)
+{
+    z.assign(dataset.count, b);
+    double *__restrict__ out = z.data();
+    for (size_t j = 0; j < dataset.dimensions(); j++)
+    {
+        const double *__restrict__ x = dataset.column(j);
+        double w_j = w[j];
+        for (size_t i = 0; i < dataset.count; i++)
+        {
+            out[i] += w_j * x[i];
+        }
+    }
+}
+
+/**
+ * Calculates the share of rows classified correctly, as accuracy(y, classify(p_hat)).
+ * @param dataset Normalized dataset
+ * @param w Weights
+ * @param b Bias
+ * @param fast Whether to use the fast sigmoid of the firmware
+ * @return Accuracy [0, 1]
+ */
+inline double accuracy(const Dataset &dataset, const std::vector<double> &w, double b, bool fast = false)
+{
+    std::vector<double> z;
+    logistic_z(dataset, w, b, z);
+    size_t correct = 0;
+    for (size_t i = 0; i < dataset.count; i++)
+    {
+        double p = fast ? 0.5 * (z[i] / (1.0 + fabs(z[i])) + 1.0) : 1.0 / (1.0 + exp(-z[i]));
+        correct += (p > 0.5) == (dataset.labels[i] == 1);
+    }
+    return (double)correct / dataset.count;
+}
+
+/**
+ * Calculates the binary cross-entropy loss and its gradient at the same weights,
+ * as bce_loss and bce_gradient, in one pass over the rows.
+ * @param dataset Normalized dataset
+ * @param w Weights
+ * @param b Bias
+ * @param z Scratch space of one value per row, holds p_hat - y afterwards
+ * @param dw Gradient of the weights
+ * @param db Gradient of the bias
+ * @return Loss
+ */
+inline double loss_gradient(const Dataset &dataset, const std::vector<double> &w, double b, std::vector<double> &z,
+                            std::vector<double> &dw, double &db)
+{
+    logistic_z(dataset, w, b, z);
+    double *__restrict__ residual = z.data();
+    const double *__restrict__ y = dataset.labels.data();
+    double log_likelihood = 0;
+    double residual_sum = 0;
+    for (size_t i = 0; i < dataset.count; i++)
+    {
+        double p = 1.0 / (1.0 + exp(-residual[i]));
+        log_likelihood += y[i] * log(p + epsilon) + (1 - y[i]) * log(1 - p + epsilon);
+        residual[i] = p - y[i];
+        residual_sum += residual[i];
+    }
+
+    dw.resize(dataset.dimensions());
+    for (size_t j = 0; j < dataset.dimensions(); j++)
+    {
+        const double *__restrict__ x = dataset.column(j);
+        double sum = 0;
+        for (size_t i = 0; i < dataset.count; i++)
+        {
+            sum += x[i] * residual[i];
+        }
+        dw[j] = sum / dataset.count;
+    }
+    db = residual_sum / dataset.count;
+    return -log_likelihood / dataset.count;
+}
+
+/**
+ * Calculates the Newton step of the weights and the bias: the gradient times the
+ * inverse Hessian of the loss, which is X' @ diag(p (1 - p)) @ X' / N with X' = [X 1].
+ * @param dataset Normalized dataset
+ * @param w Weights
+ * @param b Bias
+ * @param dw Gradient of the weights
+ * @param db Gradient of the bias
+ * @param step Step of the weights, followed by the step of the bias
+ * @return Whether the Hessian could be inverted
+ */
+inline bool newton_step(const Dataset &dataset, const std::vector<double> &w, double b,
+                        const std::vector<double> &dw, double db, std::vector<double> &step)
+{
+    size_t d = dataset.dimensions();
+    std::vector<double> curvature;
+    logistic_z(dataset, w, b, curvature);
+    for (size_t i = 0; i < dataset.count; i++)
+    {
+        double p = 1.0 / (1.0 + exp(-curvature[i]));
+        curvature[i] = p * (1 - p);
+    }
+
+    // Augmented matrix [H | g], the last row and column belong to the bias
+    std::vector<std::vector<double>> a(d + 1, std::vector<double>(d + 2, 0));
+    for (size_t j = 0; j <= d; j++)
+    {
+        for (size_t k = j; k <= d; k++)
+        {
+            const double *x_j = j < d ? dataset.column(j) : nullptr;
+            const double *x_k = k < d ? dataset.column(k) : nullptr;
+            double sum = 0;
+            for (size_t i = 0; i < dataset.count; i++)
+            {
+                sum += curvature[i] * (x_j ? x_j[i] : 1) * (x_k ? x_k[i] : 1);
+            }
+            a[j][k] = a[k][j] = sum / dataset.count;
+        }
+        a[j][d + 1] = j < d ? dw[j] : db;
+    }
+
+    // Gauss-Jordan elimination with partial pivoting
+    for (size_t column = 0; column <= d; column++)
+    {
+        size_t pivot = column;
+        for (size_t row = column + 1; row <= d; row++)
+        {
+            pivot = fabs(a[row][column]) > fabs(a[pivot][column]) ? row : pivot;
+        }
+        if (fabs(a[pivot][column]) < 1e-300)
+        {
+            return false;
+        }
+        std::swap(a[column], a[pivot]);
+        for (size_t row = 0; row <= d; row++)
+        {
+            if (row == column)
+            {
+                continue;
+            }
+            double factor = a[row][column] / a[column][column];
+            for (size_t k = column; k <= d + 1; k++)
+            {
+                a[row][k] -= factor * a[column][k];
+            }
+        }
+    }
+    step.resize(d + 1);
+    for (size_t j = 0; j <= d; j++)
+    {
+        step[j] = a[j][d + 1] / a[j][j];
+    }
+    return true;
+}
+
+/**
+ * Trains the logistic regression, as train_logistic_regression.
+ * @param dataset Normalized training set
+ * @param options Parameters of the training
+ * @param w Trained weights
+ * @param b Trained bias
+ */
+inline void train_logistic_regression(const Dataset &dataset, const TrainingOptions &options, std::vector<double> &w, double &b)
+{
+    std::mt19937_64 random(options.seed);
+    std::normal_distribution<double> normal(0, 1);
+    w.resize(dataset.dimensions());
+    for (double &w_j : w)
+    {
+        w_j = normal(random);
+    }
+    b = 0;
+
+    std::vector<double> scratch, dw, step;
+    double db;
+    bool has_previous = false;
+    double loss_previous = 0;
+    long no_improvement_count = 0;
+    auto start_time = std::chrono::steady_clock::now();
+    for (long i = 0; options.max_iters == 0 || i < options.max_iters; i++)
+    {
+        double loss = loss_gradient(dataset, w, b, scratch, dw, db);
+        if (options.newton && newton_step(dataset, w, b, dw, db, step))
+        {
+            // Halve the step until it lowers the loss, a full step overshoots far from the optimum
+            std::vector<double> w_next(w.size()), dw_next;
+            double b_next, db_next;
+            for (int halvings = 0; halvings < 30; halvings++)
+            {
+                for (size_t j = 0; j < w.size(); j++)
+                {
+                    w_next[j] = w[j] - step[j];
+                }
+                b_next = b - step[w.size()];
+                if (loss_gradient(dataset, w_next, b_next, scratch, dw_next, db_next) < loss)
+                {
+                    break;
+                }
+                for (double &step_j : step)
+                {
+                    step_j /= 2;
+                }
+            }
+            w = w_next;
+            b = b_next;
+        }
+        else
+        {
+            for (size_t j = 0; j < w.size(); j++)
+            {
+                w[j] -= options.alpha * dw[j];
+            }
+            b -= options.alpha * db;
+        }
+
+        if (options.loss_freq != 0 && i % options.loss_freq == 0)
+        {
+            auto now = std::chrono::steady_clock::now();
+            double elapsed = std::chrono::duration<double>(now - start_time).count();
+            start_time = now;
+            printf("Iteration %ld: loss: %.5f, acc: %.5f%%, speed:%.2f it/sec\n", i, loss,
+                   100 * accuracy(dataset, w, b), i > 0 ? options.loss_freq / elapsed : 0.0);
+        }
+
+        if (has_previous)
+        {
+            if (loss_previous - loss > options.min_delta)
+            {
+                no_improvement_count = 0;
+            }
+            else if (++no_improvement_count >= options.patience)
+            {
+                break;
+            }
+        }
+        loss_previous = loss;
+        has_previous = true;
+    }
+    if (options.loss_freq != 0)
+    {
+        printf("\nFinal loss: %.5f\n", loss_previous);
+    }
+}
+
+#endif
@@ -6,6 +6,7 @@ import seaborn as sns
 import matplotlib.pyplot as plt
 
 from implementation import *
+import json
 
 import argparse
 
@@ -20,6 +21,8 @@ parser.add_argument('-a','--alpha', default=0.5, type=float)
 parser.add_argument('-f','--loss_freq', default=50_000, type=int)
 parser.add_argument('-p','--patience', default=float("Inf"), type=float)
 parser.add_argument('-d','--min_delta', default=0.00001, type=float)
+parser.add_argument('-m','--model', help='where to save the model for export.py')
+parser.add_argument('-s','--seed', type=int, help='seed of the train/test split, random if not given')
 
 args = parser.parse_args()
 
@@ -32,8 +35,10 @@ colors_df = pd.read_csv(args.dataset)
 
 # colors_df=colors_df.drop(columns=["ambient"])
 
-# split into train and test dataset
-X_train, y_train, X_test, y_test, feature_names, label_map = preprocess_data(colors_df, label="label", train_size=args.train_size)
+# split into train and test dataset, seeded so the test rows can be saved for export.py
+seed = args.seed if args.seed is not None else int(np.random.randint(2**31))
+X_train, y_train, X_test, y_test, feature_names, label_map = preprocess_data(colors_df, label="label", train_size=args.train_size, seed=seed)
+test_rows = sorted(int(i) for i in colors_df.sample(frac=1, random_state=seed).index[int(len(colors_df) * args.train_size):])
 
 # Normalize data
 mean = X_train.mean(axis=0)
@@ -90,22 +95,17 @@ print("------------------")
 # print("------------------")
 
 
-def print_cpp_definitions(params, name_prefix="logistic_regression"):
-    import numpy as np
-
-    # Helper function to format numpy arrays into C++ initializer lists
-    def format_array(arr):
-        return ", ".join(f"{x:.8f}" for x in arr)
-
-    w = params["w"]
-    b = params["b"]
-    mean = params["mean"]
-    std = params["std"]
-
-    print(f"const double {name_prefix}_w[{len(w)}] = {{{format_array(w)}}};")
-    print(f"const double {name_prefix}_b = {float(b):.16f};")
-    print(f"const double {name_prefix}_mean[{len(mean)}] = {{{format_array(mean)}}};")
-    print(f"const double {name_prefix}_std[{len(std)}] = {{{format_array(std)}}};")
-
-
-print_cpp_definitions({"w":w, "b": b, "mean": mean, "std": std}, name_prefix="ColorSensor::logistic_regression")
\ No newline at end of file
+# save the model for export.py, which writes it into the firmware
+if args.model:
+    with open(args.model, "w") as f:
+        json.dump({
+            "dataset": args.dataset,
+            "w": [float(x) for x in w],
+            "b": float(b),
+            "mean": [float(x) for x in mean],
+            "std": [float(x) for x in std],
+            "test_rows": test_rows,
+        }, f, indent=4)
+    print(f"saved model to {args.model}")
+else:
+    print("not saved - pass --model model.json and run export.py to write it into RipenessModelData.h")
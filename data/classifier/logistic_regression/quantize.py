@@ -0,0 +1,151 @@
+"""Fixed-point version of the logistic regression model for the firmware.
+
+Folds the z-score normalization into the weights and bias, so the model can be
+evaluated on the raw ADC sums of a measurement with int16 weights and an int32
+accumulator (see RipenessModels::LogisticRegression). This module is also the
+reference of the integer inference: `--check` compares the output of the
+firmware (arduino/benchmark/ripeness.sh) bit by bit with it. export.py writes
+the fixed-point model into the firmware.
+
+Only uses the standard library, so the check runs without the training environment.
+"""
+
+import argparse
+import csv
+import json
+import os
+import sys
+from typing import Dict, List, Sequence, Tuple
+
+# Model written by main.py and exported to the firmware by export.py
+MODEL_PATH = os.path.join(os.path.dirname(os.path.abspath(__file__)), "model.json")
+
+SAMPLE_COUNT = 10  # ColorSensor::measure_count, samples summed per channel
+Z_SHIFT = 20       # Fraction bits of the weights, bias and model output
+P_SHIFT = 15       # Fraction bits of the probability
+SIGMOID_SHIFT = 12 # Fraction bits of the model output in the sigmoid division
+
+
+def quantize(w: Sequence[float], b: float, mean: Sequence[float], std: Sequence[float],
+             sample_count: int = SAMPLE_COUNT, weight_bits: int = 16) -> Tuple[List[int], int]:
+    """Folds the normalization into the model and converts it to fixed point.
+
+    The inputs are the sums of `sample_count` samples of the four channels and
+    the width times `sample_count`, so all five weights have a similar magnitude.
+
+    Args:
+        w: Weights of the normalized features of shape (5, )
+        b: Bias
+        mean: Feature means of shape (5, )
+        std: Feature standard deviations of shape (5, )
+        sample_count: Samples per channel sum
+        weight_bits: Size of the weights in the firmware
+
+    Returns:
+        q_w: Weights per input [2^-Z_SHIFT], int16 by default
+        q_b: Bias [2^-Z_SHIFT], int32
+    """
+    folded_w = [w[i] / std[i] / sample_count for i in range(len(w))]
+    folded_b = b - sum(w[i] * mean[i] / std[i] for i in range(len(w)))
+
+    q_w = [round(x * (1 << Z_SHIFT)) for x in folded_w]
+    q_b = round(folded_b * (1 << Z_SHIFT))
+    if any(not -(1 << (weight_bits - 1)) <= x < (1 << (weight_bits - 1)) for x in q_w):
+        raise ValueError(f"weights {q_w} do not fit int{weight_bits}, reduce Z_SHIFT")
+    if not -(1 << 31) <= q_b < (1 << 31):
+        raise ValueError(f"bias {q_b} does not fit int32, reduce Z_SHIFT")
+    return q_w, q_b
+
+
+def infer_z(q_w: Sequence[int], q_b: int, channel_sums: Sequence[int], width: int,
+            sample_count: int = SAMPLE_COUNT) -> int:
+    """Model output as computed by RipenessModels::LogisticRegression::get_z_q.
+
+    Args:
+        q_w: Weights [2^-Z_SHIFT]
+        q_b: Bias [2^-Z_SHIFT]
+        channel_sums: ADC sums of red, green, blue and ambient
+        width: Width of the raspberry [mm]
+
+    Returns:
+        int: Model output z, positive for unripe [2^-Z_SHIFT]
+    """
+    inputs = list(channel_sums) + [width * sample_count]
+    return q_b + sum(q_w[i] * inputs[i] for i in range(len(inputs)))
+
+
+def infer_p(z: int) -> int:
+    """Ripeness probability as computed by RipenessModels::LogisticRegression::get_p_ripe_q.
+
+    Same soft sigmoid as fast_sigmoid in implementation.py, evaluated with one
+    unsigned 32 bit division.
+
+    Args:
+        z: Model output [2^-Z_SHIFT]
+
+    Returns:
+        int: Probability that the raspberry is ripe [2^-P_SHIFT]
+    """
+    z = z >> (Z_SHIFT - SIGMOID_SHIFT)
+    half_tail = (1 << (SIGMOID_SHIFT + P_SHIFT - 1)) // ((1 << SIGMOID_SHIFT) + abs(z))
+    return half_tail if z >= 0 else (1 << P_SHIFT) - half_tail
+
+
+def read_dataset(path: str, sample_count: int = SAMPLE_COUNT) -> List[Dict]:
+    """Reads a labeled dataset and converts the channel averages back into ADC sums.
+
+    Returns:
+        List of rows with the keys sums, width and label
+    """
+    rows = []
+    with open(path) as f:
+        for row in csv.DictReader(f):
+            sums = [round(float(row[k]) * sample_count) for k in ("red", "green", "blue", "ambient")]
+            rows.append({"sums": sums, "width": int(row["width"]), "label": row["label"]})
+    return rows
+
+
+def check(rows: List[Dict], q_w: Sequence[int], q_b: int, lines: List[str]) -> int:
+    """Compares the firmware output with the reference.
+
+    Args:
+        rows: Dataset rows
+        lines: One line `z p` per row as printed by arduino/benchmark/ripeness
+
+    Returns:
+        int: Number of rows that differ
+    """
+    mismatches = 0
+    if len(lines) != len(rows):
+        print(f"expected {len(rows)} results, got {len(lines)}")
+        return max(len(rows), len(lines))
+    for i, (row, line) in enumerate(zip(rows, lines)):
+        z, p = (int(x) for x in line.split()[:2])
+        z_ref = infer_z(q_w, q_b, row["sums"], row["width"])
+        p_ref = infer_p(z_ref)
+        if (z, p) != (z_ref, p_ref):
+            if mismatches < 10:
+                print(f"row {i + 2}: firmware z={z} p={p}, reference z={z_ref} p={p_ref}")
+            mismatches += 1
+    return mismatches
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        prog="quantize",
+        description="Checks the fixed-point ripeness model of the firmware against the reference")
+    parser.add_argument("dataset")
+    parser.add_argument("-c", "--check", required=True, help="firmware output to compare, - for stdin")
+    parser.add_argument("-m", "--model", default=MODEL_PATH, help="model written by main.py")
+    args = parser.parse_args()
+
+    with open(args.model) as f:
+        model = json.load(f)
+    q_w, q_b = quantize(model["w"], model["b"], model["mean"], model["std"])
+    rows = read_dataset(args.dataset)
+
+    source = sys.stdin if args.check == "-" else open(args.check)
+    lines = [line for line in source.read().splitlines() if line.strip()]
+    mismatches = check(rows, q_w, q_b, lines)
+    print(f"bit-exact on {len(rows) - mismatches} of {len(rows)} rows")
+    sys.exit(1 if mismatches else 0)
@@ -0,0 +1,183 @@
+/**
+ * train.cpp
+ *
+ * Native trainer of the logistic regression, a drop-in for main.py.
+ * Takes the same arguments, runs the same batch gradient descent with the same
+ * early stopping (--patience, --min_delta) and saves the same model (w, b, mean, std)
+ * with --model for export.py, in seconds instead of minutes. Build and run with train.sh.
+ * With --newton, damped Newton steps replace the gradient steps, see logistic_regression.h.
+ *
+ * Unlike main.py, the split and the initial weights are always seeded (--seed, 0 by
+ * default), so a retrain is reproducible.
+ */
+
+#include "logistic_regression.h"
+
+#include <cstring>
+
+/**
+ * Options structure - command line arguments, with the defaults of main.py.
+ */
+struct Options
+{
+    const char *dataset = nullptr;
+    double train_size = 0.70;
+    const char *model = nullptr;
+    TrainingOptions training;
+};
+
+/**
+ * Saves the model for export.py, in the format of main.py.
+ * The test rows let export.py evaluate every model on the rows the logistic regression was not trained on.
+ * @return Whether the file could be written
+ */
+static bool save_model(const char *path, const char *dataset, const std::vector<double> &w, double b,
+                       const std::vector<double> &mean, const std::vector<double> &std,
+                       const std::vector<size_t> &test_rows)
+{
+    FILE *file = fopen(path, "w");
+    if (file == NULL)
+    {
+        perror(path);
+        return false;
+    }
+    fprintf(file, "{\n    \"dataset\": \"%s\",\n", dataset);
+    const std::vector<double> *arrays[3] = {&w, &mean, &std};
+    const char *names[3] = {"w", "mean", "std"};
+    for (int k = 0; k < 3; k++)
+    {
+        fprintf(file, "    \"%s\": [", names[k]);
+        for (size_t j = 0; j < arrays[k]->size(); j++)
+        {
+            fprintf(file, j ? ", %.17g" : "%.17g", (*arrays[k])[j]);
+        }
+        fprintf(file, "],\n");
+        if (k == 0)
+        {
+            fprintf(file, "    \"b\": %.17g,\n", b);
+        }
+    }
+    fprintf(file, "    \"test_rows\": [");
+    for (size_t i = 0; i < test_rows.size(); i++)
+    {
+        fprintf(file, i ? ", %zu" : "%zu", test_rows[i]);
+    }
+    fprintf(file, "]\n}\n");
+    fclose(file);
+    return true;
+}
+
+/**
+ * Reads the command line arguments of main.py, plus --seed and --newton.
+ * @return Whether the arguments are valid
+ */
+static bool parse_options(int argc, char **argv, Options &options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        bool has_value = i + 1 < argc;
+        auto is = [arg](const char *short_name, const char *long_name)
+        { return strcmp(arg, short_name) == 0 || strcmp(arg, long_name) == 0; };
+
+        if (is("-n", "--newton"))
+        {
+            options.training.newton = true;
+        }
+        else if (arg[0] != '-' && options.dataset == nullptr)
+        {
+            options.dataset = arg;
+        }
+        else if (!has_value)
+        {
+            return false;
+        }
+        else if (is("-i", "--max_iters"))
+        {
+            options.training.max_iters = atol(argv[++i]);
+        }
+        else if (is("-t", "--train_size"))
+        {
+            options.train_size = atof(argv[++i]);
+        }
+        else if (is("-a", "--alpha"))
+        {
+            options.training.alpha = atof(argv[++i]);
+        }
+        else if (is("-f", "--loss_freq"))
+        {
+            options.training.loss_freq = atol(argv[++i]);
+        }
+        else if (is("-p", "--patience"))
+        {
+            options.training.patience = atof(argv[++i]);
+        }
+        else if (is("-d", "--min_delta"))
+        {
+            options.training.min_delta = atof(argv[++i]);
+        }
+        else if (is("-m", "--model"))
+        {
+            options.model = argv[++i];
+        }
+        else if (is("-s", "--seed"))
+        {
+            options.training.seed = strtoul(argv[++i], nullptr, 10);
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return options.dataset != nullptr;
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parse_options(argc, argv, options))
+    {
+        fprintf(stderr, "usage: %s dataset [-i max_iters] [-t train_size] [-a alpha] [-f loss_freq] [-p patience]\n"
+                        "       [-d min_delta] [-m model] [-s seed] [-n|--newton]\n",
+                argv[0]);
+        return 2;
+    }
+
+    Dataset dataset, train_set, test_set;
+    std::vector<size_t> test_rows;
+    if (!read_dataset(options.dataset, dataset))
+    {
+        return 1;
+    }
+    split(dataset, options.train_size, options.training.seed, train_set, test_set, &test_rows);
+
+    std::vector<double> mean, std;
+    standardization(train_set, mean, std);
+    normalize(train_set, mean, std);
+    normalize(test_set, mean, std);
+
+    std::vector<double> w;
+    double b;
+    auto start = std::chrono::steady_clock::now();
+    train_logistic_regression(train_set, options.training, w, b);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("------------------\n");
+    printf("Training accuracy: %.2f%%\n", 100 * accuracy(train_set, w, b));
+    printf("Testing accuracy: %.2f%%\n", 100 * accuracy(test_set, w, b));
+    printf("Testing accuracy with fast_sigmoid: %.2f%%\n", 100 * accuracy(test_set, w, b, true));
+    printf("Trained in %.2f s\n", seconds);
+    printf("------------------\n");
+
+    if (options.model == nullptr)
+    {
+        printf("not saved - pass --model model.json and run export.py to write it into RipenessModelData.h\n");
+        return 0;
+    }
+    if (!save_model(options.model, options.dataset, w, b, mean, std, test_rows))
+    {
+        return 1;
+    }
+    printf("saved model to %s\n", options.model);
+    return 0;
+}
@@ -0,0 +1,2 @@
+dir=$(dirname "$0")
+g++ -O3 -march=native -ffast-math -std=c++17 "$dir/train.cpp" -o "$dir/train" && "$dir/train" "$@"
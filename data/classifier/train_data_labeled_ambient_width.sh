@@ -1 +1 @@
-python logistic_regression/main.py data_labeled_ambient_width.csv --patience 1000 --min_delta 0.00001 --max_iters 500000 --loss_freq 250
\ No newline at end of file
+sh logistic_regression/train.sh data_labeled_ambient_width.csv --patience 1000 --min_delta 0.00001 --max_iters 500000 --loss_freq 250 --model logistic_regression/model.json && python export.py data_labeled_ambient_width.csv
\ No newline at end of file
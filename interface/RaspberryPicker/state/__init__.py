@@ -4,6 +4,9 @@ from collections import defaultdict
 from matplotlib.figure import Figure
 from matplotlib.backends.backend_tkagg import (FigureCanvasTkAgg, NavigationToolbar2Tk)
 import numpy
+import time
+
+from .protocol import FrameReader, LOG_KEY
 
 class KeyDefaultDict(defaultdict):
     #default_factory: Callable[[str], _VT] | None
@@ -31,20 +34,36 @@ class State:
     baudrate = 9600
     arduino = None
     fig=None
+    # protocol requested from the firmware at connect time ("TEXT" or "BINARY")
+    requested_protocol = "BINARY"
+    negotiation_interval = 1.0
 
     def __init__(self, control_center):
         self.control_center = control_center
         self.values = KeyDefaultDict(lambda key: ValueVar(self, self.control_center, value="", name=key))
         self.color_sensor_values = {"r":[], "g":[], "b":[], "noise":[]}
+        self.protocol = "TEXT"
+        self.frame_reader = FrameReader()
+        self.last_negotiation = 0.0
 
         pass
 
     def set_port(self, new_comport: None | str)->None:
         self.port = new_comport
+        self.protocol = "TEXT"
+        self.frame_reader = FrameReader()
         try:
             self.arduino = serial.Serial(self.port, self.baudrate)
         except:
             self.arduino = None
+        self.negotiate_protocol()
+
+    def negotiate_protocol(self)->None:
+        """requests the preferred protocol, the firmware acknowledges with interface.protocol=<protocol> as text"""
+        if self.requested_protocol == self.protocol:
+            return
+        self.last_negotiation = time.monotonic()
+        self.send("interface.protocol", self.requested_protocol)
 
     def get_port(self)->str:
         return self.port if not (self.port is None) else ""
@@ -63,23 +82,54 @@ class State:
 
         while (self.arduino.in_waiting>0):
             try:
+                if self.protocol == "BINARY":
+                    self.listen_frames()
+                    continue
                 line = self.arduino.readline().decode('utf-8').strip()
-                print(f"> {line}")
-                self.control_center.logs.configure(state="normal")
-                self.control_center.logs.insert("end", f"\n{line}")
-                self.control_center.logs.configure(state="disabled")
-                self.control_center.logs.see("end")
                 if "=" in line:
                     key, value = line.split("=",1)
-                    self.values[key]._set(value)
-
-                    # gripper.ripeness.[r,g,b]
-                    if key.startswith("gripper.ripeness."):
-                        self.color_sensor_values[key.split(".")[-1]].append(float(value))
+                    self.handle_value(key, value)
+                else:
+                    self.log(line)
+                    # the firmware may still be booting when the port is opened - ask again
+                    if self.protocol != self.requested_protocol and time.monotonic() - self.last_negotiation > self.negotiation_interval:
+                        self.negotiate_protocol()
             except:
                 pass
         return True
 
+    def listen_frames(self)->None:
+        for key, value in self.frame_reader.feed(self.arduino.read(self.arduino.in_waiting)):
+            if key == LOG_KEY:
+                self.log(value)
+            else:
+                self.handle_value(key, value)
+        if self.frame_reader.overflowed():
+            # no frame delimiters - the firmware was reset and talks text again
+            self.log(f"! lost binary protocol after {self.frame_reader.corrupt_frames} corrupt frames")
+            self.protocol = "TEXT"
+            self.frame_reader = FrameReader()
+            self.negotiate_protocol()
+
+    def handle_value(self, key: str, value: str)->None:
+        self.log(f"{key}={value}")
+        if key == "interface.protocol":
+            self.protocol = value
+            if value == "BINARY":
+                self.frame_reader = FrameReader()
+        self.values[key]._set(value)
+
+        # gripper.ripeness.[r,g,b,noise]
+        if key.startswith("gripper.ripeness.") and key.split(".")[-1] in self.color_sensor_values and key.count(".") == 2:
+            self.color_sensor_values[key.split(".")[-1]].append(float(value))
+
+    def log(self, line: str)->None:
+        print(f"> {line}")
+        self.control_center.logs.configure(state="normal")
+        self.control_center.logs.insert("end", f"\n{line}")
+        self.control_center.logs.configure(state="disabled")
+        self.control_center.logs.see("end")
+
     def send(self, key, value)->bool:
         print(f"< {key}={value}")
         if self.arduino is None:
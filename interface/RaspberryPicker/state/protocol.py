@@ -0,0 +1,172 @@
+"""
+Decoder for the binary protocol of the firmware (arduino/lib/RaspberryPicker/src/Interface).
+
+Frames are COBS-encoded and terminated by a 0x00 byte. Decoded, a frame is
+- a header byte: value type (upper 2 bits) and key ID (lower 6 bits)
+- the value: int16, int32 (the int16 type with 4 bytes) or float (little endian), enum index byte, or string bytes
+- a CRC-8 (polynomial 0x07) over header and value
+
+KEYS must match RASPBERRY_PICKER_TELEMETRY_KEYS in TelemetryKeys.h, the enum value names
+the value lists of the enums (e.g. RASPBERRY_PICKER_DOOR_STATES in Door.h).
+"""
+import struct
+
+TYPE_INT16 = 0
+TYPE_FLOAT = 1
+TYPE_ENUM = 2
+TYPE_STRING = 3
+TYPE_INT32 = TYPE_INT16  # shares the type bits of int16, told apart by its 4 value bytes
+
+LOG_KEY = "log"
+
+# maximum length of an encoded frame (header, 48 characters, crc, cobs overhead)
+MAX_FRAME_LENGTH = 52
+
+PROGRAMS = ["CLOSE_GRIPPER", "RELEASE_GRIPPER", "EMPTY_BASKET", "RESET", "MEASURE_COLOR", "PROGRAM_1", "PROGRAM_2"]
+CONTROLLER_STATES = ["MANUAL", "IDLE", "PROGRAM"]
+PROTOCOLS = ["TEXT", "BINARY"]
+DOOR_STATES = ["OPEN", "CLOSED"]
+SORTING_STATES = ["LARGE", "SMALL", "IDLE"]
+GRIPPER_STATES = ["OPEN", "CLOSED_SMALL", "CLOSED_LARGE", "CLOSED_LIMIT"]
+RASPBERRY_SIZES = ["LARGE", "SMALL", "UNKNOWN"]
+RIPENESS = ["RIPE", "UNRIPE"]
+CONFIG_STATUSES = ["LOADED", "DEFAULTS", "SAVED", "CHANGED", "REJECTED"]
+JOURNAL_STATUSES = ["COLD", "WARM", "DIRTY"]
+HOMING_STATUSES = ["OK", "NO_SWITCH", "STUCK", "BLOCKED"]
+PROFILE_PHASES = ["CLOSE_LARGE", "CLOSE_SMALL", "CLOSE_LIMIT", "SENSE_COLOR", "SORT", "WAIT_FOR_PICK", "REOPEN", "DOOR_DWELL"]
+
+# (key, enum value names or None), the position is the key id
+KEYS = [
+    (LOG_KEY, None),
+    ("controller.program", PROGRAMS),
+    ("controller.state", CONTROLLER_STATES),
+    ("interface.protocol", PROTOCOLS),
+    ("basket.door.state", DOOR_STATES),
+    ("basket.door.position", None),
+    ("basket.sorting.state", SORTING_STATES),
+    ("basket.sorting.position", None),
+    ("basket.fill_count.small", None),
+    ("basket.fill_count.large", None),
+    ("gripper.gripper_state", GRIPPER_STATES),
+    ("gripper.plate_distance", None),
+    ("gripper.raspberry_size", RASPBERRY_SIZES),
+    ("gripper.raspberry_ripeness", RIPENESS),
+    ("gripper.raspberry_ripeness.p_ripe", None),
+    ("gripper.raspberry_ripeness.p_unripe", None),
+    ("gripper.ripeness.r", None),
+    ("gripper.ripeness.g", None),
+    ("gripper.ripeness.b", None),
+    ("gripper.ripeness.noise", None),
+    ("gripper.ripeness.samples", None),
+    ("gripper.ripeness.settle_ms.r", None),
+    ("gripper.ripeness.settle_ms.g", None),
+    ("gripper.ripeness.settle_ms.b", None),
+    ("gripper.ripeness.settle_ms.noise", None),
+    ("gripper.motion.latency_ms", None),
+    ("gripper.motion.duration_ms", None),
+    ("interface.telemetry.dropped", None),
+    ("diag.memory.free", None),
+    ("diag.memory.stack_headroom", None),
+    ("diag.memory.controller", None),
+    ("diag.memory.interface", None),
+    ("diag.memory.basket", None),
+    ("diag.memory.gripper", None),
+    # config.key names the configuration value (e.g. config.basket.door.open_pos) sent next as config.value
+    ("config.status", CONFIG_STATUSES),
+    ("config.key", None),
+    ("config.value", None),
+    ("journal.status", JOURNAL_STATUSES),
+    ("gripper.homing.status", HOMING_STATUSES),
+    ("gripper.homing.drift_steps", None),
+    # only sent by firmware built with RASPBERRY_PICKER_PROFILE
+    ("diag.profile.phase", PROFILE_PHASES),
+    ("diag.profile.count", None),
+    ("diag.profile.min_us", None),
+    ("diag.profile.mean_us", None),
+    ("diag.profile.max_us", None),
+] + [(f"diag.profile.histogram.{i}", None) for i in range(8)]
+
+
+class FrameError(Exception):
+    pass
+
+
+def crc8(data: bytes) -> int:
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def cobs_decode(data: bytes) -> bytes:
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            raise FrameError("invalid cobs code")
+        out += data[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def decode_frame(data: bytes) -> tuple[str, str]:
+    """decodes one frame (without the 0x00 delimiter) into key and value as the text protocol would send them"""
+    frame = cobs_decode(data)
+    if len(frame) < 2:
+        raise FrameError("frame too short")
+    if crc8(frame[:-1]) != frame[-1]:
+        raise FrameError("crc mismatch")
+
+    value_type = frame[0] >> 6
+    key_id = frame[0] & 0x3F
+    value = frame[1:-1]
+    if key_id >= len(KEYS):
+        raise FrameError(f"unknown key id {key_id}")
+    key, enum_names = KEYS[key_id]
+
+    if value_type == TYPE_INT16 and len(value) == 2:
+        return key, str(struct.unpack("<h", value)[0])
+    if value_type == TYPE_INT32 and len(value) == 4:
+        return key, str(struct.unpack("<i", value)[0])
+    if value_type == TYPE_FLOAT and len(value) == 4:
+        return key, f"{struct.unpack('<f', value)[0]:.2f}"
+    if value_type == TYPE_ENUM and len(value) == 1 and enum_names is not None and value[0] < len(enum_names):
+        return key, enum_names[value[0]]
+    if value_type == TYPE_STRING:
+        return key, value.decode("utf-8", errors="replace")
+    raise FrameError(f"invalid value for {key}")
+
+
+class FrameReader:
+    """splits a byte stream into frames and decodes them"""
+
+    def __init__(self):
+        self.buffer = bytearray()
+        self.corrupt_frames = 0
+
+    def feed(self, data: bytes) -> list[tuple[str, str]]:
+        """adds received bytes and returns the decoded (key, value) pairs of all complete frames"""
+        self.buffer += data
+        values = []
+        while True:
+            end = self.buffer.find(b"\x00")
+            if end < 0:
+                break
+            frame = bytes(self.buffer[:end])
+            del self.buffer[:end + 1]
+            if len(frame) == 0:
+                continue
+            try:
+                values.append(decode_frame(frame))
+            except FrameError:
+                self.corrupt_frames += 1
+        return values
+
+    def overflowed(self) -> bool:
+        """whether the buffer holds more than a frame without delimiter, i.e. the firmware is not sending frames"""
+        return len(self.buffer) > MAX_FRAME_LENGTH